@@ -0,0 +1,35 @@
+#ifndef _JEEVES_BENCH_H_
+#define _JEEVES_BENCH_H_
+
+#include <stdio.h>
+
+#include <time.h>
+
+#define BENCH_ITERATIONS				1000000
+
+// keeps the compiler from removing the measured work
+static volatile size_t bench_sink = 0;
+
+static inline double bench_now (void) {
+
+	struct timespec now = { 0 };
+	(void) clock_gettime (CLOCK_MONOTONIC, &now);
+
+	return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+
+}
+
+// prints the mean time of a single iteration
+static inline void bench_print (
+	const char *name,
+	const double start, const double end, const size_t iterations
+) {
+
+	(void) printf (
+		"%-40s %10.1f ns/op\n",
+		name, ((end - start) / (double) iterations) * 1e9
+	);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cerver/types/string.h>
+
+#include <cerver/http/json/json.h>
+
+#include "body.h"
+
+#include "bench.h"
+
+#define BENCH_VALUE_SIZE				128
+
+typedef struct BenchRegister {
+
+	char name[BENCH_VALUE_SIZE];
+	char username[BENCH_VALUE_SIZE];
+	char email[BENCH_VALUE_SIZE];
+	char password[BENCH_VALUE_SIZE];
+	char confirm[BENCH_VALUE_SIZE];
+
+} BenchRegister;
+
+typedef struct BenchJob {
+
+	char name[BENCH_VALUE_SIZE];
+	char description[BENCH_VALUE_SIZE];
+	bool autostart;
+
+} BenchJob;
+
+// the same fields as POST /api/users/register
+static const JeevesBodyField register_fields[] = {
+	JEEVES_BODY_STRING ("name", BenchRegister, name),
+	JEEVES_BODY_STRING ("username", BenchRegister, username),
+	JEEVES_BODY_STRING ("email", BenchRegister, email),
+	JEEVES_BODY_STRING ("password", BenchRegister, password),
+	JEEVES_BODY_STRING ("confirm", BenchRegister, confirm)
+};
+
+// the same fields as POST /api/jeeves/jobs
+static const JeevesBodyField job_fields[] = {
+	JEEVES_BODY_STRING ("name", BenchJob, name),
+	JEEVES_BODY_STRING ("description", BenchJob, description),
+	JEEVES_BODY_BOOL ("autoStart", BenchJob, autostart)
+};
+
+static const char *register_body =
+	"{\"name\": \"Erick Salas\", \"username\": \"erick\", "
+	"\"email\": \"erick.salas@ermiry.com\", "
+	"\"password\": \"super-secret-password\", "
+	"\"confirm\": \"super-secret-password\"}";
+
+static const char *job_body =
+	"{\"name\": \"Grayscale\", "
+	"\"description\": \"Converts every image to gray \\u00e9 \\\"quoted\\\"\", "
+	"\"autoStart\": true}";
+
+// copies the string values of the fields like the jansson path used to
+static void bench_json_copy (
+	json_t *json_body,
+	const JeevesBodyField *fields, const unsigned int n_fields,
+	void *target
+) {
+
+	const char *key = NULL;
+	json_t *value = NULL;
+	json_object_foreach (json_body, key, value) {
+		for (unsigned int idx = 0; idx < n_fields; idx++) {
+			if (!strcmp (key, fields[idx].key)) {
+				char *dest = (char *) target + fields[idx].offset;
+				if (fields[idx].type == JEEVES_BODY_TYPE_STRING) {
+					const char *string = json_string_value (value);
+					if (string) (void) strncpy (dest, string, fields[idx].size - 1);
+				}
+
+				else {
+					*((bool *) dest) = json_is_true (value);
+				}
+
+				break;
+			}
+		}
+	}
+
+}
+
+// runs both parsers over the body & prints their times
+static unsigned int bench_body (
+	const char *name, const char *json,
+	const JeevesBodyField *fields, const unsigned int n_fields,
+	void *target, const size_t target_size
+) {
+
+	String body = { 0 };
+	body.str = (char *) json;
+	body.len = (unsigned int) strlen (json);
+
+	uint32_t found = 0;
+	char label[128] = { 0 };
+
+	double start = bench_now ();
+	for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+		(void) memset (target, 0, target_size);
+		if (jeeves_body_parse (&body, fields, n_fields, target, &found)) {
+			(void) fprintf (stderr, "Failed to parse %s body!\n", name);
+			return 1;
+		}
+
+		bench_sink += found;
+	}
+
+	(void) snprintf (label, sizeof (label), "%s jeeves_body_parse ()", name);
+	bench_print (label, start, bench_now (), BENCH_ITERATIONS);
+
+	json_error_t json_error = { 0 };
+
+	start = bench_now ();
+	for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+		(void) memset (target, 0, target_size);
+		json_t *json_body = json_loads (json, 0, &json_error);
+		if (!json_body) {
+			(void) fprintf (stderr, "Failed to load %s body!\n", name);
+			return 1;
+		}
+
+		bench_json_copy (json_body, fields, n_fields, target);
+		json_decref (json_body);
+
+		bench_sink += ((const char *) target)[0];
+	}
+
+	(void) snprintf (label, sizeof (label), "%s json_loads ()", name);
+	bench_print (label, start, bench_now (), BENCH_ITERATIONS);
+
+	return 0;
+
+}
+
+// compares the schema parser with the jansson tree it replaced
+// using the same payloads & copying the same values
+int main (void) {
+
+	unsigned int errors = 0;
+
+	BenchRegister values = { 0 };
+	errors |= bench_body (
+		"register", register_body,
+		register_fields, sizeof (register_fields) / sizeof (register_fields[0]),
+		&values, sizeof (BenchRegister)
+	);
+
+	BenchJob job = { 0 };
+	errors |= bench_body (
+		"job", job_body,
+		job_fields, sizeof (job_fields) / sizeof (job_fields[0]),
+		&job, sizeof (BenchJob)
+	);
+
+	return (int) errors;
+
+}
\ No newline at end of file
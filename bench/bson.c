@@ -0,0 +1,236 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <bson/bson.h>
+
+#include "allocs.h"
+
+#include "models/job.h"
+
+#include "bench.h"
+
+#define BENCH_BSON_ITERATIONS			(BENCH_ITERATIONS / 10)
+
+#define BENCH_BSON_IMAGES				32
+
+static JobImage images[BENCH_BSON_IMAGES] = { 0 };
+
+static void bench_image_append (bson_t *doc, const JobImage *job_image) {
+
+	(void) bson_append_int32 (doc, "_id", -1, job_image->id);
+	(void) bson_append_utf8 (doc, "saved", -1, job_image->saved, -1);
+	(void) bson_append_utf8 (doc, "original", -1, job_image->original, -1);
+	(void) bson_append_utf8 (doc, "result", -1, job_image->result, -1);
+	(void) bson_append_utf8 (doc, "hash", -1, job_image->hash, -1);
+	(void) bson_append_int32 (doc, "format", -1, job_image->format);
+	(void) bson_append_int32 (doc, "width", -1, job_image->width);
+	(void) bson_append_int32 (doc, "height", -1, job_image->height);
+	(void) bson_append_int32 (doc, "channels", -1, job_image->channels);
+
+}
+
+#pragma region heap
+
+// the job model builders before they used stack documents
+
+static void bench_heap_status (const bson_oid_t *oid) {
+
+	bson_t *query = bson_new ();
+	(void) bson_append_oid (query, "_id", -1, oid);
+
+	bson_t *update = bson_new ();
+	bson_t set_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (update, "$set", -1, &set_doc);
+	(void) bson_append_int32 (&set_doc, "status", -1, JOB_STATUS_RUNNING);
+	(void) bson_append_date_time (&set_doc, "started", -1, (int64_t) time (NULL) * 1000);
+	(void) bson_append_document_end (update, &set_doc);
+
+	bench_sink += query->len + update->len;
+
+	bson_destroy (query);
+	bson_destroy (update);
+
+}
+
+static void bench_heap_images (const bson_oid_t *oid) {
+
+	bson_t *query = bson_new ();
+	(void) bson_append_oid (query, "_id", -1, oid);
+
+	bson_t *update = bson_new ();
+
+	bson_t *inc_doc = bson_new ();
+	(void) bson_append_int32 (inc_doc, "imagesCount", -1, BENCH_BSON_IMAGES);
+	(void) bson_append_document (update, "$inc", -1, inc_doc);
+	bson_destroy (inc_doc);
+
+	bson_t *push_doc = bson_new ();
+	bson_t *images_doc = bson_new ();
+	bson_t *each_array = bson_new ();
+	(void) bson_append_array_begin (images_doc, "$each", -1, each_array);
+
+	char buf[16] = { 0 };
+	const char *key = NULL;
+	size_t keylen = 0;
+	for (unsigned int i = 0; i < BENCH_BSON_IMAGES; i++) {
+		keylen = bson_uint32_to_string (i, &key, buf, sizeof (buf));
+
+		bson_t *job_image_bson = bson_new ();
+		bench_image_append (job_image_bson, &images[i]);
+		(void) bson_append_document (each_array, key, (int) keylen, job_image_bson);
+		bson_destroy (job_image_bson);
+	}
+
+	(void) bson_append_array_end (images_doc, each_array);
+	bson_destroy (each_array);
+
+	(void) bson_append_document (push_doc, "images", -1, images_doc);
+	bson_destroy (images_doc);
+
+	(void) bson_append_document (update, "$push", -1, push_doc);
+	bson_destroy (push_doc);
+
+	bench_sink += query->len + update->len;
+
+	bson_destroy (query);
+	bson_destroy (update);
+
+}
+
+#pragma endregion
+
+#pragma region stack
+
+// the job model builders as they are now
+
+static void bench_stack_status (const bson_oid_t *oid) {
+
+	bson_t query;
+	bson_init (&query);
+	(void) bson_append_oid (&query, "_id", -1, oid);
+
+	bson_t update;
+	bson_init (&update);
+	bson_t set_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (&update, "$set", -1, &set_doc);
+	(void) bson_append_int32 (&set_doc, "status", -1, JOB_STATUS_RUNNING);
+	(void) bson_append_date_time (&set_doc, "started", -1, (int64_t) time (NULL) * 1000);
+	(void) bson_append_document_end (&update, &set_doc);
+
+	bench_sink += query.len + update.len;
+
+	bson_destroy (&query);
+	bson_destroy (&update);
+
+}
+
+static void bench_stack_images (const bson_oid_t *oid) {
+
+	bson_t query;
+	bson_init (&query);
+	(void) bson_append_oid (&query, "_id", -1, oid);
+
+	bson_t update;
+	bson_init (&update);
+
+	bson_t inc_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (&update, "$inc", -1, &inc_doc);
+	(void) bson_append_int32 (&inc_doc, "imagesCount", -1, BENCH_BSON_IMAGES);
+	(void) bson_append_document_end (&update, &inc_doc);
+
+	bson_t push_doc = BSON_INITIALIZER;
+	bson_t images_doc = BSON_INITIALIZER;
+	bson_t each_array = BSON_INITIALIZER;
+	bson_t job_image_doc = BSON_INITIALIZER;
+
+	(void) bson_append_document_begin (&update, "$push", -1, &push_doc);
+	(void) bson_append_document_begin (&push_doc, "images", -1, &images_doc);
+	(void) bson_append_array_begin (&images_doc, "$each", -1, &each_array);
+
+	char buf[16] = { 0 };
+	const char *key = NULL;
+	size_t keylen = 0;
+	for (unsigned int i = 0; i < BENCH_BSON_IMAGES; i++) {
+		keylen = bson_uint32_to_string (i, &key, buf, sizeof (buf));
+
+		(void) bson_append_document_begin (&each_array, key, (int) keylen, &job_image_doc);
+		bench_image_append (&job_image_doc, &images[i]);
+		(void) bson_append_document_end (&each_array, &job_image_doc);
+	}
+
+	(void) bson_append_array_end (&images_doc, &each_array);
+	(void) bson_append_document_end (&push_doc, &images_doc);
+	(void) bson_append_document_end (&update, &push_doc);
+
+	bench_sink += query.len + update.len;
+
+	bson_destroy (&query);
+	bson_destroy (&update);
+
+}
+
+#pragma endregion
+
+static size_t bench_allocs_count (void) {
+
+	JeevesAllocs allocs = { 0 };
+	jeeves_allocs_get (&allocs);
+
+	return allocs.mallocs + allocs.callocs + allocs.reallocs;
+
+}
+
+// runs the builder & prints its time with its bson allocations
+static void bench_bson (
+	const char *name, void (*builder)(const bson_oid_t *oid),
+	const bson_oid_t *oid
+) {
+
+	const size_t allocs = bench_allocs_count ();
+
+	const double start = bench_now ();
+	for (size_t i = 0; i < BENCH_BSON_ITERATIONS; i++) {
+		builder (oid);
+	}
+
+	const double end = bench_now ();
+
+	bench_print (name, start, end, BENCH_BSON_ITERATIONS);
+	(void) printf (
+		"%-40s %10.2f allocs/op\n", "",
+		(double) (bench_allocs_count () - allocs) / (double) BENCH_BSON_ITERATIONS
+	);
+
+}
+
+// compares the heap documents the job model used to build
+// with the stack documents it builds now
+int main (void) {
+
+	// counts every libbson allocation
+	jeeves_allocs_init ();
+
+	for (unsigned int i = 0; i < BENCH_BSON_IMAGES; i++) {
+		images[i].id = (int) i;
+		(void) snprintf (images[i].saved, JOB_IMAGE_SAVED_SIZE, "/jeeves/uploads/5f1d/%u.png", i);
+		(void) snprintf (images[i].original, JOB_IMAGE_ORIGINAL_SIZE, "image-%u.png", i);
+		(void) memset (images[i].hash, 'a', JOB_IMAGE_HASH_SIZE - 1);
+		images[i].format = IMAGE_FORMAT_PNG;
+		images[i].width = 1920;
+		images[i].height = 1080;
+		images[i].channels = 3;
+	}
+
+	bson_oid_t oid;
+	bson_oid_init (&oid, NULL);
+
+	bench_bson ("status update bson_new ()", bench_heap_status, &oid);
+	bench_bson ("status update bson_init ()", bench_stack_status, &oid);
+
+	bench_bson ("32 images push bson_new ()", bench_heap_images, &oid);
+	bench_bson ("32 images push bson_init ()", bench_stack_images, &oid);
+
+	return 0;
+
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "models/fields.h"
+
+#include "bench.h"
+
+// the keys of a job document in the order they are stored
+// volatile so the compiler can't resolve the lookups at build time
+static const char *volatile job_keys[] = {
+	"_id", "user", "name", "description", "status", "type",
+	"autoStart", "imagesCount", "images", "created", "started", "ended"
+};
+
+#define JOB_KEYS_COUNT				(sizeof (job_keys) / sizeof (job_keys[0]))
+
+// the chain the job parser used before model_field_get ()
+static ModelField bench_fields_strcmp (const char *key) {
+
+	ModelField field = MODEL_FIELD_NONE;
+
+	if (!strcmp (key, "_id")) field = MODEL_FIELD_ID;
+	else if (!strcmp (key, "user")) field = MODEL_FIELD_USER;
+	else if (!strcmp (key, "name")) field = MODEL_FIELD_NAME;
+	else if (!strcmp (key, "description")) field = MODEL_FIELD_DESCRIPTION;
+	else if (!strcmp (key, "status")) field = MODEL_FIELD_STATUS;
+	else if (!strcmp (key, "type")) field = MODEL_FIELD_TYPE;
+	else if (!strcmp (key, "autoStart")) field = MODEL_FIELD_AUTO_START;
+	else if (!strcmp (key, "imagesCount")) field = MODEL_FIELD_IMAGES_COUNT;
+	else if (!strcmp (key, "images")) field = MODEL_FIELD_IMAGES;
+	else if (!strcmp (key, "created")) field = MODEL_FIELD_CREATED;
+	else if (!strcmp (key, "started")) field = MODEL_FIELD_STARTED;
+	else if (!strcmp (key, "ended")) field = MODEL_FIELD_ENDED;
+
+	return field;
+
+}
+
+// compares the old strcmp () chain with the perfect hash lookup
+// over every key of a job document
+int main (void) {
+
+	if (model_fields_init ()) {
+		(void) fprintf (stderr, "Failed to init model fields!\n");
+		return 1;
+	}
+
+	// both must resolve every key to the same field
+	for (size_t i = 0; i < JOB_KEYS_COUNT; i++) {
+		if (bench_fields_strcmp (job_keys[i]) != model_field_get (job_keys[i])) {
+			(void) fprintf (stderr, "Field %s does not match!\n", job_keys[i]);
+			return 1;
+		}
+	}
+
+	const size_t iterations = BENCH_ITERATIONS * JOB_KEYS_COUNT;
+
+	double start = bench_now ();
+	for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+		for (size_t k = 0; k < JOB_KEYS_COUNT; k++) {
+			bench_sink += (size_t) bench_fields_strcmp (job_keys[k]);
+		}
+	}
+
+	bench_print ("job keys strcmp () chain", start, bench_now (), iterations);
+
+	start = bench_now ();
+	for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+		for (size_t k = 0; k < JOB_KEYS_COUNT; k++) {
+			bench_sink += (size_t) model_field_get (job_keys[k]);
+		}
+	}
+
+	bench_print ("job keys model_field_get ()", start, bench_now (), iterations);
+
+	return 0;
+
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef _JEEVES_ALLOCS_H_
+#define _JEEVES_ALLOCS_H_
+
+#include <stddef.h>
+
+typedef struct JeevesAllocs {
+
+	size_t mallocs;
+	size_t callocs;
+	size_t reallocs;
+	size_t frees;
+
+	// total requested bytes
+	size_t bytes;
+
+} JeevesAllocs;
+
+// counts every allocation made by libbson & mongoc
+// only used in development builds & by the benches
+// must be called before any bson is created
+extern void jeeves_allocs_init (void);
+
+// gets a snapshot of the current counters
+extern void jeeves_allocs_get (JeevesAllocs *allocs);
+
+extern void jeeves_allocs_print (void);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef _JEEVES_ARENA_H_
+#define _JEEVES_ARENA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// fits a jobs page writer with its 16KB chunks buffer
+// together with the request's users & jobs
+#define JEEVES_ARENA_BLOCK_SIZE			(32 * 1024)
+
+// only the first block is kept between requests
+#define JEEVES_ARENA_KEEP_SIZE			JEEVES_ARENA_BLOCK_SIZE
+
+typedef struct JeevesArenaStats {
+
+	size_t requests;
+
+	// values served from the arenas
+	size_t allocs;
+	size_t bytes;
+
+	// blocks that had to be malloc'd
+	size_t blocks;
+
+	// the most bytes & values used by a single request
+	size_t max_used;
+	size_t max_allocs;
+
+} JeevesArenaStats;
+
+// starts the calling thread's request scope
+// every value from the arena is valid until the scope ends
+extern void jeeves_arena_request_begin (void);
+
+// releases every value of the request at once
+extern void jeeves_arena_request_end (void);
+
+// returns true if the calling thread is handling a request
+extern bool jeeves_arena_request_active (void);
+
+// returns true if the value was taken from the calling thread's
+// arena & is going to be released when its request ends
+extern bool jeeves_arena_owns (const void *ptr);
+
+// returns zeroed memory that lives until the request ends
+// returns NULL if there is no active request or on error
+extern void *jeeves_arena_calloc (const size_t size);
+
+// gets a snapshot of the current counters
+extern void jeeves_arena_stats (JeevesArenaStats *stats);
+
+extern void jeeves_arena_print (void);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef _JEEVES_AUTH_H_
+#define _JEEVES_AUTH_H_
+
+#include <stddef.h>
+
+// must be powers of 2
+#define JEEVES_AUTH_SHARDS				16
+#define JEEVES_AUTH_BUCKETS				256
+
+struct _HttpRoute;
+
+typedef struct JeevesAuthStats {
+
+	size_t hits;
+	size_t misses;
+	size_t failures;
+
+	size_t inserts;
+	size_t evictions;
+	size_t expirations;
+
+	size_t entries;
+
+} JeevesAuthStats;
+
+// caches the users decoded from verified tokens
+// a ttl of 0 verifies every token in cerver
+extern unsigned int jeeves_auth_init (
+	const unsigned int ttl, const size_t max_entries
+);
+
+extern void jeeves_auth_end (void);
+
+// sets the route to be authenticated with bearer tokens
+// the request's decoded data is an immutable User
+extern void jeeves_auth_route_set (struct _HttpRoute *route);
+
+// gets a snapshot of the current counters
+extern void jeeves_auth_stats (JeevesAuthStats *stats);
+
+extern void jeeves_auth_print (void);
+
+#endif
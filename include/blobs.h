@@ -0,0 +1,29 @@
+#ifndef _JEEVES_BLOBS_H_
+#define _JEEVES_BLOBS_H_
+
+// sha256 as a hex string
+#define JEEVES_BLOB_HASH_SIZE			65
+
+#define JEEVES_BLOB_PATH_SIZE			1024
+
+extern unsigned int jeeves_blobs_init (void);
+
+// generates the file's sha256 hex digest
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_blob_hash_file (
+	const char *filename, char *hash
+);
+
+// generates the blob's location in the store
+extern void jeeves_blob_path (
+	const char *hash, char *path
+);
+
+// stores the file in the content addressed blob store
+// if the blob already exists, the file is replaced by a hard link
+// to the stored blob, so every copy shares the same disk blocks
+extern unsigned int jeeves_blob_store (
+	const char *filename, const char *hash
+);
+
+#endif
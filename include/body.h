@@ -0,0 +1,57 @@
+#ifndef _JEEVES_BODY_H_
+#define _JEEVES_BODY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cerver/types/string.h>
+
+// the found bits are kept in an uint32_t
+#define JEEVES_BODY_MAX_FIELDS			32
+
+// deeper values are rejected as bad requests
+#define JEEVES_BODY_MAX_DEPTH			64
+
+// keys longer than this never match a field
+#define JEEVES_BODY_KEY_SIZE			64
+
+typedef enum JeevesBodyType {
+
+	// only string values are copied & marked as found
+	JEEVES_BODY_TYPE_STRING			= 0,
+
+	// any value is marked as found & only true is set
+	JEEVES_BODY_TYPE_BOOL			= 1,
+
+} JeevesBodyType;
+
+typedef struct JeevesBodyField {
+
+	const char *key;
+	JeevesBodyType type;
+
+	// where the value is written in the target struct
+	size_t offset;
+	size_t size;
+
+} JeevesBodyField;
+
+#define JEEVES_BODY_STRING(key, type, member)		\
+	{ key, JEEVES_BODY_TYPE_STRING, offsetof (type, member), sizeof (((type *) 0)->member) }
+
+#define JEEVES_BODY_BOOL(key, type, member)			\
+	{ key, JEEVES_BODY_TYPE_BOOL, offsetof (type, member), sizeof (bool) }
+
+// copies the top level values of the fields keys
+// straight from the body into the target without a json tree
+// strings are unescaped & truncated to fit like with strncpy ()
+// sets the bit of each field that was found, in the fields order
+// returns 0 on success, 1 if the body is not valid json
+extern unsigned int jeeves_body_parse (
+	const String *body,
+	const JeevesBodyField *fields, const unsigned int n_fields,
+	void *target, uint32_t *found
+);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef _JEEVES_CACHE_H_
+#define _JEEVES_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <bson/bson.h>
+
+#include "json.h"
+
+#define JEEVES_CACHE_NAME_SIZE			32
+
+// must be a power of 2
+#define JEEVES_CACHE_BUCKETS			1024
+
+typedef struct JeevesCacheStats {
+
+	size_t hits;
+	size_t misses;
+
+	size_t inserts;
+	size_t evictions;
+	size_t invalidations;
+
+	size_t entries;
+	size_t bytes;
+
+} JeevesCacheStats;
+
+struct _JeevesCache;
+
+typedef struct _JeevesCache JeevesCache;
+
+// size bounded cache of rendered json values
+// the least recently used values are evicted first
+extern JeevesCache *jeeves_cache_create (
+	const char *name, const size_t max_bytes
+);
+
+extern void jeeves_cache_delete (JeevesCache *cache);
+
+// appends the cached json to the buffer if the key exists
+// and it belongs to the owner (if any)
+// on a miss, the key's generation is returned to be used with put
+// returns 0 on hit, 1 on miss
+extern unsigned int jeeves_cache_get (
+	JeevesCache *cache,
+	const bson_oid_t *key, const bson_oid_t *owner,
+	JeevesJson *json,
+	uint64_t *generation
+);
+
+// stores a copy of the json only if the key has not been
+// invalidated since its generation was taken in get
+extern void jeeves_cache_put (
+	JeevesCache *cache,
+	const bson_oid_t *key, const bson_oid_t *owner,
+	const char *json, const size_t json_len,
+	const uint64_t generation
+);
+
+// removes the key's value & prevents in flight reads from storing it
+extern void jeeves_cache_invalidate (
+	JeevesCache *cache, const bson_oid_t *key
+);
+
+// gets a snapshot of the current counters
+extern void jeeves_cache_stats (
+	JeevesCache *cache, JeevesCacheStats *stats
+);
+
+extern void jeeves_cache_print (JeevesCache *cache);
+
+#endif
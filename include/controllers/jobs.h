@@ -10,6 +10,9 @@
 
 #define DEFAULT_JOBS_POOL_INIT			16
 
+// longer types never match a job type
+#define JOB_CONFIG_TYPE_SIZE			32
+
 struct _HttpResponse;
 
 extern struct _HttpResponse *no_user_jobs;
@@ -22,19 +25,43 @@ extern unsigned int jeeves_jobs_init (void);
 
 extern void jeeves_jobs_end (void);
 
-extern unsigned int jeeves_jobs_get_all_by_user_to_json (
-	const bson_oid_t *user_oid,
-	char **json, size_t *json_len
+// iterates a page of the user's jobs without their images
+extern unsigned int jeeves_jobs_get_page_by_user (
+	const bson_oid_t *user_oid, const JobsPage *page,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
+);
+
+// iterates a page of the user's job images
+// returns 1 if the job's id is not valid or on error
+extern unsigned int jeeves_job_get_images_page_by_id (
+	const String *job_id, const bson_oid_t *user_oid,
+	const JobImagesPage *page,
+	bool (*each)(void *data, const JobImage *job_image), void *data
 );
 
+// projections to fetch only the values that each operation needs
+extern const bson_t *job_no_user_query_opts;
+extern const bson_t *job_status_query_opts;
+extern const bson_t *job_state_query_opts;
+extern const bson_t *job_images_query_opts;
+
 extern JeevesJob *jeeves_job_get_by_id_and_user (
-	const String *job_id, const bson_oid_t *user_oid
+	const String *job_id, const bson_oid_t *user_oid,
+	const bson_t *query_opts
 );
 
 extern u8 jeeves_job_get_by_id_and_user_to_json (
 	const char *job_id, const bson_oid_t *user_oid,
 	const bson_t *query_opts,
-	char **json, size_t *json_len
+	JeevesJson *json
+);
+
+// iterates the job's document as it comes from the db
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_job_get_by_id_and_user_each (
+	const String *job_id, const bson_oid_t *user_oid,
+	const bson_t *query_opts,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
 );
 
 extern JeevesError jeeves_job_create (
@@ -1,26 +1,60 @@
 #ifndef _JEEVES_ROLES_H_
 #define _JEEVES_ROLES_H_
 
+#include <stdbool.h>
+
 #include <bson/bson.h>
 
 #include "models/role.h"
 
-extern const Role *common_role;
+// distinct actions that can be checked with the bitsets
+#define JEEVES_ROLES_MAX_ACTIONS		64
+
+// a replaced table is only freed once it has no readers
+// & this many seconds after it was replaced, which covers a lookup
+// that loaded the table right before the swap but has not counted itself
+#define JEEVES_ROLES_GRACE				30
+
+// the bit of an action in every role's actions
+typedef int JeevesRoleAction;
 
-extern unsigned int jeeves_roles_init (void);
+#define JEEVES_ROLE_ACTION_NONE			(-1)
+
+// loads the roles & reloads them every reload_interval seconds
+// a value of 0 only reloads them on SIGHUP
+extern unsigned int jeeves_roles_init (const unsigned int reload_interval);
 
 extern void jeeves_roles_end (void);
 
-extern const Role *jeeves_role_get_by_oid (
-	const bson_oid_t *role_oid
+// signal handler that wakes up the reload thread
+extern void jeeves_roles_reload_signal (int signum);
+
+// the lookups copy the role values so that nothing
+// points into a table after it has been replaced
+
+// copies the oid of the role that is assigned to new users
+extern unsigned int jeeves_role_common_oid (bson_oid_t *role_oid);
+
+extern unsigned int jeeves_role_get_by_oid (
+	const bson_oid_t *role_oid, Role *role
 );
 
-extern const Role *jeeves_role_get_by_name (
-	const char *role_name
+extern unsigned int jeeves_role_get_by_name (
+	const char *role_name, Role *role
 );
 
-extern const char *jeeves_role_name_get_by_oid (
-	const bson_oid_t *role_oid
+// role_name must hold ROLE_NAME_SIZE bytes
+extern unsigned int jeeves_role_name_get_by_oid (
+	const bson_oid_t *role_oid, char *role_name
+);
+
+// resolves the action to its bit once when setting up the routes
+// returns JEEVES_ROLE_ACTION_NONE if every bit is taken
+extern JeevesRoleAction jeeves_roles_action_get (const char *action);
+
+// returns true if the role with the oid is allowed to perform the action
+extern bool jeeves_role_oid_has_action (
+	const bson_oid_t *role_oid, const JeevesRoleAction action
 );
 
 #endif
\ No newline at end of file
@@ -4,6 +4,10 @@
 struct _HttpResponse;
 
 extern struct _HttpResponse *missing_values;
+extern struct _HttpResponse *bad_image;
+
+// too many db bound requests are being handled
+extern struct _HttpResponse *server_busy;
 
 extern struct _HttpResponse *jeeves_works;
 extern struct _HttpResponse *current_version;
@@ -0,0 +1,58 @@
+#ifndef _JEEVES_UPLOADS_H_
+#define _JEEVES_UPLOADS_H_
+
+#include <stdbool.h>
+
+#include <sys/stat.h>
+
+#define JEEVES_UPLOADS_FILES_CACHE_SIZE		64
+
+#define JEEVES_UPLOADS_FILE_PATH_SIZE		1024
+#define JEEVES_UPLOADS_FILE_ETAG_SIZE		64
+
+struct _HttpResponse;
+
+extern struct _HttpResponse *upload_not_found;
+
+typedef struct UploadFile {
+
+	char path[JEEVES_UPLOADS_FILE_PATH_SIZE];
+	unsigned int hash;
+
+	int fd;
+	struct stat st;
+
+	// strong validator based on the file's inode, size & mtime
+	char etag[JEEVES_UPLOADS_FILE_ETAG_SIZE];
+
+	// set when the file is opened because the cached
+	// path can be cleared while the file is being sent
+	const char *content_type;
+
+	bool cached;
+	unsigned int refs;
+	unsigned long last_used;
+
+} UploadFile;
+
+extern unsigned int jeeves_uploads_init (void);
+
+extern void jeeves_uploads_end (void);
+
+// gets an open file descriptor for the requested upload
+// reuses cached descriptors if the file has not changed
+extern const UploadFile *jeeves_uploads_file_open (
+	const char *path
+);
+
+// releases the file that was returned by jeeves_uploads_file_open ()
+extern void jeeves_uploads_file_close (
+	const UploadFile *file
+);
+
+// returns the file's content type based on its extension
+extern const char *jeeves_uploads_file_content_type (
+	const char *path
+);
+
+#endif
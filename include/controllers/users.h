@@ -9,6 +9,9 @@
 
 #define DEFAULT_USERS_POOL_INIT			16
 
+// users that are kept to be reused, the rest are freed
+#define DEFAULT_USERS_POOL_MAX			64
+
 struct _HttpReceive;
 struct _HttpResponse;
 
@@ -72,6 +75,12 @@ extern u8 jeeves_user_check_by_email (
 	const char *email
 );
 
+// fills the user with the values of a token's payload
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_user_parse_json (
+	User *user, void *user_json_ptr
+);
+
 // {
 //   "email": "erick.salas@ermiry.com",
 //   "iat": 1596532954
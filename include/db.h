@@ -0,0 +1,131 @@
+#ifndef _JEEVES_DB_H_
+#define _JEEVES_DB_H_
+
+#include <stdint.h>
+
+#include <bson/bson.h>
+#include <mongoc/mongoc.h>
+
+#define JEEVES_DB_INDEX_MAX_KEYS		4
+
+#define JEEVES_DB_SHAPE_SIZE			256
+#define JEEVES_DB_QUERY_SIZE			256
+#define JEEVES_DB_EXPLAIN_SIZE			256
+
+// each collection & query shape is explained at most once per interval
+#define JEEVES_DB_EXPLAIN_INTERVAL		60
+#define JEEVES_DB_EXPLAIN_SLOTS			256
+
+// appends maxPoolSize to the uri's options
+// so cmongo & the db clients pool are created with the same size
+// a pool size of 0 keeps the uri as it is
+// returns 0 on success, 1 if the uri does not fit
+extern unsigned int jeeves_db_uri_pool_size (
+	char *uri, const size_t uri_size, const unsigned int pool_size
+);
+
+// dedicated clients pool for the operations
+// that are not available through cmongo
+extern unsigned int jeeves_db_init (
+	const char *uri, const char *app_name, const char *db_name
+);
+
+extern void jeeves_db_end (void);
+
+// keeps a client for the calling thread until it is unpinned
+// does nothing if MONGO_PIN_CLIENTS is not set
+extern void jeeves_db_thread_pin (void);
+
+// returns the thread's client to the pool
+// must be called before the thread exits
+extern void jeeves_db_thread_unpin (void);
+
+typedef struct JeevesDbClientsStats {
+
+	size_t pops;
+
+	// pops that found the pool empty
+	size_t waits;
+
+	// clients that are kept by threads
+	size_t pinned;
+
+	// total & max time spent waiting for a client
+	uint64_t wait_us;
+	uint64_t max_wait_us;
+
+} JeevesDbClientsStats;
+
+extern void jeeves_db_clients_stats (JeevesDbClientsStats *stats);
+
+extern void jeeves_db_clients_print (void);
+
+// atomically updates the first document that matches the query
+// and parses the updated document into output using the opts projection
+// returns 0 if a document was updated, 1 if no document matched or on error
+extern unsigned int jeeves_db_find_and_modify (
+	const char *coll_name,
+	const bson_t *query, const bson_t *update, const bson_t *query_opts,
+	void (*parser)(void *output, const bson_t *doc), void *output
+);
+
+// iterates every document that matches the query
+// the callback returns false to stop the iteration
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_db_find_each (
+	const char *coll_name,
+	const bson_t *query, const bson_t *opts,
+	bool (*each)(void *data, const bson_t *doc), void *data
+);
+
+// inserts the documents with a single command
+// returns 0 if every document was inserted, 1 on error
+extern unsigned int jeeves_db_insert_many (
+	const char *coll_name,
+	const bson_t **docs, const size_t n_docs
+);
+
+// an ascending index that a model's queries rely on
+typedef struct JeevesDbIndex {
+
+	const char *name;
+	const char *keys[JEEVES_DB_INDEX_MAX_KEYS];
+	bool unique;
+
+} JeevesDbIndex;
+
+// creates the collection's indexes that do not exist yet
+// an index with the same name but different keys is reported as an error
+// returns 0 if every index exists, 1 on error
+extern unsigned int jeeves_db_create_indexes (
+	const char *coll_name,
+	const JeevesDbIndex *indexes, const size_t n_indexes
+);
+
+// keeps a copy of the operation's query bytes without allocating
+// to be able to explain it if it was slow
+// queries bigger than JEEVES_DB_QUERY_SIZE are only timed
+typedef struct JeevesDbTimer {
+
+	const char *coll_name;
+	const char *operation;
+
+	uint8_t query[JEEVES_DB_QUERY_SIZE];
+	uint32_t query_len;
+
+	int64_t start;
+
+} JeevesDbTimer;
+
+extern void jeeves_db_timer_start (
+	JeevesDbTimer *timer,
+	const char *coll_name, const char *operation,
+	const bson_t *query
+);
+
+// logs the operation with its query shape if it took longer
+// than DB_SLOW_QUERY_MS & then its explain summary
+// if its shape was not explained in the last interval
+extern void jeeves_db_timer_end (JeevesDbTimer *timer);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef _JEEVES_DB_LIMIT_H_
+#define _JEEVES_DB_LIMIT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct _HttpReceive;
+struct _HttpRequest;
+
+typedef struct JeevesDbLimitStats {
+
+	size_t handled;
+	size_t rejected;
+
+	// the most requests that have been in flight at the same time
+	size_t max_inflight;
+
+} JeevesDbLimitStats;
+
+// limits the db bound handlers that block cerver's handler threads
+// a value of 0 does not limit them
+extern void jeeves_db_limit_init (const unsigned int max_inflight);
+
+// runs the route's handler in the caller's thread
+// replies with 503 if too many handlers are already in flight
+// the handler always runs in its own request arena scope
+// returns false if the caller is the handler that is already running
+extern bool jeeves_db_limit_handle (
+	const struct _HttpReceive *http_receive,
+	const struct _HttpRequest *request,
+	void (*handler)(
+		const struct _HttpReceive *http_receive,
+		const struct _HttpRequest *request
+	)
+);
+
+extern void jeeves_db_limit_stats (JeevesDbLimitStats *stats);
+
+extern void jeeves_db_limit_print (void);
+
+#endif
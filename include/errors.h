@@ -6,7 +6,9 @@
 	XX(1,	BAD_REQUEST, 		Bad Request)		\
 	XX(2,	MISSING_VALUES, 	Missing Values)		\
 	XX(3,	BAD_USER, 			Bad User)			\
-	XX(4,	SERVER_ERROR, 		Server Error)
+	XX(4,	SERVER_ERROR, 		Server Error)		\
+	XX(5,	BAD_IMAGE, 			Bad Image)			\
+	XX(6,	SERVER_BUSY, 		Server Busy)
 
 typedef enum JeevesError {
 
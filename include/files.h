@@ -9,4 +9,21 @@ extern String *jeeves_uploads_dirname_generator (
 	const CerverReceive *cr
 );
 
-#endif
\ No newline at end of file
+// moves a file into its new location
+// the file is first written with a temporary name in the
+// destination directory & then renamed to its final name
+extern unsigned int jeeves_files_move_file (
+	const char *old_location, const char *new_location
+);
+
+// moves every file inside old_dirname into new_dirname
+// and removes old_dirname once it is empty
+extern unsigned int jeeves_files_move_dir (
+	const char *old_dirname, const char *new_dirname
+);
+
+// requests the kernel to start reading the file into the page cache
+// returns right away, the actual reads happen in the background
+extern unsigned int jeeves_files_prefetch (const char *filename);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef _JEEVES_FORMATS_H_
+#define _JEEVES_FORMATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <bson/bson.h>
+
+#include "json.h"
+
+#define JEEVES_FORMAT_MAP(XX)									\
+	XX(0,	JSON, 			application/json)					\
+	XX(1,	BSON, 			application/bson)					\
+	XX(2,	MSGPACK, 		application/msgpack)
+
+typedef enum JeevesFormat {
+
+	#define XX(num, name, type) JEEVES_FORMAT_##name = num,
+	JEEVES_FORMAT_MAP (XX)
+	#undef XX
+
+} JeevesFormat;
+
+extern const char *jeeves_format_content_type (
+	const JeevesFormat format
+);
+
+// picks the supported type with the highest q value
+// json is used if there is no header or nothing else matches
+extern JeevesFormat jeeves_format_from_accept (const char *accept);
+
+// appends the document in the format
+// bson documents are copied as they are
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_format_write_bson (
+	JeevesJson *buffer, const JeevesFormat format,
+	const bson_t *doc, JeevesJsonEnum enum_name
+);
+
+// msgpack values use the same schema as the json responses
+extern void jeeves_msgpack_write_map (
+	JeevesJson *buffer, const uint32_t n
+);
+
+extern void jeeves_msgpack_write_str (
+	JeevesJson *buffer, const char *str, const size_t len
+);
+
+// writes an array header with a count to be set later
+// returns the header's offset
+extern size_t jeeves_msgpack_write_array_begin (JeevesJson *buffer);
+
+extern void jeeves_msgpack_write_array_end (
+	JeevesJson *buffer, const size_t offset, const uint32_t count
+);
+
+extern void jeeves_msgpack_write_value (
+	JeevesJson *buffer, const bson_value_t *value,
+	const char *key, JeevesJsonEnum enum_name
+);
+
+#endif
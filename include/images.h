@@ -0,0 +1,45 @@
+#ifndef _JEEVES_IMAGES_H_
+#define _JEEVES_IMAGES_H_
+
+// bigger images are rejected before they reach the worker
+#define JEEVES_IMAGE_MAX_DIMENSION		16384
+#define JEEVES_IMAGE_MAX_PIXELS			(1 << 27)
+
+#define JEEVES_IMAGE_FORMAT_MAP(XX)				\
+	XX(0,	NONE, 			None)				\
+	XX(1,	PNG, 			PNG)				\
+	XX(2,	JPEG, 			JPEG)				\
+	XX(3,	BMP, 			BMP)				\
+	XX(4,	GIF, 			GIF)				\
+	XX(5,	PNM, 			PNM)
+
+typedef enum ImageFormat {
+
+	#define XX(num, name, string) IMAGE_FORMAT_##name = num,
+	JEEVES_IMAGE_FORMAT_MAP (XX)
+	#undef XX
+
+} ImageFormat;
+
+extern const char *jeeves_image_format_to_string (
+	const ImageFormat format
+);
+
+typedef struct ImageInfo {
+
+	ImageFormat format;
+
+	int width;
+	int height;
+	int channels;
+
+} ImageInfo;
+
+// sniffs the file's magic bytes & parses only its headers
+// to get the image's format, dimensions & number of channels
+// returns 0 if the file is a valid image, 1 on error
+extern unsigned int jeeves_image_info_read (
+	const char *filename, ImageInfo *info
+);
+
+#endif
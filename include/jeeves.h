@@ -4,12 +4,18 @@
 #include <stdbool.h>
 
 #include "runtime.h"
+#include "scheduler.h"
+#include "storage.h"
 
 #define JEEVES_UPLOADS_TEMP_DIR			"/var/uploads"
 #define JEEVES_UPLOADS_DIR				"/home/jeeves/uploads"
+#define JEEVES_UPLOADS_INCOMING_DIR		"/home/jeeves/uploads/.incoming"
+#define JEEVES_UPLOADS_BLOBS_DIR		"/home/jeeves/uploads/.blobs"
 
 #define JEEVES_UPLOADS_PATH				"/api/uploads"
 
+#define DEFAULT_STORAGE_BACKEND			JEEVES_STORAGE_MONGO
+
 #define MONGO_URI_SIZE					256
 #define MONGO_APP_NAME_SIZE				32
 #define MONGO_DB_SIZE					32
@@ -17,6 +23,24 @@
 #define PRIV_KEY_SIZE					128
 #define PUB_KEY_SIZE					128
 
+#define DEFAULT_JOBS_WORKER_THREADS		2
+#define DEFAULT_JOBS_SCHEDULER			JOBS_SCHEDULER_SJF
+#define DEFAULT_JOBS_SCHEDULER_AGING	0.5
+
+#define DEFAULT_JOBS_CACHE_SIZE			(8 * 1024 * 1024)
+
+#define DEFAULT_DB_SLOW_QUERY_MS		100
+
+// leaves a handler thread for the requests that don't use the db
+#define DEFAULT_DB_INFLIGHT_LIMIT		(CERVER_DEFAULT_POOL_THREADS - 1)
+
+#define DEFAULT_MONGO_POOL_SIZE			0
+
+#define DEFAULT_JWT_CACHE_TTL			300
+#define DEFAULT_JWT_CACHE_SIZE			4096
+
+#define DEFAULT_ROLES_RELOAD_INTERVAL	300
+
 struct _HttpCerver;
 
 extern struct _HttpCerver *http_cerver;
@@ -31,11 +55,64 @@ extern unsigned int CERVER_RECEIVE_BUFFER_SIZE;
 extern unsigned int CERVER_TH_THREADS;
 extern unsigned int CERVER_CONNECTION_QUEUE;
 
+// MONGO or MEMORY to run without a db
+extern JeevesStorageType STORAGE_BACKEND;
+
 extern const char *PRIV_KEY;
 extern const char *PUB_KEY;
 
 extern bool ENABLE_USERS_ROUTES;
 
+extern bool ENABLE_DIRECT_UPLOADS;
+
+// where cerver saves incoming multi-part files
+// JEEVES_UPLOADS_TEMP_DIR or JEEVES_UPLOADS_INCOMING_DIR
+extern const char *UPLOADS_TEMP_DIR;
+
+// keep each job's images in their own documents
+// instead of an array inside the job's document
+extern bool ENABLE_JOB_IMAGES_COLLECTION;
+
+// how many jobs can be processed at the same time
+extern unsigned int JOBS_WORKER_THREADS;
+
+// the order in which queued jobs are started
+extern JobsScheduler JOBS_SCHEDULER;
+
+// megapixels a queued job's cost is reduced every second
+extern double JOBS_SCHEDULER_AGING;
+
+// max bytes of rendered jobs json kept in memory by each cache
+// a value of 0 disables the jobs caches
+extern size_t JOBS_CACHE_SIZE;
+
+// db operations slower than this are logged with an explain summary
+// a value of 0 disables slow queries detection
+extern unsigned int DB_SLOW_QUERY_MS;
+
+// db bound handlers that can block cerver's handler threads
+// at the same time before replying with 503
+// must be less than CERVER_TH_THREADS, 0 does not limit them
+extern unsigned int DB_INFLIGHT_LIMIT;
+
+// max clients in each mongo pool
+// a value of 0 keeps the MONGO_URI maxPoolSize
+extern unsigned int MONGO_POOL_SIZE;
+
+// keeps a dedicated client for each worker thread
+extern bool MONGO_PIN_CLIENTS;
+
+// seconds a verified token's user is kept in memory
+// a value of 0 verifies the token in every request
+extern unsigned int JWT_CACHE_TTL;
+
+// max tokens kept in the auth cache
+extern size_t JWT_CACHE_SIZE;
+
+// seconds between roles reloads from the db
+// a value of 0 only reloads them on SIGHUP
+extern unsigned int ROLES_RELOAD_INTERVAL;
+
 // inits jeeves main values
 extern unsigned int jeeves_init (void);
 
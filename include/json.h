@@ -0,0 +1,53 @@
+#ifndef _JEEVES_JSON_H_
+#define _JEEVES_JSON_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <bson/bson.h>
+
+#define JEEVES_JSON_INITIAL_SIZE		4096
+
+// buffers bigger than this are released after each use
+#define JEEVES_JSON_KEEP_SIZE			(256 * 1024)
+
+typedef struct JeevesJson {
+
+	char *data;
+	size_t len;
+	size_t size;
+
+	// set if the buffer could not grow
+	bool error;
+
+} JeevesJson;
+
+// returns the name of an int32 field's value
+// or NULL to write the value as a number
+typedef const char *(*JeevesJsonEnum)(
+	const char *key, const int32_t value
+);
+
+// gets the calling thread's reusable buffer
+// it is empty & is only valid until the next call
+extern JeevesJson *jeeves_json_thread (void);
+
+extern void jeeves_json_reset (JeevesJson *json);
+
+extern void jeeves_json_destroy (JeevesJson *json);
+
+// appends raw bytes to the buffer
+extern void jeeves_json_write (
+	JeevesJson *json, const char *data, const size_t data_len
+);
+
+// appends the document in a single pass
+// oids are plain hex strings & dates are ISO 8601 strings
+// int32 values are written by their names if enum_name knows them
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_json_write_bson (
+	JeevesJson *json, const bson_t *doc, JeevesJsonEnum enum_name
+);
+
+#endif
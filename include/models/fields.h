@@ -0,0 +1,63 @@
+#ifndef _MODELS_FIELDS_H_
+#define _MODELS_FIELDS_H_
+
+// fields table size, must be a power of 2
+#define MODEL_FIELDS_TABLE_SIZE			64
+
+// seed that maps every field into a different slot
+// model_fields_init () searches for a new one if a field is added
+#define MODEL_FIELDS_SEED				59
+
+// every field that is parsed from a model's document
+#define MODEL_FIELD_MAP(XX)							\
+	XX(1,	ID, 			_id)					\
+	XX(2,	USER, 			user)					\
+	XX(3,	NAME, 			name)					\
+	XX(4,	DESCRIPTION, 	description)			\
+	XX(5,	STATUS, 		status)					\
+	XX(6,	TYPE, 			type)					\
+	XX(7,	AUTO_START, 	autoStart)				\
+	XX(8,	IMAGES_COUNT, 	imagesCount)			\
+	XX(9,	IMAGES, 		images)					\
+	XX(10,	CREATED, 		created)				\
+	XX(11,	STARTED, 		started)				\
+	XX(12,	STOPPED, 		stopped)				\
+	XX(13,	ENDED, 			ended)					\
+	XX(14,	SAVED, 			saved)					\
+	XX(15,	ORIGINAL, 		original)				\
+	XX(16,	RESULT, 		result)					\
+	XX(17,	HASH, 			hash)					\
+	XX(18,	FORMAT, 		format)					\
+	XX(19,	WIDTH, 			width)					\
+	XX(20,	HEIGHT, 		height)					\
+	XX(21,	CHANNELS, 		channels)				\
+	XX(22,	ROLE, 			role)					\
+	XX(23,	EMAIL, 			email)					\
+	XX(24,	USERNAME, 		username)				\
+	XX(25,	PASSWORD, 		password)				\
+	XX(26,	ACTIONS, 		actions)				\
+	XX(27,	PIXELS, 		pixels)					\
+	XX(28,	JOB, 			job)					\
+	XX(29,	IMAGE, 			image)
+
+typedef enum ModelField {
+
+	MODEL_FIELD_NONE = 0,
+
+	#define XX(num, name, string) MODEL_FIELD_##name = num,
+	MODEL_FIELD_MAP (XX)
+	#undef XX
+
+} ModelField;
+
+extern const char *model_field_to_string (const ModelField field);
+
+// builds the fields perfect hash table
+extern unsigned int model_fields_init (void);
+
+// gets the field that matches the document's key
+// with a single hash & a single string compare
+// returns MODEL_FIELD_NONE for unknown keys
+extern ModelField model_field_get (const char *key);
+
+#endif
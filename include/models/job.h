@@ -10,6 +10,9 @@
 
 #include <cerver/collections/dlist.h>
 
+#include "images.h"
+#include "json.h"
+
 #define JOB_ID_SIZE						32
 #define JOB_NAME_SIZE					512
 #define JOB_DESCRIPTION_SIZE			1024
@@ -17,11 +20,30 @@
 #define JOB_IMAGE_SAVED_SIZE			512
 #define JOB_IMAGE_ORIGINAL_SIZE			512
 #define JOB_IMAGE_RESULT_SIZE			512
+#define JOB_IMAGE_HASH_SIZE				65
+
+#define JOB_IMAGES_INITIAL_CAPACITY		16
+
+#define JOBS_PAGE_DEFAULT_LIMIT			50
+#define JOBS_PAGE_MAX_LIMIT				500
+
+#define JOB_IMAGES_PAGE_DEFAULT_LIMIT	100
+#define JOB_IMAGES_PAGE_MAX_LIMIT		1000
 
 extern unsigned int jobs_model_init (void);
 
+// keeps each image in its own document
+// instead of an array inside the job's document
+extern unsigned int jobs_model_images_collection_init (void);
+
 extern void jobs_model_end (void);
 
+// enables the jobs json caches with max bytes each
+// every write in the model invalidates the affected values
+extern unsigned int jobs_model_cache_init (const size_t max_bytes);
+
+extern void jobs_model_cache_print (void);
+
 #define JOB_STATUS_MAP(XX)						\
 	XX(0,	NONE, 			None)				\
 	XX(1,	WAITING, 		Waiting)			\
@@ -60,6 +82,12 @@ extern const char *job_type_to_string (const JobType type);
 
 extern JobType job_type_from_string (const char *type_string);
 
+// writes jobs status & type and images format by their names
+extern const char *job_json_enum (const char *key, const int32_t value);
+
+// writes jobs status & type and images format by their names
+extern const char *job_json_enum (const char *key, const int32_t value);
+
 typedef struct JobImage {
 
 	int id;
@@ -67,6 +95,15 @@ typedef struct JobImage {
 	char original[JOB_IMAGE_ORIGINAL_SIZE];
 	char result[JOB_IMAGE_RESULT_SIZE];
 
+	// sha256 of the image's contents
+	char hash[JOB_IMAGE_HASH_SIZE];
+
+	// taken from the image's headers at upload time
+	ImageFormat format;
+	int width;
+	int height;
+	int channels;
+
 } JobImage;
 
 extern JobImage *job_image_new (void);
@@ -80,6 +117,9 @@ extern JobImage *job_image_create (
 	const char *result
 );
 
+// appends the image's fields into an existing document
+extern void job_image_append_bson (bson_t *doc, const JobImage *job_image);
+
 extern bson_t *job_image_to_bson (JobImage *job_image);
 
 typedef struct JeevesJob {
@@ -96,8 +136,19 @@ typedef struct JeevesJob {
 
 	JobType type;
 
+	// start the job as soon as it becomes READY
+	bool autostart;
+
 	int n_images;
-	DoubleList *images;
+
+	// sum of every image's width * height
+	int64_t pixels;
+
+	// contiguous images buffer that is kept
+	// when the job is returned to the pool
+	JobImage *images;
+	size_t images_count;
+	size_t images_capacity;
 
 	time_t created;
 	time_t started;
@@ -112,21 +163,103 @@ extern void jeeves_job_delete (void *job_ptr);
 
 extern void jeeves_job_print (const JeevesJob *job);
 
+// makes sure the job can hold n images without reallocating
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_job_images_reserve (
+	JeevesJob *job, const size_t n
+);
+
+// appends a copy of the image into the job's images buffer
+extern JobImage *jeeves_job_images_add (
+	JeevesJob *job, const JobImage *job_image
+);
+
 extern u8 jeeves_job_get_by_oid_and_user (
 	JeevesJob *job,
 	const bson_oid_t *oid, const bson_oid_t *user_oid,
 	const bson_t *query_opts
 );
 
+// gets only the job's images using the job's oid
+extern u8 jeeves_job_get_images (
+	JeevesJob *job, const bson_t *query_opts
+);
+
+// iterates the job's document as it comes from the cursor
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_job_get_by_oid_and_user_each (
+	const bson_oid_t *oid, const bson_oid_t *user_oid,
+	const bson_t *query_opts,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
+);
+
+// writes the job's json into the buffer
 extern u8 jeeves_job_get_by_oid_and_user_to_json (
 	const bson_oid_t *oid, const bson_oid_t *user_oid,
 	const bson_t *query_opts,
-	char **json, size_t *json_len
+	JeevesJson *json
 );
 
-extern unsigned int jobs_get_all_by_user_to_json (
+// a page of the job's images ordered by their id
+typedef struct JobImagesPage {
+
+	int limit;
+
+	// only images with a greater id
+	int after;
+
+} JobImagesPage;
+
+// iterates the page's images ordered by their id
+// one extra image is requested to know if there is a next page
+// returns 0 on success, 1 on error
+extern unsigned int jeeves_job_get_images_page (
+	const bson_oid_t *job_oid, const bson_oid_t *user_oid,
+	const JobImagesPage *page,
+	bool (*each)(void *data, const JobImage *job_image), void *data
+);
+
+// a page of the user's jobs ordered from the newest to the oldest
+typedef struct JobsPage {
+
+	int limit;
+
+	// only jobs that were created before this one
+	bool has_after;
+	bson_oid_t after;
+
+	// JOB_STATUS_NONE to get every job
+	JobStatus status;
+
+} JobsPage;
+
+// only the first page without filters is cached
+#define jobs_page_is_cacheable(page)						\
+	(!(page)->has_after									\
+	&& ((page)->status == JOB_STATUS_NONE)				\
+	&& ((page)->limit == JOBS_PAGE_DEFAULT_LIMIT))
+
+// iterates the page's jobs as they come from the cursor
+// one extra job is requested to know if there is a next page
+// returns 0 on success, 1 on error
+extern unsigned int jobs_get_page_by_user (
 	const bson_oid_t *user_oid, const bson_t *opts,
-	char **json, size_t *json_len
+	const JobsPage *page,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
+);
+
+// gets the user's cached first page
+// returns 0 on hit, 1 on miss with the generation to be used with put
+extern unsigned int jobs_model_list_cache_get (
+	const bson_oid_t *user_oid,
+	JeevesJson *json,
+	uint64_t *generation
+);
+
+extern void jobs_model_list_cache_put (
+	const bson_oid_t *user_oid,
+	const char *json, const size_t json_len,
+	const uint64_t generation
 );
 
 extern unsigned int jeeves_job_insert_one (
@@ -138,15 +271,11 @@ extern unsigned int jeeves_job_update_one (
 );
 
 extern unsigned int jeeves_job_update_status (
-	const bson_oid_t *job_oid, const JobStatus status
-);
-
-extern unsigned int jeeves_job_update_config (
-	const JeevesJob *job
+	const JeevesJob *job, const JobStatus status
 );
 
 extern unsigned int jeeves_job_update_images (
-	const bson_oid_t *job_oid, DoubleList *images
+	const JeevesJob *job, DoubleList *images
 );
 
 extern unsigned int jeeves_job_update_image_result (
@@ -154,16 +283,38 @@ extern unsigned int jeeves_job_update_image_result (
 	const char *result
 );
 
-extern unsigned int jeeves_job_update_start (
-	const bson_oid_t *job_oid
+// state transitions are applied with a single conditional update
+// and return the job's updated values selected by the query opts
+// returns 0 if the job was updated, 1 if it was not in the expected status
+
+// READY -> RUNNING
+extern unsigned int jeeves_job_transition_start (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bson_t *query_opts
 );
 
-extern unsigned int jeeves_job_update_stop (
-	const bson_oid_t *job_oid
+// RUNNING -> STOPPED
+extern unsigned int jeeves_job_transition_stop (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bson_t *query_opts
+);
+
+// RUNNING -> DONE
+// fails if the job was stopped while it was running
+extern unsigned int jeeves_job_transition_end (
+	JeevesJob *job, const bson_t *query_opts
 );
 
-extern unsigned int jeeves_job_update_end (
-	const bson_oid_t *job_oid
+// any status except RUNNING -> READY
+extern unsigned int jeeves_job_transition_ready (
+	JeevesJob *job, const bson_t *query_opts
+);
+
+// sets the job's type & autostart if it is not running
+extern unsigned int jeeves_job_transition_config (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bool set_autostart,
+	const bson_t *query_opts
 );
 
 #endif
\ No newline at end of file
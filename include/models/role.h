@@ -79,4 +79,11 @@ extern mongoc_cursor_t *role_find_all (
 	const CMongoSelect *select, uint64_t *n_docs
 );
 
+// parses every role with its name & actions
+// the callback returns false to stop the iteration
+// returns 0 on success, 1 on error
+extern unsigned int role_get_all (
+	bool (*each)(void *data, const Role *role), void *data
+);
+
 #endif
\ No newline at end of file
@@ -40,7 +40,7 @@ extern void *user_new (void);
 
 extern void user_delete (void *user_ptr);
 
-extern void user_print (User *user);
+extern void user_print (const User *user);
 
 extern bson_t *user_query_id (const char *id);
 
@@ -0,0 +1,13 @@
+#ifndef _JEEVES_ROUTES_UPLOADS_H_
+#define _JEEVES_ROUTES_UPLOADS_H_
+
+struct _HttpReceive;
+struct _HttpRequest;
+
+// GET /api/uploads/:user/:dirname/:filename
+extern void jeeves_uploads_handler (
+	const struct _HttpReceive *http_receive,
+	const struct _HttpRequest *request
+);
+
+#endif
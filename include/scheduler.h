@@ -0,0 +1,49 @@
+#ifndef _JEEVES_SCHEDULER_H_
+#define _JEEVES_SCHEDULER_H_
+
+#include <time.h>
+
+// used for images uploaded without dimensions
+#define JEEVES_SCHEDULER_DEFAULT_IMAGE_MP		1.0
+
+// fixed cost of loading, saving & updating each image
+// measured in megapixels
+#define JEEVES_SCHEDULER_IMAGE_OVERHEAD			0.25
+
+#define JEEVES_SCHEDULER_MAP(XX)					\
+	XX(0,	NONE, 			None)					\
+	XX(1,	FIFO, 			FIFO)					\
+	XX(2,	SJF, 			SJF)
+
+typedef enum JobsScheduler {
+
+	#define XX(num, name, string) JOBS_SCHEDULER_##name = num,
+	JEEVES_SCHEDULER_MAP (XX)
+	#undef XX
+
+} JobsScheduler;
+
+extern const char *jeeves_scheduler_to_string (
+	const JobsScheduler scheduler
+);
+
+extern JobsScheduler jeeves_scheduler_from_string (
+	const char *string
+);
+
+struct JeevesJob;
+
+// estimates the job's cost as the sum of its images megapixels
+// multiplied by the cost factor of the job's type
+extern double jeeves_scheduler_job_cost (
+	const struct JeevesJob *job
+);
+
+// the job with the lowest score is the next one to run
+// with SJF, every second a job waits its cost is reduced
+// by JOBS_SCHEDULER_AGING to prevent big jobs from starving
+extern double jeeves_scheduler_job_score (
+	const double cost, const time_t queued, const time_t now
+);
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef _JEEVES_STORAGE_H_
+#define _JEEVES_STORAGE_H_
+
+#include <stdbool.h>
+
+#include <bson/bson.h>
+
+#include <cerver/types/types.h>
+#include <cerver/types/string.h>
+
+#include <cerver/collections/dlist.h>
+
+#include "models/job.h"
+#include "models/role.h"
+#include "models/user.h"
+
+#define JEEVES_STORAGE_MAP(XX)					\
+	XX(0,	NONE, 			None)				\
+	XX(1,	MONGO, 			Mongo)				\
+	XX(2,	MEMORY, 		Memory)
+
+typedef enum JeevesStorageType {
+
+	#define XX(num, name, string) JEEVES_STORAGE_##name = num,
+	JEEVES_STORAGE_MAP (XX)
+	#undef XX
+
+} JeevesStorageType;
+
+extern const char *jeeves_storage_type_to_string (
+	const JeevesStorageType type
+);
+
+extern JeevesStorageType jeeves_storage_type_from_string (
+	const char *string
+);
+
+// the operations that controllers & the worker need from a backend
+// every backend must keep the same return values as the models
+typedef struct JeevesStorage {
+
+	JeevesStorageType type;
+
+	// roles
+	unsigned int (*roles_get_all) (
+		bool (*each)(void *data, const Role *role), void *data
+	);
+
+	// users
+	u8 (*user_check_by_email) (const char *email);
+
+	u8 (*user_get_by_email) (
+		User *user, const char *email, const bson_t *query_opts
+	);
+
+	unsigned int (*user_insert_one) (const User *user);
+
+	// jobs
+	u8 (*job_get_by_oid_and_user) (
+		JeevesJob *job,
+		const bson_oid_t *oid, const bson_oid_t *user_oid,
+		const bson_t *query_opts
+	);
+
+	u8 (*job_get_images) (
+		JeevesJob *job, const bson_t *query_opts
+	);
+
+	unsigned int (*job_get_by_oid_and_user_each) (
+		const bson_oid_t *oid, const bson_oid_t *user_oid,
+		const bson_t *query_opts,
+		bool (*each)(void *data, const bson_t *job_doc), void *data
+	);
+
+	u8 (*job_get_by_oid_and_user_to_json) (
+		const bson_oid_t *oid, const bson_oid_t *user_oid,
+		const bson_t *query_opts,
+		JeevesJson *json
+	);
+
+	unsigned int (*jobs_get_page_by_user) (
+		const bson_oid_t *user_oid, const bson_t *opts,
+		const JobsPage *page,
+		bool (*each)(void *data, const bson_t *job_doc), void *data
+	);
+
+	unsigned int (*job_get_images_page) (
+		const bson_oid_t *job_oid, const bson_oid_t *user_oid,
+		const JobImagesPage *page,
+		bool (*each)(void *data, const JobImage *job_image), void *data
+	);
+
+	unsigned int (*job_insert_one) (const JeevesJob *job);
+
+	unsigned int (*job_update_status) (
+		const JeevesJob *job, const JobStatus status
+	);
+
+	unsigned int (*job_update_images) (
+		const JeevesJob *job, DoubleList *images
+	);
+
+	unsigned int (*job_update_image_result) (
+		const bson_oid_t *job_oid, const int image_id,
+		const char *result
+	);
+
+	unsigned int (*job_transition_start) (
+		JeevesJob *job, const bson_oid_t *user_oid,
+		const bson_t *query_opts
+	);
+
+	unsigned int (*job_transition_stop) (
+		JeevesJob *job, const bson_oid_t *user_oid,
+		const bson_t *query_opts
+	);
+
+	unsigned int (*job_transition_end) (
+		JeevesJob *job, const bson_t *query_opts
+	);
+
+	unsigned int (*job_transition_ready) (
+		JeevesJob *job, const bson_t *query_opts
+	);
+
+	unsigned int (*job_transition_config) (
+		JeevesJob *job, const bson_oid_t *user_oid,
+		const bool set_autostart,
+		const bson_t *query_opts
+	);
+
+} JeevesStorage;
+
+// the backend selected with STORAGE_BACKEND
+extern const JeevesStorage *jeeves_storage;
+
+#endif
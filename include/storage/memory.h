@@ -0,0 +1,18 @@
+#ifndef _JEEVES_STORAGE_MEMORY_H_
+#define _JEEVES_STORAGE_MEMORY_H_
+
+#include "storage.h"
+
+#define JEEVES_STORAGE_MEMORY_BUCKETS		4096
+#define JEEVES_STORAGE_MEMORY_ROLES			8
+
+// keeps every value in process memory
+// to be able to benchmark jeeves without a db
+extern const JeevesStorage jeeves_storage_memory;
+
+// creates the default roles
+extern unsigned int jeeves_storage_memory_init (void);
+
+extern void jeeves_storage_memory_end (void);
+
+#endif
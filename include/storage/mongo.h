@@ -0,0 +1,9 @@
+#ifndef _JEEVES_STORAGE_MONGO_H_
+#define _JEEVES_STORAGE_MONGO_H_
+
+#include "storage.h"
+
+// the models as they work with cmongo
+extern const JeevesStorage jeeves_storage_mongo;
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef _JEEVES_STREAM_H_
+#define _JEEVES_STREAM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <sys/types.h>
+
+#define JEEVES_STREAM_CHUNK_SIZE		16384
+
+struct _HttpReceive;
+
+// writes the data directly into the connection's socket
+extern unsigned int jeeves_stream_send (
+	const struct _HttpReceive *http_receive,
+	const void *data, const size_t data_len
+);
+
+// writes a range of the file into the connection's socket
+// without copying its contents through userspace
+extern unsigned int jeeves_stream_sendfile (
+	const struct _HttpReceive *http_receive,
+	const int fd, const off_t offset, const size_t len
+);
+
+// sends the response with its content length
+// & Vary: Accept as its body's format was negotiated
+extern unsigned int jeeves_stream_send_response (
+	const struct _HttpReceive *http_receive,
+	const char *status, const char *content_type,
+	const void *data, const size_t data_len
+);
+
+// buffers the data & writes it as HTTP/1.1 chunks
+// the response headers are only sent with the first chunk
+// & they also vary on the request's Accept header
+typedef struct JeevesStreamChunked {
+
+	const struct _HttpReceive *http_receive;
+
+	const char *status;
+	const char *content_type;
+	bool started;
+
+	unsigned int error;
+
+	size_t len;
+	char buffer[JEEVES_STREAM_CHUNK_SIZE];
+
+} JeevesStreamChunked;
+
+extern void jeeves_stream_chunked_init (
+	JeevesStreamChunked *chunked,
+	const struct _HttpReceive *http_receive,
+	const char *status, const char *content_type
+);
+
+// returns 0 on success, 1 if the client is gone
+extern unsigned int jeeves_stream_chunked_write (
+	JeevesStreamChunked *chunked,
+	const void *data, const size_t data_len
+);
+
+// sends any buffered data & the last chunk
+extern unsigned int jeeves_stream_chunked_end (
+	JeevesStreamChunked *chunked
+);
+
+#endif
@@ -10,12 +10,28 @@
 
 #pragma region jobs
 
-// returns TRUE if the job is currently being running
+// how many of the next job's images are read ahead
+// while the current one is being processed
+#define JEEVES_JOBS_WORKER_PREFETCH			4
+
+// returns TRUE if the job is currently queued or running
 extern bool jeeves_jobs_worker_check (const bson_oid_t *job_oid);
 
+// removes the user's job if it has not been picked by a worker
+// returns 0 if the job was removed, 1 if not
+extern unsigned int jeeves_jobs_worker_dequeue (
+	const bson_oid_t *job_oid, const bson_oid_t *user_oid
+);
+
+// signals the worker to stop processing the job
+// returns 0 if the job is running, 1 if not
+extern unsigned int jeeves_jobs_worker_stop (const bson_oid_t *job_oid);
+
 // a user has requested to start a new job
-// so create a dedicated job & process job's images
+// so queue the job to be processed by the jobs worker
 // with selected configuration
+// the job stays READY until a worker picks it up
+// returns 1 if the job is already queued or running
 extern u8 jeeves_jobs_worker_create (JeevesJob *job);
 
 #pragma endregion
@@ -30,12 +46,22 @@ typedef struct JeevesUpload {
 	char dirname[JEEVES_UPLOAD_DIRNAME_SIZE];
 	char user_id[JEEVES_UPLOAD_USER_ID_SIZE];
 
+	// uploaded images with their hashes
+	// to be added to the blob store
+	DoubleList *images;
+
 } JeevesUpload;
 
 extern JeevesUpload *jeeves_upload_new (
 	const char *dirname, const char *user_id
 );
 
+// adds a saved image that will be stored in the blob store
+// after it has been moved into persistent storage
+extern unsigned int jeeves_upload_add_image (
+	JeevesUpload *upload, const JobImage *job_image
+);
+
 extern void jeeves_upload_delete (
 	void *jeeves_upload_ptr
 );
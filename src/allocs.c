@@ -0,0 +1,96 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <stdatomic.h>
+
+#include <bson/bson.h>
+
+#include <cerver/utils/log.h>
+
+#include "allocs.h"
+
+static atomic_size_t allocs_mallocs = 0;
+static atomic_size_t allocs_callocs = 0;
+static atomic_size_t allocs_reallocs = 0;
+static atomic_size_t allocs_frees = 0;
+static atomic_size_t allocs_bytes = 0;
+
+static void *jeeves_allocs_malloc (size_t num_bytes) {
+
+	(void) atomic_fetch_add_explicit (&allocs_mallocs, 1, memory_order_relaxed);
+	(void) atomic_fetch_add_explicit (&allocs_bytes, num_bytes, memory_order_relaxed);
+
+	return malloc (num_bytes);
+
+}
+
+static void *jeeves_allocs_calloc (size_t n_members, size_t num_bytes) {
+
+	(void) atomic_fetch_add_explicit (&allocs_callocs, 1, memory_order_relaxed);
+	(void) atomic_fetch_add_explicit (&allocs_bytes, n_members * num_bytes, memory_order_relaxed);
+
+	return calloc (n_members, num_bytes);
+
+}
+
+static void *jeeves_allocs_realloc (void *mem, size_t num_bytes) {
+
+	(void) atomic_fetch_add_explicit (&allocs_reallocs, 1, memory_order_relaxed);
+	(void) atomic_fetch_add_explicit (&allocs_bytes, num_bytes, memory_order_relaxed);
+
+	return realloc (mem, num_bytes);
+
+}
+
+static void jeeves_allocs_free (void *mem) {
+
+	if (mem) {
+		(void) atomic_fetch_add_explicit (&allocs_frees, 1, memory_order_relaxed);
+	}
+
+	free (mem);
+
+}
+
+// counts every allocation made by libbson & mongoc
+// must be called before any bson is created
+void jeeves_allocs_init (void) {
+
+	static const bson_mem_vtable_t vtable = {
+		jeeves_allocs_malloc,
+		jeeves_allocs_calloc,
+		jeeves_allocs_realloc,
+		jeeves_allocs_free,
+		{ 0 }
+	};
+
+	bson_mem_set_vtable (&vtable);
+
+}
+
+// gets a snapshot of the current counters
+void jeeves_allocs_get (JeevesAllocs *allocs) {
+
+	if (allocs) {
+		allocs->mallocs = atomic_load_explicit (&allocs_mallocs, memory_order_relaxed);
+		allocs->callocs = atomic_load_explicit (&allocs_callocs, memory_order_relaxed);
+		allocs->reallocs = atomic_load_explicit (&allocs_reallocs, memory_order_relaxed);
+		allocs->frees = atomic_load_explicit (&allocs_frees, memory_order_relaxed);
+		allocs->bytes = atomic_load_explicit (&allocs_bytes, memory_order_relaxed);
+	}
+
+}
+
+void jeeves_allocs_print (void) {
+
+	JeevesAllocs allocs = { 0 };
+	jeeves_allocs_get (&allocs);
+
+	cerver_log_msg ("\nBSON allocations:\n");
+	cerver_log_msg ("Mallocs: %zu\n", allocs.mallocs);
+	cerver_log_msg ("Callocs: %zu\n", allocs.callocs);
+	cerver_log_msg ("Reallocs: %zu\n", allocs.reallocs);
+	cerver_log_msg ("Frees: %zu\n", allocs.frees);
+	cerver_log_msg ("Requested bytes: %zu\n", allocs.bytes);
+
+}
@@ -0,0 +1,294 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <stdint.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <cerver/utils/log.h>
+
+#include "arena.h"
+
+#define ARENA_ALIGN						(_Alignof (max_align_t))
+
+typedef struct ArenaBlock {
+
+	struct ArenaBlock *next;
+
+	size_t size;
+	size_t used;
+
+	max_align_t data[];
+
+} ArenaBlock;
+
+typedef struct JeevesArena {
+
+	ArenaBlock *blocks;
+	ArenaBlock *current;
+
+	// bytes & values used by the current request
+	size_t used;
+	size_t allocs;
+
+	bool active;
+
+} JeevesArena;
+
+static pthread_key_t arena_thread_key;
+static pthread_once_t arena_thread_once = PTHREAD_ONCE_INIT;
+
+static _Thread_local JeevesArena *arena_thread = NULL;
+
+static atomic_size_t arena_requests = 0;
+static atomic_size_t arena_allocs = 0;
+static atomic_size_t arena_bytes = 0;
+static atomic_size_t arena_blocks = 0;
+static atomic_size_t arena_max_used = 0;
+static atomic_size_t arena_max_allocs = 0;
+
+static void jeeves_arena_thread_delete (void *arena_ptr) {
+
+	JeevesArena *arena = (JeevesArena *) arena_ptr;
+
+	ArenaBlock *block = arena->blocks;
+	while (block) {
+		ArenaBlock *next = block->next;
+		free (block);
+		block = next;
+	}
+
+	free (arena);
+
+}
+
+static void jeeves_arena_thread_key_create (void) {
+
+	(void) pthread_key_create (&arena_thread_key, jeeves_arena_thread_delete);
+
+}
+
+// gets the calling thread's arena
+static JeevesArena *jeeves_arena_thread (void) {
+
+	if (!arena_thread) {
+		(void) pthread_once (&arena_thread_once, jeeves_arena_thread_key_create);
+
+		arena_thread = (JeevesArena *) calloc (1, sizeof (JeevesArena));
+		if (arena_thread) (void) pthread_setspecific (arena_thread_key, arena_thread);
+	}
+
+	return arena_thread;
+
+}
+
+static ArenaBlock *arena_block_new (const size_t size) {
+
+	ArenaBlock *block = (ArenaBlock *) malloc (sizeof (ArenaBlock) + size);
+	if (block) {
+		block->next = NULL;
+		block->size = size;
+		block->used = 0;
+
+		(void) atomic_fetch_add_explicit (&arena_blocks, 1, memory_order_relaxed);
+	}
+
+	return block;
+
+}
+
+// bumps the current block or moves to the next one
+static void *arena_alloc (JeevesArena *arena, size_t size) {
+
+	void *ptr = NULL;
+
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+	ArenaBlock *block = arena->current;
+	while (block && ((block->used + size) > block->size)) {
+		block = block->next;
+	}
+
+	if (!block) {
+		block = arena_block_new (
+			(size > JEEVES_ARENA_BLOCK_SIZE) ? size : JEEVES_ARENA_BLOCK_SIZE
+		);
+
+		if (block) {
+			// the blocks that were skipped keep their space for the next request
+			if (arena->current) {
+				ArenaBlock *last = arena->current;
+				while (last->next) last = last->next;
+				last->next = block;
+			}
+
+			else {
+				arena->blocks = block;
+			}
+		}
+	}
+
+	if (block) {
+		ptr = (unsigned char *) block->data + block->used;
+		block->used += size;
+
+		arena->current = block;
+		arena->used += size;
+		arena->allocs += 1;
+
+		(void) atomic_fetch_add_explicit (&arena_allocs, 1, memory_order_relaxed);
+		(void) atomic_fetch_add_explicit (&arena_bytes, size, memory_order_relaxed);
+	}
+
+	return ptr;
+
+}
+
+static void arena_reset (JeevesArena *arena) {
+
+	// a single huge request should not be kept forever
+	size_t kept = 0;
+	ArenaBlock **link = &arena->blocks;
+	while (*link) {
+		ArenaBlock *block = *link;
+		if (kept && ((kept + block->size) > JEEVES_ARENA_KEEP_SIZE)) {
+			*link = block->next;
+			free (block);
+		}
+
+		else {
+			kept += block->size;
+			block->used = 0;
+			link = &block->next;
+		}
+	}
+
+	arena->current = arena->blocks;
+	arena->used = 0;
+	arena->allocs = 0;
+
+}
+
+// starts the calling thread's request scope
+// every value from the arena is valid until the scope ends
+void jeeves_arena_request_begin (void) {
+
+	JeevesArena *arena = jeeves_arena_thread ();
+	if (arena) {
+		arena->active = true;
+
+		(void) atomic_fetch_add_explicit (&arena_requests, 1, memory_order_relaxed);
+	}
+
+}
+
+static void arena_max (atomic_size_t *max, const size_t value) {
+
+	size_t max_seen = atomic_load_explicit (max, memory_order_relaxed);
+	while (
+		(value > max_seen)
+		&& !atomic_compare_exchange_weak_explicit (
+			max, &max_seen, value,
+			memory_order_relaxed, memory_order_relaxed
+		)
+	);
+
+}
+
+// releases every value of the request at once
+void jeeves_arena_request_end (void) {
+
+	JeevesArena *arena = arena_thread;
+	if (arena && arena->active) {
+		arena_max (&arena_max_used, arena->used);
+		arena_max (&arena_max_allocs, arena->allocs);
+
+		arena_reset (arena);
+
+		arena->active = false;
+	}
+
+}
+
+// returns true if the calling thread is handling a request
+bool jeeves_arena_request_active (void) {
+
+	return arena_thread && arena_thread->active;
+
+}
+
+// returns true if the value was taken from the calling thread's
+// arena & is going to be released when its request ends
+bool jeeves_arena_owns (const void *ptr) {
+
+	bool retval = false;
+
+	JeevesArena *arena = arena_thread;
+	if (ptr && arena && arena->active) {
+		const uintptr_t address = (uintptr_t) ptr;
+		for (const ArenaBlock *block = arena->blocks; block; block = block->next) {
+			const uintptr_t start = (uintptr_t) block->data;
+			if ((address >= start) && (address < (start + block->used))) {
+				retval = true;
+				break;
+			}
+		}
+	}
+
+	return retval;
+
+}
+
+// returns zeroed memory that lives until the request ends
+// returns NULL if there is no active request or on error
+void *jeeves_arena_calloc (const size_t size) {
+
+	void *ptr = NULL;
+
+	JeevesArena *arena = arena_thread;
+	if (arena && arena->active) {
+		ptr = arena_alloc (arena, size);
+		if (ptr) (void) memset (ptr, 0, size);
+	}
+
+	return ptr;
+
+}
+
+// gets a snapshot of the current counters
+void jeeves_arena_stats (JeevesArenaStats *stats) {
+
+	if (stats) {
+		stats->requests = atomic_load_explicit (&arena_requests, memory_order_relaxed);
+		stats->allocs = atomic_load_explicit (&arena_allocs, memory_order_relaxed);
+		stats->bytes = atomic_load_explicit (&arena_bytes, memory_order_relaxed);
+		stats->blocks = atomic_load_explicit (&arena_blocks, memory_order_relaxed);
+		stats->max_used = atomic_load_explicit (&arena_max_used, memory_order_relaxed);
+		stats->max_allocs = atomic_load_explicit (&arena_max_allocs, memory_order_relaxed);
+	}
+
+}
+
+void jeeves_arena_print (void) {
+
+	JeevesArenaStats stats = { 0 };
+	jeeves_arena_stats (&stats);
+
+	cerver_log_msg ("\nRequests arenas:\n");
+	cerver_log_msg ("Requests: %zu\n", stats.requests);
+	cerver_log_msg ("Allocs: %zu\n", stats.allocs);
+	cerver_log_msg ("Bytes: %zu\n", stats.bytes);
+	cerver_log_msg ("Blocks mallocs: %zu\n", stats.blocks);
+	cerver_log_msg ("Max request bytes: %zu\n", stats.max_used);
+	cerver_log_msg ("Max request allocs: %zu\n", stats.max_allocs);
+
+	if (stats.requests) {
+		cerver_log_msg (
+			"Allocs per request: %.2f\n",
+			(double) stats.allocs / (double) stats.requests
+		);
+	}
+
+}
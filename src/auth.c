@@ -0,0 +1,399 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include <openssl/evp.h>
+
+#include <cerver/types/string.h>
+
+#include <cerver/http/http.h>
+#include <cerver/http/request.h>
+#include <cerver/http/route.h>
+
+#include <cerver/utils/log.h>
+
+#include "auth.h"
+
+#include "controllers/users.h"
+
+#include "models/user.h"
+
+// sha256 of the token
+#define AUTH_KEY_SIZE					32
+
+#define AUTH_BEARER						"Bearer "
+#define AUTH_BEARER_LEN					(sizeof (AUTH_BEARER) - 1)
+
+typedef struct AuthEntry {
+
+	// first so that the request's user is also its entry
+	User user;
+
+	unsigned char key[AUTH_KEY_SIZE];
+	time_t expires;
+
+	// one for the cache & one for each request using it
+	atomic_uint refs;
+
+	// bucket chain
+	struct AuthEntry *next;
+
+	// insertion order list - the oldest entries expire first
+	struct AuthEntry *older;
+	struct AuthEntry *newer;
+
+} AuthEntry;
+
+typedef struct AuthShard {
+
+	AuthEntry *buckets[JEEVES_AUTH_BUCKETS];
+
+	AuthEntry *oldest;
+	AuthEntry *newest;
+
+	size_t entries;
+
+	pthread_mutex_t mutex;
+
+} AuthShard;
+
+static struct {
+
+	unsigned int ttl;
+	size_t max_shard_entries;
+
+	AuthShard *shards;
+
+} auth = { 0 };
+
+static atomic_size_t auth_hits = 0;
+static atomic_size_t auth_misses = 0;
+static atomic_size_t auth_failures = 0;
+static atomic_size_t auth_inserts = 0;
+static atomic_size_t auth_evictions = 0;
+static atomic_size_t auth_expirations = 0;
+
+static inline size_t auth_key_bucket (const unsigned char *key) {
+
+	return ((size_t) key[1] | ((size_t) key[2] << 8)) & (JEEVES_AUTH_BUCKETS - 1);
+
+}
+
+static inline AuthShard *auth_key_shard (const unsigned char *key) {
+
+	return &auth.shards[key[0] & (JEEVES_AUTH_SHARDS - 1)];
+
+}
+
+static void auth_entry_release (AuthEntry *entry) {
+
+	if (atomic_fetch_sub_explicit (&entry->refs, 1, memory_order_acq_rel) == 1) {
+		free (entry);
+	}
+
+}
+
+// called by cerver when the request is done with the user
+static void jeeves_auth_user_delete (void *user_ptr) {
+
+	if (user_ptr) auth_entry_release ((AuthEntry *) user_ptr);
+
+}
+
+// removes the entry from the shard & drops the cache's reference
+static void auth_shard_remove (AuthShard *shard, AuthEntry *entry) {
+
+	AuthEntry **link = &shard->buckets[auth_key_bucket (entry->key)];
+	while (*link && (*link != entry)) link = &(*link)->next;
+	if (*link) *link = entry->next;
+
+	if (entry->older) entry->older->newer = entry->newer;
+	else shard->oldest = entry->newer;
+
+	if (entry->newer) entry->newer->older = entry->older;
+	else shard->newest = entry->older;
+
+	shard->entries -= 1;
+
+	auth_entry_release (entry);
+
+}
+
+static void auth_shard_expire (AuthShard *shard, const time_t now) {
+
+	while (shard->oldest && (shard->oldest->expires <= now)) {
+		auth_shard_remove (shard, shard->oldest);
+		(void) atomic_fetch_add_explicit (&auth_expirations, 1, memory_order_relaxed);
+	}
+
+}
+
+// returns a referenced entry or NULL
+// expects the shard to be locked
+static AuthEntry *auth_shard_get (
+	AuthShard *shard, const unsigned char *key, const time_t now
+) {
+
+	auth_shard_expire (shard, now);
+
+	AuthEntry *entry = shard->buckets[auth_key_bucket (key)];
+	while (entry && memcmp (entry->key, key, AUTH_KEY_SIZE)) entry = entry->next;
+
+	if (entry) {
+		(void) atomic_fetch_add_explicit (&entry->refs, 1, memory_order_relaxed);
+	}
+
+	return entry;
+
+}
+
+// stores the new entry unless another request already did
+// returns the referenced entry to be used by the request
+static AuthEntry *auth_shard_put (
+	AuthShard *shard, AuthEntry *entry, const time_t now
+) {
+
+	(void) pthread_mutex_lock (&shard->mutex);
+
+	AuthEntry *existing = auth_shard_get (shard, entry->key, now);
+	if (!existing) {
+		while (shard->oldest && (shard->entries >= auth.max_shard_entries)) {
+			auth_shard_remove (shard, shard->oldest);
+			(void) atomic_fetch_add_explicit (&auth_evictions, 1, memory_order_relaxed);
+		}
+
+		AuthEntry **bucket = &shard->buckets[auth_key_bucket (entry->key)];
+		entry->next = *bucket;
+		*bucket = entry;
+
+		entry->older = shard->newest;
+		entry->newer = NULL;
+		if (shard->newest) shard->newest->newer = entry;
+		else shard->oldest = entry;
+		shard->newest = entry;
+
+		shard->entries += 1;
+
+		(void) atomic_fetch_add_explicit (&auth_inserts, 1, memory_order_relaxed);
+	}
+
+	(void) pthread_mutex_unlock (&shard->mutex);
+
+	if (existing) {
+		free (entry);
+		entry = existing;
+	}
+
+	return entry;
+
+}
+
+// decodes the verified token's payload into a new entry
+static void *jeeves_auth_entry_decode (void *user_json_ptr) {
+
+	AuthEntry *entry = (AuthEntry *) calloc (1, sizeof (AuthEntry));
+	if (entry) {
+		if (jeeves_user_parse_json (&entry->user, user_json_ptr)) {
+			free (entry);
+			entry = NULL;
+		}
+	}
+
+	return entry;
+
+}
+
+// verifies the token & decodes its user only if they are not cached
+// returns 0 on success, 1 on error
+static unsigned int jeeves_auth_handler (
+	const HttpReceive *http_receive, const HttpRequest *request
+) {
+
+	unsigned int retval = 1;
+
+	const String *authorization = http_request_get_header (
+		request, HTTP_HEADER_AUTHORIZATION
+	);
+
+	if (
+		authorization && (authorization->len > AUTH_BEARER_LEN)
+		&& !strncmp (authorization->str, AUTH_BEARER, AUTH_BEARER_LEN)
+	) {
+		const char *token = authorization->str + AUTH_BEARER_LEN;
+
+		unsigned char key[AUTH_KEY_SIZE] = { 0 };
+		if (EVP_Digest (
+			token, authorization->len - AUTH_BEARER_LEN,
+			key, NULL, EVP_sha256 (), NULL
+		)) {
+			AuthShard *shard = auth_key_shard (key);
+			const time_t now = time (NULL);
+
+			(void) pthread_mutex_lock (&shard->mutex);
+			AuthEntry *entry = auth_shard_get (shard, key, now);
+			(void) pthread_mutex_unlock (&shard->mutex);
+
+			if (entry) {
+				(void) atomic_fetch_add_explicit (&auth_hits, 1, memory_order_relaxed);
+			}
+
+			else {
+				(void) atomic_fetch_add_explicit (&auth_misses, 1, memory_order_relaxed);
+
+				void *decoded = NULL;
+				if (http_cerver_auth_validate_jwt (
+					http_receive->http_cerver, token,
+					jeeves_auth_entry_decode, &decoded
+				) && decoded) {
+					entry = (AuthEntry *) decoded;
+					(void) memcpy (entry->key, key, AUTH_KEY_SIZE);
+					entry->expires = now + (time_t) auth.ttl;
+					atomic_init (&entry->refs, 2);
+
+					entry = auth_shard_put (shard, entry, now);
+				}
+
+				else {
+					free (decoded);
+				}
+			}
+
+			if (entry) {
+				http_request_set_decoded_data ((HttpRequest *) request, &entry->user);
+				http_request_set_delete_decoded_data (
+					(HttpRequest *) request, jeeves_auth_user_delete
+				);
+
+				retval = 0;
+			}
+		}
+	}
+
+	if (retval) {
+		(void) atomic_fetch_add_explicit (&auth_failures, 1, memory_order_relaxed);
+	}
+
+	return retval;
+
+}
+
+// caches the users decoded from verified tokens
+// a ttl of 0 verifies every token in cerver
+unsigned int jeeves_auth_init (
+	const unsigned int ttl, const size_t max_entries
+) {
+
+	unsigned int retval = 1;
+
+	if (!ttl) {
+		cerver_log_warning ("Auth cache is disabled - every token will be verified!");
+		retval = 0;
+	}
+
+	else {
+		auth.shards = (AuthShard *) calloc (JEEVES_AUTH_SHARDS, sizeof (AuthShard));
+		if (auth.shards) {
+			for (unsigned int i = 0; i < JEEVES_AUTH_SHARDS; i++) {
+				(void) pthread_mutex_init (&auth.shards[i].mutex, NULL);
+			}
+
+			auth.ttl = ttl;
+			auth.max_shard_entries = max_entries / JEEVES_AUTH_SHARDS;
+			if (!auth.max_shard_entries) auth.max_shard_entries = 1;
+
+			cerver_log_success (
+				"Auth cache keeps up to %zu users for %us!",
+				auth.max_shard_entries * JEEVES_AUTH_SHARDS, auth.ttl
+			);
+
+			retval = 0;
+		}
+
+		else {
+			cerver_log_error ("Failed to create auth cache!");
+		}
+	}
+
+	return retval;
+
+}
+
+void jeeves_auth_end (void) {
+
+	if (auth.shards) {
+		for (unsigned int i = 0; i < JEEVES_AUTH_SHARDS; i++) {
+			AuthShard *shard = &auth.shards[i];
+
+			(void) pthread_mutex_lock (&shard->mutex);
+			while (shard->oldest) auth_shard_remove (shard, shard->oldest);
+			(void) pthread_mutex_unlock (&shard->mutex);
+
+			(void) pthread_mutex_destroy (&shard->mutex);
+		}
+
+		free (auth.shards);
+		auth.shards = NULL;
+	}
+
+	auth.ttl = 0;
+
+}
+
+// sets the route to be authenticated with bearer tokens
+// the request's decoded data is an immutable User
+void jeeves_auth_route_set (HttpRoute *route) {
+
+	if (auth.ttl) {
+		http_route_set_auth (route, HTTP_ROUTE_AUTH_TYPE_CUSTOM);
+		http_route_set_authentication_handler (route, jeeves_auth_handler);
+	}
+
+	else {
+		http_route_set_auth (route, HTTP_ROUTE_AUTH_TYPE_BEARER);
+		http_route_set_decode_data (route, jeeves_user_parse_from_json, jeeves_user_delete);
+	}
+
+}
+
+void jeeves_auth_stats (JeevesAuthStats *stats) {
+
+	if (stats) {
+		stats->hits = atomic_load_explicit (&auth_hits, memory_order_relaxed);
+		stats->misses = atomic_load_explicit (&auth_misses, memory_order_relaxed);
+		stats->failures = atomic_load_explicit (&auth_failures, memory_order_relaxed);
+		stats->inserts = atomic_load_explicit (&auth_inserts, memory_order_relaxed);
+		stats->evictions = atomic_load_explicit (&auth_evictions, memory_order_relaxed);
+		stats->expirations = atomic_load_explicit (&auth_expirations, memory_order_relaxed);
+
+		stats->entries = 0;
+		if (auth.shards) {
+			for (unsigned int i = 0; i < JEEVES_AUTH_SHARDS; i++) {
+				(void) pthread_mutex_lock (&auth.shards[i].mutex);
+				stats->entries += auth.shards[i].entries;
+				(void) pthread_mutex_unlock (&auth.shards[i].mutex);
+			}
+		}
+	}
+
+}
+
+void jeeves_auth_print (void) {
+
+	JeevesAuthStats stats = { 0 };
+	jeeves_auth_stats (&stats);
+
+	cerver_log_msg ("\nAuth cache:\n");
+	cerver_log_msg ("TTL: %us\n", auth.ttl);
+	cerver_log_msg ("Entries: %zu\n", stats.entries);
+	cerver_log_msg ("Hits: %zu\n", stats.hits);
+	cerver_log_msg ("Misses: %zu\n", stats.misses);
+	cerver_log_msg ("Failures: %zu\n", stats.failures);
+	cerver_log_msg ("Inserts: %zu\n", stats.inserts);
+	cerver_log_msg ("Evictions: %zu\n", stats.evictions);
+	cerver_log_msg ("Expirations: %zu\n", stats.expirations);
+
+}
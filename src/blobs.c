@@ -0,0 +1,159 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+
+#include <cerver/files.h>
+
+#include <cerver/utils/log.h>
+
+#include "blobs.h"
+#include "jeeves.h"
+
+#define JEEVES_BLOB_READ_SIZE			65536
+
+unsigned int jeeves_blobs_init (void) {
+
+	(void) files_create_dir (JEEVES_UPLOADS_BLOBS_DIR, 0777);
+
+	return 0;
+
+}
+
+static void jeeves_blob_hash_to_string (
+	const unsigned char *digest, const unsigned int digest_len,
+	char *hash
+) {
+
+	static const char hex[] = "0123456789abcdef";
+
+	for (unsigned int i = 0; i < digest_len; i++) {
+		hash[i * 2] = hex[digest[i] >> 4];
+		hash[i * 2 + 1] = hex[digest[i] & 0x0F];
+	}
+
+	hash[digest_len * 2] = '\0';
+
+}
+
+// generates the file's sha256 hex digest
+// returns 0 on success, 1 on error
+unsigned int jeeves_blob_hash_file (
+	const char *filename, char *hash
+) {
+
+	unsigned int retval = 1;
+
+	int fd = open (filename, O_RDONLY);
+	if (fd >= 0) {
+		EVP_MD_CTX *ctx = EVP_MD_CTX_new ();
+		if (ctx) {
+			if (EVP_DigestInit_ex (ctx, EVP_sha256 (), NULL)) {
+				char buffer[JEEVES_BLOB_READ_SIZE];
+				ssize_t n_read = 0;
+				while ((n_read = read (fd, buffer, JEEVES_BLOB_READ_SIZE)) > 0) {
+					(void) EVP_DigestUpdate (ctx, buffer, (size_t) n_read);
+				}
+
+				unsigned char digest[EVP_MAX_MD_SIZE] = { 0 };
+				unsigned int digest_len = 0;
+				if (!n_read && EVP_DigestFinal_ex (ctx, digest, &digest_len)) {
+					jeeves_blob_hash_to_string (digest, digest_len, hash);
+					retval = 0;
+				}
+			}
+
+			EVP_MD_CTX_free (ctx);
+		}
+
+		(void) close (fd);
+	}
+
+	return retval;
+
+}
+
+// generates the blob's location in the store
+void jeeves_blob_path (
+	const char *hash, char *path
+) {
+
+	(void) snprintf (
+		path, JEEVES_BLOB_PATH_SIZE,
+		"%s/%.2s/%s",
+		JEEVES_UPLOADS_BLOBS_DIR, hash, hash
+	);
+
+}
+
+// replaces the file with a hard link to the existing blob
+// the link is created with a temporary name & then renamed
+static unsigned int jeeves_blob_store_link (
+	const char *filename, const char *blob
+) {
+
+	unsigned int retval = 1;
+
+	char temp[JEEVES_BLOB_PATH_SIZE] = { 0 };
+	(void) snprintf (temp, JEEVES_BLOB_PATH_SIZE, "%s.blob", filename);
+
+	if (!link (blob, temp)) {
+		if (!rename (temp, filename)) {
+			retval = 0;
+		}
+
+		else {
+			(void) unlink (temp);
+		}
+	}
+
+	return retval;
+
+}
+
+// stores the file in the content addressed blob store
+// if the blob already exists, the file is replaced by a hard link
+// to the stored blob, so every copy shares the same disk blocks
+unsigned int jeeves_blob_store (
+	const char *filename, const char *hash
+) {
+
+	unsigned int retval = 1;
+
+	if (filename && hash && hash[0]) {
+		char blob[JEEVES_BLOB_PATH_SIZE] = { 0 };
+		(void) snprintf (
+			blob, JEEVES_BLOB_PATH_SIZE,
+			"%s/%.2s", JEEVES_UPLOADS_BLOBS_DIR, hash
+		);
+
+		(void) files_create_dir (blob, 0777);
+
+		jeeves_blob_path (hash, blob);
+
+		// first copy becomes the blob itself
+		if (!link (filename, blob)) {
+			retval = 0;
+		}
+
+		else if (errno == EEXIST) {
+			#ifdef JEEVES_DEBUG
+			cerver_log_debug ("Blob %s already exists", hash);
+			#endif
+
+			retval = jeeves_blob_store_link (filename, blob);
+		}
+
+		if (retval) {
+			cerver_log_error ("Failed to store %s blob!", hash);
+		}
+	}
+
+	return retval;
+
+}
@@ -0,0 +1,566 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cerver/types/string.h>
+
+#include "body.h"
+
+typedef struct BodyParser {
+
+	const char *cur;
+	const char *end;
+
+} BodyParser;
+
+// where a string is being unescaped
+// a NULL buffer only validates the string
+typedef struct BodyString {
+
+	char *buffer;
+	size_t size;
+	size_t len;
+
+	bool truncated;
+
+} BodyString;
+
+static bool body_parse_value (
+	BodyParser *parser, const unsigned int depth
+);
+
+static inline void body_skip_whitespace (BodyParser *parser) {
+
+	while (
+		(parser->cur < parser->end)
+		&& (
+			(*parser->cur == ' ') || (*parser->cur == '\t')
+			|| (*parser->cur == '\n') || (*parser->cur == '\r')
+		)
+	) parser->cur++;
+
+}
+
+static inline bool body_expect (BodyParser *parser, const char c) {
+
+	bool retval = false;
+
+	if ((parser->cur < parser->end) && (*parser->cur == c)) {
+		parser->cur++;
+		retval = true;
+	}
+
+	return retval;
+
+}
+
+// ascii runs can be cut anywhere
+// encoded characters are only written if they fit whole
+static void body_string_write (
+	BodyString *string,
+	const char *data, const size_t data_len, const bool splittable
+) {
+
+	if (string->buffer && !string->truncated) {
+		if ((string->len + data_len) < string->size) {
+			(void) memcpy (string->buffer + string->len, data, data_len);
+			string->len += data_len;
+		}
+
+		else {
+			if (splittable && ((string->len + 1) < string->size)) {
+				const size_t n = string->size - 1 - string->len;
+				(void) memcpy (string->buffer + string->len, data, n);
+				string->len += n;
+			}
+
+			string->truncated = true;
+		}
+	}
+
+}
+
+static size_t body_utf8_encode (const uint32_t code, char *encoded) {
+
+	size_t len = 0;
+
+	if (code < 0x80) {
+		encoded[len++] = (char) code;
+	}
+
+	else if (code < 0x800) {
+		encoded[len++] = (char) (0xC0 | (code >> 6));
+		encoded[len++] = (char) (0x80 | (code & 0x3F));
+	}
+
+	else if (code < 0x10000) {
+		encoded[len++] = (char) (0xE0 | (code >> 12));
+		encoded[len++] = (char) (0x80 | ((code >> 6) & 0x3F));
+		encoded[len++] = (char) (0x80 | (code & 0x3F));
+	}
+
+	else {
+		encoded[len++] = (char) (0xF0 | (code >> 18));
+		encoded[len++] = (char) (0x80 | ((code >> 12) & 0x3F));
+		encoded[len++] = (char) (0x80 | ((code >> 6) & 0x3F));
+		encoded[len++] = (char) (0x80 | (code & 0x3F));
+	}
+
+	return len;
+
+}
+
+// returns the length of the valid sequence at the cursor or 0
+// overlong sequences, surrogates & values past U+10FFFF are rejected
+static size_t body_utf8_length (const BodyParser *parser) {
+
+	size_t len = 0;
+
+	const unsigned char *s = (const unsigned char *) parser->cur;
+	const size_t available = (size_t) (parser->end - parser->cur);
+
+	uint32_t code = 0;
+	if ((s[0] >= 0xC2) && (s[0] <= 0xDF)) { len = 2; code = s[0] & 0x1F; }
+	else if ((s[0] >= 0xE0) && (s[0] <= 0xEF)) { len = 3; code = s[0] & 0x0F; }
+	else if ((s[0] >= 0xF0) && (s[0] <= 0xF4)) { len = 4; code = s[0] & 0x07; }
+
+	if (len > available) len = 0;
+
+	for (size_t i = 1; i < len; i++) {
+		if ((s[i] & 0xC0) != 0x80) {
+			len = 0;
+			break;
+		}
+
+		code = (code << 6) | (s[i] & 0x3F);
+	}
+
+	if (
+		((len == 3) && ((code < 0x800) || ((code >= 0xD800) && (code <= 0xDFFF))))
+		|| ((len == 4) && ((code < 0x10000) || (code > 0x10FFFF)))
+	) {
+		len = 0;
+	}
+
+	return len;
+
+}
+
+static bool body_parse_hex4 (BodyParser *parser, uint32_t *value) {
+
+	bool retval = false;
+
+	if ((parser->end - parser->cur) >= 4) {
+		uint32_t result = 0;
+
+		retval = true;
+		for (unsigned int i = 0; i < 4; i++) {
+			const char c = parser->cur[i];
+
+			result <<= 4;
+			if ((c >= '0') && (c <= '9')) result |= (uint32_t) (c - '0');
+			else if ((c >= 'a') && (c <= 'f')) result |= (uint32_t) (c - 'a' + 10);
+			else if ((c >= 'A') && (c <= 'F')) result |= (uint32_t) (c - 'A' + 10);
+			else retval = false;
+		}
+
+		parser->cur += 4;
+		*value = result;
+	}
+
+	return retval;
+
+}
+
+// the cursor is right after the backslash
+static bool body_parse_escape (BodyParser *parser, BodyString *string) {
+
+	bool retval = false;
+
+	if (parser->cur < parser->end) {
+		const char c = *parser->cur++;
+
+		char decoded = 0;
+		switch (c) {
+			case '"': decoded = '"'; break;
+			case '\\': decoded = '\\'; break;
+			case '/': decoded = '/'; break;
+			case 'b': decoded = '\b'; break;
+			case 'f': decoded = '\f'; break;
+			case 'n': decoded = '\n'; break;
+			case 'r': decoded = '\r'; break;
+			case 't': decoded = '\t'; break;
+
+			case 'u': {
+				uint32_t code = 0;
+				if (body_parse_hex4 (parser, &code)) {
+					// a high surrogate must be followed by a low one
+					if ((code >= 0xD800) && (code <= 0xDBFF)) {
+						uint32_t low = 0;
+						if (
+							body_expect (parser, '\\') && body_expect (parser, 'u')
+							&& body_parse_hex4 (parser, &low)
+							&& (low >= 0xDC00) && (low <= 0xDFFF)
+						) {
+							code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+						}
+
+						else {
+							code = 0;
+						}
+					}
+
+					else if ((code >= 0xDC00) && (code <= 0xDFFF)) {
+						code = 0;
+					}
+
+					// NUL values are not allowed as in jansson
+					if (code) {
+						char encoded[4] = { 0 };
+						body_string_write (
+							string, encoded, body_utf8_encode (code, encoded), false
+						);
+
+						retval = true;
+					}
+				}
+			} break;
+
+			default: break;
+		}
+
+		if (decoded) {
+			body_string_write (string, &decoded, 1, true);
+			retval = true;
+		}
+	}
+
+	return retval;
+
+}
+
+// unescapes the string at the cursor into the buffer
+// the buffer is always NUL terminated
+static bool body_parse_string (BodyParser *parser, BodyString *string) {
+
+	bool retval = false;
+
+	bool error = !body_expect (parser, '"');
+	while (!error && !retval && (parser->cur < parser->end)) {
+		// copy the plain ascii runs at once
+		const char *run = parser->cur;
+		while (
+			(parser->cur < parser->end)
+			&& ((unsigned char) *parser->cur >= 0x20)
+			&& ((unsigned char) *parser->cur < 0x80)
+			&& (*parser->cur != '"') && (*parser->cur != '\\')
+		) parser->cur++;
+
+		body_string_write (string, run, (size_t) (parser->cur - run), true);
+
+		if (parser->cur < parser->end) {
+			const unsigned char c = (unsigned char) *parser->cur;
+			if (c == '"') {
+				parser->cur++;
+				retval = true;
+			}
+
+			else if (c == '\\') {
+				parser->cur++;
+				error = !body_parse_escape (parser, string);
+			}
+
+			else if (c >= 0x80) {
+				const size_t len = body_utf8_length (parser);
+				if (len) {
+					body_string_write (string, parser->cur, len, false);
+					parser->cur += len;
+				}
+
+				else {
+					error = true;
+				}
+			}
+
+			// control characters must be escaped
+			else {
+				error = true;
+			}
+		}
+	}
+
+	if (string->buffer && string->size) {
+		string->buffer[string->len] = '\0';
+	}
+
+	return retval;
+
+}
+
+static bool body_parse_digits (BodyParser *parser) {
+
+	const char *start = parser->cur;
+	while (
+		(parser->cur < parser->end)
+		&& (*parser->cur >= '0') && (*parser->cur <= '9')
+	) parser->cur++;
+
+	return parser->cur > start;
+
+}
+
+static bool body_parse_number (BodyParser *parser) {
+
+	bool retval = false;
+
+	(void) body_expect (parser, '-');
+
+	if (body_expect (parser, '0')) retval = true;
+	else if ((parser->cur < parser->end) && (*parser->cur >= '1') && (*parser->cur <= '9')) {
+		retval = body_parse_digits (parser);
+	}
+
+	if (retval && body_expect (parser, '.')) {
+		retval = body_parse_digits (parser);
+	}
+
+	if (retval && (body_expect (parser, 'e') || body_expect (parser, 'E'))) {
+		if (!body_expect (parser, '+')) (void) body_expect (parser, '-');
+		retval = body_parse_digits (parser);
+	}
+
+	return retval;
+
+}
+
+static bool body_parse_literal (
+	BodyParser *parser, const char *literal, const size_t literal_len
+) {
+
+	bool retval = false;
+
+	if (
+		((size_t) (parser->end - parser->cur) >= literal_len)
+		&& !memcmp (parser->cur, literal, literal_len)
+	) {
+		parser->cur += literal_len;
+		retval = true;
+	}
+
+	return retval;
+
+}
+
+static bool body_parse_array (
+	BodyParser *parser, const unsigned int depth
+) {
+
+	bool retval = false;
+
+	parser->cur++;
+	body_skip_whitespace (parser);
+
+	if (body_expect (parser, ']')) {
+		retval = true;
+	}
+
+	else {
+		bool error = false;
+		while (!error && !retval) {
+			error = !body_parse_value (parser, depth + 1);
+			body_skip_whitespace (parser);
+
+			if (!error) {
+				if (body_expect (parser, ']')) retval = true;
+				else if (body_expect (parser, ',')) body_skip_whitespace (parser);
+				else error = true;
+			}
+		}
+	}
+
+	return retval;
+
+}
+
+// copies the value of a top level field into the target
+static bool body_parse_field (
+	BodyParser *parser,
+	const JeevesBodyField *field, const unsigned int idx,
+	void *target, uint32_t *found
+) {
+
+	bool retval = false;
+
+	char *value = (char *) target + field->offset;
+
+	// the last value of a repeated key wins
+	*found &= ~((uint32_t) 1 << idx);
+
+	switch (field->type) {
+		case JEEVES_BODY_TYPE_STRING: {
+			if ((parser->cur < parser->end) && (*parser->cur == '"')) {
+				BodyString string = { value, field->size, 0, false };
+				retval = body_parse_string (parser, &string);
+				if (retval) {
+					*found |= (uint32_t) 1 << idx;
+				}
+			}
+
+			else {
+				if (field->size) value[0] = '\0';
+				retval = body_parse_value (parser, 2);
+			}
+		} break;
+
+		case JEEVES_BODY_TYPE_BOOL: {
+			*((bool *) value) = body_parse_literal (parser, "true", 4);
+			retval = *((bool *) value) ? true : body_parse_value (parser, 2);
+			if (retval) {
+				*found |= (uint32_t) 1 << idx;
+			}
+		} break;
+
+		default: break;
+	}
+
+	return retval;
+
+}
+
+// only the top level object has fields
+static bool body_parse_object (
+	BodyParser *parser, const unsigned int depth,
+	const JeevesBodyField *fields, const unsigned int n_fields,
+	void *target, uint32_t *found
+) {
+
+	bool retval = false;
+
+	parser->cur++;
+	body_skip_whitespace (parser);
+
+	if (body_expect (parser, '}')) {
+		retval = true;
+	}
+
+	else {
+		char key[JEEVES_BODY_KEY_SIZE] = { 0 };
+
+		bool error = false;
+		while (!error && !retval) {
+			BodyString key_string = { key, JEEVES_BODY_KEY_SIZE, 0, false };
+			error = !body_parse_string (parser, &key_string);
+
+			body_skip_whitespace (parser);
+			if (!error) error = !body_expect (parser, ':');
+			body_skip_whitespace (parser);
+
+			if (!error) {
+				unsigned int idx = n_fields;
+				if (!key_string.truncated) {
+					for (idx = 0; idx < n_fields; idx++) {
+						if (!strcmp (key, fields[idx].key)) break;
+					}
+				}
+
+				if (idx < n_fields) {
+					error = !body_parse_field (parser, &fields[idx], idx, target, found);
+				}
+
+				else {
+					error = !body_parse_value (parser, depth + 1);
+				}
+			}
+
+			body_skip_whitespace (parser);
+
+			if (!error) {
+				if (body_expect (parser, '}')) retval = true;
+				else if (body_expect (parser, ',')) body_skip_whitespace (parser);
+				else error = true;
+			}
+		}
+	}
+
+	return retval;
+
+}
+
+// validates the value at the cursor without keeping it
+static bool body_parse_value (
+	BodyParser *parser, const unsigned int depth
+) {
+
+	bool retval = false;
+
+	if ((depth <= JEEVES_BODY_MAX_DEPTH) && (parser->cur < parser->end)) {
+		switch (*parser->cur) {
+			case '{':
+				retval = body_parse_object (parser, depth, NULL, 0, NULL, NULL);
+				break;
+
+			case '[':
+				retval = body_parse_array (parser, depth);
+				break;
+
+			case '"': {
+				BodyString string = { NULL, 0, 0, false };
+				retval = body_parse_string (parser, &string);
+			} break;
+
+			case 't': retval = body_parse_literal (parser, "true", 4); break;
+			case 'f': retval = body_parse_literal (parser, "false", 5); break;
+			case 'n': retval = body_parse_literal (parser, "null", 4); break;
+
+			default: retval = body_parse_number (parser); break;
+		}
+	}
+
+	return retval;
+
+}
+
+// copies the top level values of the fields keys
+// straight from the body into the target without a json tree
+// strings are unescaped & truncated to fit like with strncpy ()
+// sets the bit of each field that was found, in the fields order
+// returns 0 on success, 1 if the body is not valid json
+unsigned int jeeves_body_parse (
+	const String *body,
+	const JeevesBodyField *fields, const unsigned int n_fields,
+	void *target, uint32_t *found
+) {
+
+	unsigned int retval = 1;
+
+	*found = 0;
+
+	if (body && body->str && (n_fields <= JEEVES_BODY_MAX_FIELDS)) {
+		BodyParser parser = { body->str, body->str + body->len };
+
+		body_skip_whitespace (&parser);
+
+		// as json_loads (), the body must be an object or an array
+		bool valid = false;
+		if ((parser.cur < parser.end) && (*parser.cur == '{')) {
+			valid = body_parse_object (&parser, 1, fields, n_fields, target, found);
+		}
+
+		else if ((parser.cur < parser.end) && (*parser.cur == '[')) {
+			valid = body_parse_array (&parser, 1);
+		}
+
+		body_skip_whitespace (&parser);
+
+		if (valid && (parser.cur == parser.end)) {
+			retval = 0;
+		}
+
+		else {
+			*found = 0;
+		}
+	}
+
+	return retval;
+
+}
@@ -0,0 +1,346 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include <bson/bson.h>
+
+#include <cerver/utils/log.h>
+
+#include "cache.h"
+
+typedef struct CacheEntry {
+
+	bson_oid_t key;
+	bson_oid_t owner;
+	bool has_owner;
+
+	char *json;
+	size_t json_len;
+
+	// bucket chain
+	struct CacheEntry *next;
+
+	// least recently used list
+	struct CacheEntry *lru_prev;
+	struct CacheEntry *lru_next;
+
+} CacheEntry;
+
+struct _JeevesCache {
+
+	char name[JEEVES_CACHE_NAME_SIZE];
+
+	size_t max_bytes;
+
+	CacheEntry *buckets[JEEVES_CACHE_BUCKETS];
+
+	// bumped every time a key in the bucket is invalidated
+	uint64_t generations[JEEVES_CACHE_BUCKETS];
+
+	// most recently used first
+	CacheEntry *lru_head;
+	CacheEntry *lru_tail;
+
+	JeevesCacheStats stats;
+
+	pthread_mutex_t mutex;
+
+};
+
+static inline size_t cache_entry_size (const CacheEntry *entry) {
+
+	return sizeof (CacheEntry) + entry->json_len;
+
+}
+
+static void cache_entry_delete (CacheEntry *entry) {
+
+	free (entry->json);
+	free (entry);
+
+}
+
+static inline size_t cache_bucket (const bson_oid_t *key) {
+
+	return (size_t) (bson_oid_hash (key) & (JEEVES_CACHE_BUCKETS - 1));
+
+}
+
+JeevesCache *jeeves_cache_create (
+	const char *name, const size_t max_bytes
+) {
+
+	JeevesCache *cache = (JeevesCache *) malloc (sizeof (JeevesCache));
+	if (cache) {
+		(void) memset (cache, 0, sizeof (JeevesCache));
+
+		(void) strncpy (cache->name, name, JEEVES_CACHE_NAME_SIZE - 1);
+		cache->max_bytes = max_bytes;
+
+		(void) pthread_mutex_init (&cache->mutex, NULL);
+	}
+
+	return cache;
+
+}
+
+void jeeves_cache_delete (JeevesCache *cache) {
+
+	if (cache) {
+		CacheEntry *entry = cache->lru_head;
+		CacheEntry *next = NULL;
+		while (entry) {
+			next = entry->lru_next;
+			cache_entry_delete (entry);
+			entry = next;
+		}
+
+		(void) pthread_mutex_destroy (&cache->mutex);
+
+		free (cache);
+	}
+
+}
+
+static void cache_lru_unlink (JeevesCache *cache, CacheEntry *entry) {
+
+	if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+	else cache->lru_head = entry->lru_next;
+
+	if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+	else cache->lru_tail = entry->lru_prev;
+
+	entry->lru_prev = NULL;
+	entry->lru_next = NULL;
+
+}
+
+static void cache_lru_push (JeevesCache *cache, CacheEntry *entry) {
+
+	entry->lru_prev = NULL;
+	entry->lru_next = cache->lru_head;
+
+	if (cache->lru_head) cache->lru_head->lru_prev = entry;
+	else cache->lru_tail = entry;
+
+	cache->lru_head = entry;
+
+}
+
+// removes the key's entry from its bucket & from the lru list
+// must be called with the cache's mutex locked
+static CacheEntry *cache_remove (
+	JeevesCache *cache, const size_t bucket, const bson_oid_t *key
+) {
+
+	CacheEntry **ptr = &cache->buckets[bucket];
+	while (*ptr) {
+		if (bson_oid_equal (&(*ptr)->key, key)) {
+			CacheEntry *entry = *ptr;
+			*ptr = entry->next;
+
+			cache_lru_unlink (cache, entry);
+
+			cache->stats.entries -= 1;
+			cache->stats.bytes -= cache_entry_size (entry);
+
+			return entry;
+		}
+
+		ptr = &(*ptr)->next;
+	}
+
+	return NULL;
+
+}
+
+// evicts the least recently used entries until the new one fits
+// must be called with the cache's mutex locked
+static void cache_evict (JeevesCache *cache, const size_t needed) {
+
+	CacheEntry *entry = NULL;
+	while (
+		cache->lru_tail
+		&& ((cache->stats.bytes + needed) > cache->max_bytes)
+	) {
+		entry = cache_remove (
+			cache, cache_bucket (&cache->lru_tail->key),
+			&cache->lru_tail->key
+		);
+
+		cache_entry_delete (entry);
+
+		cache->stats.evictions += 1;
+	}
+
+}
+
+// appends the cached json to the buffer if the key exists
+// and it belongs to the owner (if any)
+// on a miss, the key's generation is returned to be used with put
+// returns 0 on hit, 1 on miss
+unsigned int jeeves_cache_get (
+	JeevesCache *cache,
+	const bson_oid_t *key, const bson_oid_t *owner,
+	JeevesJson *json,
+	uint64_t *generation
+) {
+
+	unsigned int retval = 1;
+
+	const size_t bucket = cache_bucket (key);
+
+	(void) pthread_mutex_lock (&cache->mutex);
+
+	CacheEntry *entry = cache->buckets[bucket];
+	while (entry && !bson_oid_equal (&entry->key, key)) entry = entry->next;
+
+	if (
+		entry
+		&& (!owner || (entry->has_owner && bson_oid_equal (&entry->owner, owner)))
+	) {
+		jeeves_json_write (json, entry->json, entry->json_len);
+		if (!json->error) {
+			cache_lru_unlink (cache, entry);
+			cache_lru_push (cache, entry);
+
+			retval = 0;
+		}
+	}
+
+	if (retval) {
+		*generation = cache->generations[bucket];
+		cache->stats.misses += 1;
+	}
+
+	else {
+		cache->stats.hits += 1;
+	}
+
+	(void) pthread_mutex_unlock (&cache->mutex);
+
+	return retval;
+
+}
+
+// stores a copy of the json only if the key has not been
+// invalidated since its generation was taken in get
+void jeeves_cache_put (
+	JeevesCache *cache,
+	const bson_oid_t *key, const bson_oid_t *owner,
+	const char *json, const size_t json_len,
+	const uint64_t generation
+) {
+
+	const size_t needed = sizeof (CacheEntry) + json_len;
+
+	CacheEntry *entry = NULL;
+	if (needed <= cache->max_bytes) {
+		entry = (CacheEntry *) malloc (sizeof (CacheEntry));
+		if (entry) {
+			(void) memset (entry, 0, sizeof (CacheEntry));
+
+			entry->json = (char *) malloc (json_len + 1);
+			if (entry->json) {
+				(void) memcpy (entry->json, json, json_len);
+				entry->json[json_len] = '\0';
+				entry->json_len = json_len;
+			}
+
+			else {
+				free (entry);
+				entry = NULL;
+			}
+		}
+	}
+
+	if (entry) {
+		bson_oid_copy (key, &entry->key);
+		if (owner) {
+			bson_oid_copy (owner, &entry->owner);
+			entry->has_owner = true;
+		}
+
+		const size_t bucket = cache_bucket (key);
+
+		CacheEntry *old = NULL;
+
+		(void) pthread_mutex_lock (&cache->mutex);
+
+		if (cache->generations[bucket] == generation) {
+			old = cache_remove (cache, bucket, key);
+
+			cache_evict (cache, needed);
+
+			entry->next = cache->buckets[bucket];
+			cache->buckets[bucket] = entry;
+			cache_lru_push (cache, entry);
+
+			cache->stats.inserts += 1;
+			cache->stats.entries += 1;
+			cache->stats.bytes += needed;
+
+			entry = NULL;
+		}
+
+		(void) pthread_mutex_unlock (&cache->mutex);
+
+		// the value was invalidated while it was being read
+		if (entry) cache_entry_delete (entry);
+		if (old) cache_entry_delete (old);
+	}
+
+}
+
+// removes the key's value & prevents in flight reads from storing it
+void jeeves_cache_invalidate (
+	JeevesCache *cache, const bson_oid_t *key
+) {
+
+	const size_t bucket = cache_bucket (key);
+
+	(void) pthread_mutex_lock (&cache->mutex);
+
+	cache->generations[bucket] += 1;
+
+	CacheEntry *entry = cache_remove (cache, bucket, key);
+	if (entry) cache->stats.invalidations += 1;
+
+	(void) pthread_mutex_unlock (&cache->mutex);
+
+	if (entry) cache_entry_delete (entry);
+
+}
+
+// gets a snapshot of the current counters
+void jeeves_cache_stats (
+	JeevesCache *cache, JeevesCacheStats *stats
+) {
+
+	(void) pthread_mutex_lock (&cache->mutex);
+
+	(void) memcpy (stats, &cache->stats, sizeof (JeevesCacheStats));
+
+	(void) pthread_mutex_unlock (&cache->mutex);
+
+}
+
+void jeeves_cache_print (JeevesCache *cache) {
+
+	if (cache) {
+		JeevesCacheStats stats = { 0 };
+		jeeves_cache_stats (cache, &stats);
+
+		cerver_log_msg ("\n%s cache:\n", cache->name);
+		cerver_log_msg ("Hits: %zu\n", stats.hits);
+		cerver_log_msg ("Misses: %zu\n", stats.misses);
+		cerver_log_msg ("Inserts: %zu\n", stats.inserts);
+		cerver_log_msg ("Evictions: %zu\n", stats.evictions);
+		cerver_log_msg ("Invalidations: %zu\n", stats.invalidations);
+		cerver_log_msg ("Entries: %zu\n", stats.entries);
+		cerver_log_msg ("Bytes: %zu / %zu\n", stats.bytes, cache->max_bytes);
+	}
+
+}
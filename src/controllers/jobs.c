@@ -15,8 +15,13 @@
 #include <cmongo/crud.h>
 #include <cmongo/select.h>
 
+#include "arena.h"
+#include "blobs.h"
+#include "body.h"
 #include "errors.h"
+#include "images.h"
 #include "jeeves.h"
+#include "storage.h"
 #include "worker.h"
 
 #include "models/job.h"
@@ -29,12 +34,49 @@ static Pool *jobs_pool = NULL;
 const bson_t *job_no_user_query_opts = NULL;
 static CMongoSelect *job_no_user_select = NULL;
 
+// only the values that are needed to check & change the job's status
+const bson_t *job_status_query_opts = NULL;
+static CMongoSelect *job_status_select = NULL;
+
+const bson_t *job_state_query_opts = NULL;
+static CMongoSelect *job_state_select = NULL;
+
+const bson_t *job_images_query_opts = NULL;
+static CMongoSelect *job_images_select = NULL;
+
 HttpResponse *no_user_jobs = NULL;
 HttpResponse *no_user_job = NULL;
 
 HttpResponse *job_created_bad = NULL;
 HttpResponse *job_deleted_bad = NULL;
 
+// POST /api/jeeves/jobs
+static const JeevesBodyField job_create_fields[] = {
+	JEEVES_BODY_STRING ("name", JeevesJob, name),
+	JEEVES_BODY_STRING ("description", JeevesJob, description),
+	JEEVES_BODY_BOOL ("autoStart", JeevesJob, autostart)
+};
+
+#define JOB_CREATE_FIELDS				3
+#define JOB_CREATE_FIELD_NAME			1
+
+// POST /api/jeeves/jobs/:id/config
+typedef struct JobConfigValues {
+
+	char type[JOB_CONFIG_TYPE_SIZE];
+	bool autostart;
+
+} JobConfigValues;
+
+static const JeevesBodyField job_config_fields[] = {
+	JEEVES_BODY_STRING ("type", JobConfigValues, type),
+	JEEVES_BODY_BOOL ("autoStart", JobConfigValues, autostart)
+};
+
+#define JOB_CONFIG_FIELDS				2
+#define JOB_CONFIG_FIELD_TYPE			1
+#define JOB_CONFIG_FIELD_AUTOSTART		2
+
 void jeeves_job_return (void *jobs_ptr);
 
 static unsigned int jeeves_jobs_init_pool (void) {
@@ -62,6 +104,17 @@ static unsigned int jeeves_jobs_init_pool (void) {
 
 }
 
+// jobs that are only used by the request's handler
+// are taken from its arena instead of the pool
+static JeevesJob *jeeves_jobs_get (void) {
+
+	JeevesJob *job = (JeevesJob *) jeeves_arena_calloc (sizeof (JeevesJob));
+	if (!job) job = (JeevesJob *) pool_pop (jobs_pool);
+
+	return job;
+
+}
+
 static unsigned int jeeves_jobs_init_query_opts (void) {
 
 	unsigned int retval = 1;
@@ -75,6 +128,8 @@ static unsigned int jeeves_jobs_init_query_opts (void) {
 
 	(void) cmongo_select_insert_field (job_no_user_select, "type");
 
+	(void) cmongo_select_insert_field (job_no_user_select, "autoStart");
+
 	(void) cmongo_select_insert_field (job_no_user_select, "imagesCount");
 
 	(void) cmongo_select_insert_field (job_no_user_select, "created");
@@ -83,7 +138,35 @@ static unsigned int jeeves_jobs_init_query_opts (void) {
 
 	job_no_user_query_opts = mongo_find_generate_opts (job_no_user_select);
 
-	if (job_no_user_query_opts) retval = 0;
+	// stop & end
+	job_status_select = cmongo_select_new ();
+	(void) cmongo_select_insert_field (job_status_select, "user");
+	(void) cmongo_select_insert_field (job_status_select, "status");
+
+	job_status_query_opts = mongo_find_generate_opts (job_status_select);
+
+	// config, upload & start
+	job_state_select = cmongo_select_new ();
+	(void) cmongo_select_insert_field (job_state_select, "user");
+	(void) cmongo_select_insert_field (job_state_select, "status");
+	(void) cmongo_select_insert_field (job_state_select, "type");
+	(void) cmongo_select_insert_field (job_state_select, "autoStart");
+	(void) cmongo_select_insert_field (job_state_select, "imagesCount");
+	(void) cmongo_select_insert_field (job_state_select, "pixels");
+
+	job_state_query_opts = mongo_find_generate_opts (job_state_select);
+
+	// worker
+	job_images_select = cmongo_select_new ();
+	(void) cmongo_select_insert_field (job_images_select, "images");
+
+	job_images_query_opts = mongo_find_generate_opts (job_images_select);
+
+	if (
+		job_no_user_query_opts
+		&& job_status_query_opts && job_state_query_opts
+		&& job_images_query_opts
+	) retval = 0;
 
 	return retval;
 
@@ -134,6 +217,19 @@ unsigned int jeeves_jobs_init (void) {
 
 void jeeves_jobs_end (void) {
 
+	cmongo_select_delete (job_no_user_select);
+	bson_destroy ((bson_t *) job_no_user_query_opts);
+
+	cmongo_select_delete (job_status_select);
+	bson_destroy ((bson_t *) job_status_query_opts);
+
+	cmongo_select_delete (job_state_select);
+	bson_destroy ((bson_t *) job_state_query_opts);
+
+	cmongo_select_delete (job_images_select);
+	bson_destroy ((bson_t *) job_images_query_opts);
+
+
 	http_response_delete (job_created_bad);
 	http_response_delete (job_deleted_bad);
 
@@ -142,57 +238,94 @@ void jeeves_jobs_end (void) {
 
 }
 
-static JeevesJob *jeeves_job_create_actual (
-	const char *user_id,
-	const char *name,
-	const char *description
+// sets the values of a new job whose body values are already set
+static void jeeves_job_create_actual (
+	JeevesJob *job, const char *user_id
 ) {
 
-	JeevesJob *job = (JeevesJob *) pool_pop (jobs_pool);
-	if (job) {
-		bson_oid_init (&job->oid, NULL);
-
-		bson_oid_init_from_string (&job->user_oid, user_id);
+	bson_oid_init (&job->oid, NULL);
 
-		if (name) (void) strncpy (job->name, name, JOB_NAME_SIZE - 1);
-		if (description) (void) strncpy (job->description, description, JOB_DESCRIPTION_SIZE - 1);
+	bson_oid_init_from_string (&job->user_oid, user_id);
 
-		job->status = JOB_STATUS_WAITING;
-
-		job->created = time (NULL);
-	}
+	job->status = JOB_STATUS_WAITING;
 
-	return job;
+	job->created = time (NULL);
 
 }
 
-unsigned int jeeves_jobs_get_all_by_user_to_json (
-	const bson_oid_t *user_oid,
-	char **json, size_t *json_len
+// iterates a page of the user's jobs without their images
+unsigned int jeeves_jobs_get_page_by_user (
+	const bson_oid_t *user_oid, const JobsPage *page,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
 ) {
 
-	return jobs_get_all_by_user_to_json (
+	return jeeves_storage->jobs_get_page_by_user (
 		user_oid, job_no_user_query_opts,
-		json, json_len
+		page,
+		each, data
 	);
 
 }
 
+// iterates a page of the user's job images
+// returns 1 if the job's id is not valid or on error
+unsigned int jeeves_job_get_images_page_by_id (
+	const String *job_id, const bson_oid_t *user_oid,
+	const JobImagesPage *page,
+	bool (*each)(void *data, const JobImage *job_image), void *data
+) {
+
+	unsigned int retval = 1;
+
+	if (job_id && bson_oid_is_valid (job_id->str, job_id->len)) {
+		bson_oid_t job_oid = { 0 };
+		bson_oid_init_from_string (&job_oid, job_id->str);
+
+		retval = jeeves_storage->job_get_images_page (
+			&job_oid, user_oid,
+			page,
+			each, data
+		);
+	}
+
+	return retval;
+
+}
+
+// gets a job from the pool that only references the job's id
+// to be used with the conditional state transitions
+static JeevesJob *jeeves_job_get_by_id (const String *job_id) {
+
+	JeevesJob *job = NULL;
+
+	if (job_id) {
+		job = jeeves_jobs_get ();
+		if (job) {
+			bson_oid_init_from_string (&job->oid, job_id->str);
+			bson_oid_to_string (&job->oid, job->id);
+		}
+	}
+
+	return job;
+
+}
+
 JeevesJob *jeeves_job_get_by_id_and_user (
-	const String *job_id, const bson_oid_t *user_oid
+	const String *job_id, const bson_oid_t *user_oid,
+	const bson_t *query_opts
 ) {
 
 	JeevesJob *job = NULL;
 
 	if (job_id && user_oid) {
-		job = (JeevesJob *) pool_pop (jobs_pool);
+		job = jeeves_jobs_get ();
 		if (job) {
 			bson_oid_init_from_string (&job->oid, job_id->str);
 
-			if (jeeves_job_get_by_oid_and_user (
+			if (jeeves_storage->job_get_by_oid_and_user (
 				job,
 				&job->oid, user_oid,
-				NULL
+				query_opts
 			)) {
 				jeeves_job_return (job);
 				job = NULL;
@@ -207,7 +340,7 @@ JeevesJob *jeeves_job_get_by_id_and_user (
 u8 jeeves_job_get_by_id_and_user_to_json (
 	const char *job_id, const bson_oid_t *user_oid,
 	const bson_t *query_opts,
-	char **json, size_t *json_len
+	JeevesJson *json
 ) {
 
 	u8 retval = 1;
@@ -216,10 +349,10 @@ u8 jeeves_job_get_by_id_and_user_to_json (
 		bson_oid_t job_oid = { 0 };
 		bson_oid_init_from_string (&job_oid, job_id);
 
-		retval = jeeves_job_get_by_oid_and_user_to_json (
+		retval = jeeves_storage->job_get_by_oid_and_user_to_json (
 			&job_oid, user_oid,
 			query_opts,
-			json, json_len
+			json
 		);
 	}
 
@@ -227,33 +360,29 @@ u8 jeeves_job_get_by_id_and_user_to_json (
 
 }
 
-static void jeeves_job_parse_json (
-	json_t *json_body,
-	const char **name,
-	const char **description
+// iterates the job's document as it comes from the db
+// returns 0 on success, 1 on error
+unsigned int jeeves_job_get_by_id_and_user_each (
+	const String *job_id, const bson_oid_t *user_oid,
+	const bson_t *query_opts,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
 ) {
 
-	// get values from json to create a new transaction
-	const char *key = NULL;
-	json_t *value = NULL;
-	if (json_typeof (json_body) == JSON_OBJECT) {
-		json_object_foreach (json_body, key, value) {
-			if (!strcmp (key, "name")) {
-				*name = json_string_value (value);
-				#ifdef JEEVES_DEBUG
-				(void) printf ("name: \"%s\"\n", *name);
-				#endif
-			}
+	unsigned int retval = 1;
 
-			else if (!strcmp (key, "description")) {
-				*description = json_string_value (value);
-				#ifdef JEEVES_DEBUG
-				(void) printf ("description: \"%s\"\n", *description);
-				#endif
-			}
-		}
+	if (job_id && bson_oid_is_valid (job_id->str, job_id->len)) {
+		bson_oid_t job_oid = { 0 };
+		bson_oid_init_from_string (&job_oid, job_id->str);
+
+		retval = jeeves_storage->job_get_by_oid_and_user_each (
+			&job_oid, user_oid,
+			query_opts,
+			each, data
+		);
 	}
 
+	return retval;
+
 }
 
 static JeevesError jeeves_job_create_parse_json (
@@ -263,42 +392,40 @@ static JeevesError jeeves_job_create_parse_json (
 
 	JeevesError error = JEEVES_ERROR_NONE;
 
-	const char *name = NULL;
-	const char *description = NULL;
-
-	json_error_t json_error =  { 0 };
-	json_t *json_body = json_loads (request_body->str, 0, &json_error);
-	if (json_body) {
-		jeeves_job_parse_json (
-			json_body,
-			&name, &description
-		);
-
-		if (name) {
-			*job = jeeves_job_create_actual (
-				user_id,
-				name, description
-			);
+	JeevesJob *new_job = jeeves_jobs_get ();
+	if (new_job) {
+		// the values are copied straight into the job
+		uint32_t found = 0;
+		if (!jeeves_body_parse (
+			request_body,
+			job_create_fields, JOB_CREATE_FIELDS,
+			new_job, &found
+		)) {
+			if (found & JOB_CREATE_FIELD_NAME) {
+				jeeves_job_create_actual (new_job, user_id);
+
+				*job = new_job;
+				new_job = NULL;
+			}
 
-			if (*job == NULL) error = JEEVES_ERROR_SERVER_ERROR;
+			else {
+				error = JEEVES_ERROR_MISSING_VALUES;
+			}
 		}
 
 		else {
-			error = JEEVES_ERROR_MISSING_VALUES;
+			#ifdef JEEVES_DEBUG
+			cerver_log_error ("jeeves_job_create_parse_json () - bad json body!");
+			#endif
+
+			error = JEEVES_ERROR_BAD_REQUEST;
 		}
 
-		json_decref (json_body);
+		if (new_job) jeeves_job_return (new_job);
 	}
 
 	else {
-		#ifdef JEEVES_DEBUG
-		cerver_log_error (
-			"json_loads () - json error on line %d: %s\n",
-			json_error.line, json_error.text
-		);
-		#endif
-
-		error = JEEVES_ERROR_BAD_REQUEST;
+		error = JEEVES_ERROR_SERVER_ERROR;
 	}
 
 	return error;
@@ -325,7 +452,7 @@ JeevesError jeeves_job_create (
 			#endif
 
 			// insert into the db
-			if (!jeeves_job_insert_one (job)) {
+			if (!jeeves_storage->job_insert_one (job)) {
 				cerver_log_success ("Saved job %s!", job->id);
 			}
 
@@ -349,61 +476,111 @@ JeevesError jeeves_job_create (
 
 }
 
-static void jeeves_job_config_parse_json (
-	json_t *json_body,
-	const char **type
+static JeevesError jeeves_job_config_internal (
+	JeevesJob *job, const String *request_body,
+	bool *set_autostart
 ) {
 
-	// get values from json to create a new transaction
-	const char *key = NULL;
-	json_t *value = NULL;
-	if (json_typeof (json_body) == JSON_OBJECT) {
-		json_object_foreach (json_body, key, value) {
-			if (!strcmp (key, "type")) {
-				*type = json_string_value (value);
-				#ifdef JEEVES_DEBUG
-				(void) printf ("type: \"%s\"\n", *type);
-				#endif
+	JeevesError error = JEEVES_ERROR_NONE;
+
+	JobConfigValues values = { 0 };
+
+	uint32_t found = 0;
+	if (!jeeves_body_parse (
+		request_body,
+		job_config_fields, JOB_CONFIG_FIELDS,
+		&values, &found
+	)) {
+		if (found & JOB_CONFIG_FIELD_TYPE) {
+			// set configuration to current job
+			job->type = job_type_from_string (values.type);
+
+			// optional - keeps the current value if missing
+			if (found & JOB_CONFIG_FIELD_AUTOSTART) {
+				job->autostart = values.autostart;
+				*set_autostart = true;
 			}
 		}
+
+		else {
+			error = JEEVES_ERROR_MISSING_VALUES;
+		}
+	}
+
+	else {
+		cerver_log_error ("jeeves_job_config_internal () - bad json body!");
+
+		error = JEEVES_ERROR_BAD_REQUEST;
 	}
 
+	return error;
+
 }
 
-static JeevesError jeeves_job_config_internal (
-	JeevesJob *job, const String *request_body
-) {
+// the worker keeps its jobs after the request has ended
+// so a job from the request's arena is moved into one from the pool
+// that takes the job's images buffer
+static JeevesJob *jeeves_job_detach (JeevesJob *job) {
 
-	JeevesError error = JEEVES_ERROR_NONE;
+	JeevesJob *detached = job;
 
-	// the job type to be executed
-	const char *type = NULL;
+	if (jeeves_arena_owns (job)) {
+		detached = (JeevesJob *) pool_pop (jobs_pool);
+		if (detached) {
+			free (detached->images);
+			(void) memcpy (detached, job, sizeof (JeevesJob));
+		}
+	}
 
-	json_error_t json_error =  { 0 };
-	json_t *json_body = json_loads (request_body->str, 0, &json_error);
-	if (json_body) {
-		jeeves_job_config_parse_json (
-			json_body,
-			&type
-		);
+	return detached;
 
-		if (type) {
-			// set configuration to current job
-			job->type = job_type_from_string (type);
+}
+
+// queues the job only if it is READY
+// the worker marks it as running once it picks it up
+// on success, the job is owned by the worker
+static JeevesError jeeves_job_start_internal (JeevesJob *job) {
+
+	JeevesError error = JEEVES_ERROR_NONE;
+
+	if (job->status == JOB_STATUS_READY) {
+		JeevesJob *worker_job = jeeves_job_detach (job);
+		if (worker_job && !jeeves_jobs_worker_create (worker_job)) {
+			// the images buffer now belongs to the worker's job
+			if (worker_job != job) {
+				job->images = NULL;
+				job->images_capacity = 0;
+			}
+
+			cerver_log_success ("Job %s has been queued!", job->id);
 		}
 
 		else {
-			error = JEEVES_ERROR_MISSING_VALUES;
-		}
+			// the images buffer stays with the request's job
+			if (worker_job && (worker_job != job)) {
+				worker_job->images = NULL;
+				worker_job->images_capacity = 0;
+				jeeves_job_return (worker_job);
+			}
 
-		json_decref (json_body);
+			cerver_log_error (
+				"jeeves_job_start_internal () - "
+				"failed to queue job %s",
+				job->id
+			);
+
+			error = JEEVES_ERROR_SERVER_ERROR;
+		}
 	}
 
 	else {
+		#ifdef JEEVES_DEBUG
 		cerver_log_error (
-			"json_loads () - json error on line %d: %s\n",
-			json_error.line, json_error.text
+			"jeeves_job_start_internal () - "
+			"job %s is not READY",
+			job->id
 		);
+		#endif
 
 		error = JEEVES_ERROR_BAD_REQUEST;
 	}
@@ -412,6 +589,20 @@ static JeevesError jeeves_job_config_internal (
 
 }
 
+// starts the job right away if the user requested it
+// returns TRUE if the job is now owned by the worker
+static bool jeeves_job_autostart (JeevesJob *job) {
+
+	bool started = false;
+
+	if (job->autostart && !jeeves_jobs_worker_check (&job->oid)) {
+		started = (jeeves_job_start_internal (job) == JEEVES_ERROR_NONE);
+	}
+
+	return started;
+
+}
+
 JeevesError jeeves_job_config (
 	const User *user, const String *job_id,
 	const String *request_body
@@ -420,26 +611,35 @@ JeevesError jeeves_job_config (
 	JeevesError error = JEEVES_ERROR_NONE;
 
 	if (request_body) {
-		JeevesJob *job = jeeves_job_get_by_id_and_user (
-			job_id, &user->oid
-		);
-
+		JeevesJob *job = jeeves_job_get_by_id (job_id);
 		if (job) {
-			error = jeeves_job_config_internal (job, request_body);
+			bool set_autostart = false;
+			error = jeeves_job_config_internal (
+				job, request_body, &set_autostart
+			);
 
 			if (error == JEEVES_ERROR_NONE) {
 				// update job's configuration in the db
-				if (!jeeves_job_update_config (job)) {
+				// only if the job is not running
+				if (!jeeves_storage->job_transition_config (
+					job, &user->oid, set_autostart,
+					job_state_query_opts
+				)) {
 					// check if the job is ready to be started
-					if (job->n_images) {
-						(void) jeeves_job_update_status (
-							&job->oid, JOB_STATUS_READY
-						);
+					if (
+						job->n_images
+						&& !jeeves_storage->job_transition_ready (job, job_state_query_opts)
+					) {
+						if (jeeves_job_autostart (job)) job = NULL;
 					}
 				}
 
 				else {
-					error = JEEVES_ERROR_SERVER_ERROR;
+					#ifdef JEEVES_DEBUG
+					cerver_log_error ("Job was not found or is running!");
+					#endif
+
+					error = JEEVES_ERROR_BAD_REQUEST;
 				}
 			}
 
@@ -447,10 +647,6 @@ JeevesError jeeves_job_config (
 		}
 
 		else {
-			#ifdef JEEVES_DEBUG
-			cerver_log_error ("Job was not found!");
-			#endif
-
 			error = JEEVES_ERROR_BAD_REQUEST;
 		}
 	}
@@ -475,36 +671,58 @@ JeevesError jeeves_job_upload (
 	JeevesError error = JEEVES_ERROR_NONE;
 
 	JeevesJob *job = jeeves_job_get_by_id_and_user (
-		job_id, &user->oid
+		job_id, &user->oid,
+		job_state_query_opts
 	);
 
 	if (job) {
+		JeevesUpload *upload = jeeves_upload_new (dirname, user->id);
+
 		// create jobs images
 		const char *filename = NULL;
 		JobImage *job_image = NULL;
-		int image_id = !job->n_images ? 0 : job->n_images - 1;
+		ImageInfo info = { 0 };
+		int image_id = job->n_images;
 		DoubleList *images = dlist_init (job_image_delete, NULL);
 		char *end = NULL;
 		for (ListElement *le = dlist_start (filenames); le; le = le->next) {
 			filename = (const char *) le->data;
 
+			// reject the whole upload if any of the files
+			// is not an image that the worker can decode
+			if (jeeves_image_info_read (filename, &info)) {
+				error = JEEVES_ERROR_BAD_IMAGE;
+				break;
+			}
+
 			job_image = job_image_create (
 				image_id,
 				filename,
 				NULL, "null"
 			);
 
-			end = strstr (filename, JEEVES_UPLOADS_TEMP_DIR);
+			job_image->format = info.format;
+			job_image->width = info.width;
+			job_image->height = info.height;
+			job_image->channels = info.channels;
+
+			end = strstr (filename, UPLOADS_TEMP_DIR);
 			if (end) {
 				(void) snprintf (
 					job_image->original, JOB_IMAGE_ORIGINAL_SIZE,
 					"%s/%s%s",
 					JEEVES_UPLOADS_PATH,
 					user->id,
-					end + strlen (JEEVES_UPLOADS_TEMP_DIR)
+					end + strlen (UPLOADS_TEMP_DIR)
 				);
 			}
 
+			// hash the image while it is still in temp storage
+			// to be able to detect duplicated contents
+			if (!jeeves_blob_hash_file (filename, job_image->hash)) {
+				(void) jeeves_upload_add_image (upload, job_image);
+			}
+
 			(void) dlist_insert_at_end_unsafe (
 				images,
 				job_image
@@ -513,22 +731,30 @@ JeevesError jeeves_job_upload (
 			image_id += 1;
 		}
 
+		if (error != JEEVES_ERROR_NONE) {
+			jeeves_upload_delete (upload);
+		}
+
 		// update current job with new images
-		if (!jeeves_job_update_images (&job->oid, images)) {
+		else if (!jeeves_storage->job_update_images (job, images)) {
 			// check if the job is ready to be started
-			if (job->type != JOB_TYPE_NONE) {
-				(void) jeeves_job_update_status (
-					&job->oid, JOB_STATUS_READY
-				);
+			// the updated images count is returned with the new status
+			if (
+				(job->type != JOB_TYPE_NONE)
+				&& !jeeves_storage->job_transition_ready (job, job_state_query_opts)
+			) {
+				// the worker loads the images from the db
+				// including the ones that are still in their temporary location
+				if (jeeves_job_autostart (job)) job = NULL;
 			}
 
 			// request UPLOADS worker to save frames to persistent storage
-			(void) jeeves_uploads_worker_push (
-				jeeves_upload_new (dirname, user->id)
-			);
+			(void) jeeves_uploads_worker_push (upload);
 		}
 
 		else {
+			jeeves_upload_delete (upload);
+
 			error = JEEVES_ERROR_SERVER_ERROR;
 		}
 
@@ -552,37 +778,16 @@ JeevesError jeeves_job_start (
 	JeevesError error = JEEVES_ERROR_NONE;
 
 	JeevesJob *job = jeeves_job_get_by_id_and_user (
-		job_id, &user->oid
+		job_id, &user->oid, job_state_query_opts
 	);
 
 	if (job) {
 		// check if the job has NOT been started
-		if (
-			jeeves_jobs_worker_check (&job->oid),
-			(job->status != JOB_STATUS_RUNNING)
-			&& (job->status == JOB_STATUS_READY)
-		) {
-			// start job
-			if (!jeeves_jobs_worker_create (job)) {
-				// update the job in the db
-				if (!jeeves_job_update_start (&job->oid)) {
-					cerver_log_success ("Job %s has started!", job->id);
-				}
-
-				else {
-					cerver_log_error (
-						"jeeves_job_start_handler () - "
-						"failed to update job %s status",
-						job->id
-					);
+		if (!jeeves_jobs_worker_check (&job->oid)) {
+			error = jeeves_job_start_internal (job);
 
-					error = JEEVES_ERROR_SERVER_ERROR;
-				}
-			}
-
-			else {
-				error = JEEVES_ERROR_SERVER_ERROR;
-			}
+			// the worker now owns the job
+			if (error == JEEVES_ERROR_NONE) job = NULL;
 		}
 
 		else {
@@ -606,18 +811,26 @@ JeevesError jeeves_job_stop (
 
 	JeevesError error = JEEVES_ERROR_NONE;
 
-	JeevesJob *job = jeeves_job_get_by_id_and_user (
-		job_id, &user->oid
-	);
-
+	JeevesJob *job = jeeves_job_get_by_id (job_id);
 	if (job) {
-		// TODO: stop job
+		// queued jobs are still READY so they only leave the queue
+		if (!jeeves_jobs_worker_dequeue (&job->oid, &user->oid)) {
+			cerver_log_success ("Job %s has been removed from the queue!", job->id);
+		}
+
+		// update the job in the db only if it is running
+		else if (!jeeves_storage->job_transition_stop (
+			job, &user->oid, job_status_query_opts
+		)) {
+			(void) jeeves_jobs_worker_stop (&job->oid);
 
-		// update the job in the db
-		if (!jeeves_job_update_stop (&job->oid)) {
 			cerver_log_success ("Job %s has been stopped!", job->id);
 		}
 
+		else {
+			error = JEEVES_ERROR_BAD_REQUEST;
+		}
+
 		jeeves_job_return (job);
 	}
 
@@ -631,16 +844,22 @@ JeevesError jeeves_job_stop (
 
 void jeeves_job_return (void *job_ptr) {
 
-	if (job_ptr) {
-		JeevesJob *job = (JeevesJob *) job_ptr;
+	// the arena's jobs are released when their request ends
+	if (job_ptr && jeeves_arena_owns (job_ptr)) {
+		free (((JeevesJob *) job_ptr)->images);
+	}
 
-		dlist_reset (job->images);
+	else if (job_ptr) {
+		JeevesJob *job = (JeevesJob *) job_ptr;
 
-		DoubleList *temp = job->images;
+		// keep the images buffer for the next use
+		JobImage *images = job->images;
+		size_t images_capacity = job->images_capacity;
 
 		(void) memset (job, 0, sizeof (JeevesJob));
 
-		job->images = temp;
+		job->images = images;
+		job->images_capacity = images_capacity;
 
 		(void) pool_push (jobs_pool, job_ptr);
 	}
@@ -2,78 +2,460 @@
 #include <stdio.h>
 #include <string.h>
 
-#include <cmongo/crud.h>
-#include <cmongo/select.h>
-
-#include <cerver/collections/dlist.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <time.h>
 
 #include <cerver/utils/log.h>
 
+#include "storage.h"
+
+#include "controllers/roles.h"
+
 #include "models/role.h"
 
-static DoubleList *roles = NULL;
+// must be a power of 2 bigger than JEEVES_ROLES_MAX_ACTIONS
+#define ROLES_ACTIONS_SLOTS				128
 
-const Role *common_role = NULL;
+#define ROLES_MIN_SLOTS					16
 
-const Role *jeeves_role_get_by_name (
-	const char *role_name
-);
+#define ROLES_EMPTY_SLOT				(-1)
 
-static unsigned int jeeves_roles_init_get_roles (void) {
+typedef struct RoleEntry {
 
-	unsigned int retval = 1;
+	Role role;
 
-	CMongoSelect *select = cmongo_select_new ();
-	cmongo_select_insert_field (select, "name");
-
-	uint64_t n_docs = 0;
-	mongoc_cursor_t *roles_cursor = role_find_all (select, &n_docs);
-	if (roles_cursor) {
-		Role *role = NULL;
-		const bson_t *role_doc = NULL;
-		unsigned int errors = 0;
-		while (mongoc_cursor_next (roles_cursor, &role_doc)) {
-			role = role_new ();
-			if (role) {
-				role_doc_parse (role, role_doc);
-
-				errors |= dlist_insert_after (
-					roles,
-					dlist_end (roles),
-					role
-				);
+	// each bit is one of the registered actions
+	uint64_t actions;
+
+} RoleEntry;
+
+// the roles are never modified once the table is published
+typedef struct RolesTable {
+
+	RoleEntry *entries;
+	size_t n_entries;
+	size_t capacity;
+
+	// open addressing indexes into the entries
+	size_t mask;
+	int32_t *by_oid;
+	int32_t *by_name;
+
+	const RoleEntry *common;
+
+	unsigned int errors;
+
+	// lookups that are using the table right now
+	atomic_uint readers;
+
+	// replaced tables are freed without readers & after the grace period
+	time_t retired;
+	struct RolesTable *next;
+
+} RolesTable;
+
+static _Atomic (RolesTable *) roles_table = NULL;
+
+// every action keeps its bit for as long as jeeves runs
+// so the bits that are resolved at route setup survive reloads
+static struct {
+
+	char names[JEEVES_ROLES_MAX_ACTIONS][ROLE_ACTION_SIZE];
+	unsigned int count;
+
+	// the action's bit + 1, 0 for empty slots
+	uint8_t slots[ROLES_ACTIONS_SLOTS];
+
+	pthread_mutex_t mutex;
+
+} roles_actions = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER
+};
+
+static struct {
+
+	// only used by the reload thread & at init or end
+	RolesTable *retired;
+
+	unsigned int reload_interval;
+
+	atomic_bool running;
+	bool thread_created;
+	pthread_t thread;
+
+	sem_t reload;
+
+} roles = { 0 };
+
+static inline size_t roles_name_hash (const char *name) {
+
+	uint32_t hash = 2166136261u;
+	for (const unsigned char *c = (const unsigned char *) name; *c; c++) {
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+
+	return (size_t) hash;
+
+}
+
+// keeps the current table from being freed until it is released
+// the count is checked against the table that is current after it
+// so the reload thread either sees the reader or the reader retries
+static RolesTable *roles_table_acquire (void) {
+
+	RolesTable *table = atomic_load (&roles_table);
+	while (table) {
+		(void) atomic_fetch_add (&table->readers, 1);
+
+		RolesTable *current = atomic_load (&roles_table);
+		if (current == table) break;
+
+		(void) atomic_fetch_sub (&table->readers, 1);
+		table = current;
+	}
+
+	return table;
+
+}
+
+static inline void roles_table_release (RolesTable *table) {
+
+	if (table) (void) atomic_fetch_sub (&table->readers, 1);
+
+}
+
+static void roles_table_delete (RolesTable *table) {
+
+	if (table) {
+		free (table->entries);
+		free (table->by_oid);
+		free (table->by_name);
+		free (table);
+	}
+
+}
+
+static RolesTable *roles_table_new (void) {
+
+	return (RolesTable *) calloc (1, sizeof (RolesTable));
+
+}
+
+// returns the action's bit, registering it if it is new
+// must be called with the actions mutex held
+static JeevesRoleAction roles_actions_add (const char *action) {
+
+	JeevesRoleAction retval = JEEVES_ROLE_ACTION_NONE;
+
+	size_t slot = roles_name_hash (action) & (ROLES_ACTIONS_SLOTS - 1);
+	while (roles_actions.slots[slot]) {
+		const int bit = roles_actions.slots[slot] - 1;
+		if (!strcmp (roles_actions.names[bit], action)) {
+			retval = bit;
+			break;
+		}
+
+		slot = (slot + 1) & (ROLES_ACTIONS_SLOTS - 1);
+	}
+
+	if (
+		(retval == JEEVES_ROLE_ACTION_NONE)
+		&& (roles_actions.count < JEEVES_ROLES_MAX_ACTIONS)
+	) {
+		retval = (JeevesRoleAction) roles_actions.count++;
+		(void) strncpy (roles_actions.names[retval], action, ROLE_ACTION_SIZE - 1);
+
+		roles_actions.slots[slot] = (uint8_t) (retval + 1);
+	}
+
+	return retval;
+
+}
+
+static bool roles_table_add_role (void *table_ptr, const Role *role) {
+
+	RolesTable *table = (RolesTable *) table_ptr;
+
+	bool retval = true;
+
+	if (table->n_entries == table->capacity) {
+		size_t capacity = table->capacity ? table->capacity * 2 : ROLES_MIN_SLOTS;
+		RoleEntry *entries = (RoleEntry *) realloc (
+			table->entries, capacity * sizeof (RoleEntry)
+		);
+
+		if (entries) {
+			table->entries = entries;
+			table->capacity = capacity;
+		}
+
+		else {
+			table->errors |= 1;
+			retval = false;
+		}
+	}
+
+	if (retval) {
+		RoleEntry *entry = &table->entries[table->n_entries++];
+		(void) memcpy (&entry->role, role, sizeof (Role));
+		entry->actions = 0;
+
+		(void) pthread_mutex_lock (&roles_actions.mutex);
+
+		for (unsigned int i = 0; i < role->n_actions; i++) {
+			JeevesRoleAction bit = roles_actions_add (role->actions[i]);
+			if (bit != JEEVES_ROLE_ACTION_NONE) {
+				entry->actions |= (uint64_t) 1 << bit;
 			}
 
 			else {
+				cerver_log_warning (
+					"Role %s action %s is past the %d actions limit!",
+					role->name, role->actions[i], JEEVES_ROLES_MAX_ACTIONS
+				);
+			}
+		}
+
+		(void) pthread_mutex_unlock (&roles_actions.mutex);
+	}
+
+	return retval;
+
+}
+
+static unsigned int roles_table_index (RolesTable *table) {
+
+	unsigned int retval = 1;
+
+	size_t slots = ROLES_MIN_SLOTS;
+	while (slots < (table->n_entries * 2)) slots *= 2;
+
+	table->mask = slots - 1;
+	table->by_oid = (int32_t *) malloc (slots * sizeof (int32_t));
+	table->by_name = (int32_t *) malloc (slots * sizeof (int32_t));
+
+	if (table->by_oid && table->by_name) {
+		for (size_t i = 0; i < slots; i++) {
+			table->by_oid[i] = ROLES_EMPTY_SLOT;
+			table->by_name[i] = ROLES_EMPTY_SLOT;
+		}
+
+		for (size_t i = 0; i < table->n_entries; i++) {
+			const Role *role = &table->entries[i].role;
+
+			size_t slot = (size_t) bson_oid_hash (&role->oid) & table->mask;
+			while (table->by_oid[slot] != ROLES_EMPTY_SLOT) slot = (slot + 1) & table->mask;
+			table->by_oid[slot] = (int32_t) i;
+
+			slot = roles_name_hash (role->name) & table->mask;
+			while (table->by_name[slot] != ROLES_EMPTY_SLOT) slot = (slot + 1) & table->mask;
+			table->by_name[slot] = (int32_t) i;
+		}
+
+		retval = 0;
+	}
+
+	return retval;
+
+}
+
+static const RoleEntry *roles_table_get_by_oid (
+	const RolesTable *table, const bson_oid_t *role_oid
+) {
+
+	const RoleEntry *retval = NULL;
+
+	size_t slot = (size_t) bson_oid_hash (role_oid) & table->mask;
+	while (table->by_oid[slot] != ROLES_EMPTY_SLOT) {
+		const RoleEntry *entry = &table->entries[table->by_oid[slot]];
+		if (bson_oid_equal (&entry->role.oid, role_oid)) {
+			retval = entry;
+			break;
+		}
+
+		slot = (slot + 1) & table->mask;
+	}
+
+	return retval;
+
+}
+
+static const RoleEntry *roles_table_get_by_name (
+	const RolesTable *table, const char *role_name
+) {
+
+	const RoleEntry *retval = NULL;
+
+	size_t slot = roles_name_hash (role_name) & table->mask;
+	while (table->by_name[slot] != ROLES_EMPTY_SLOT) {
+		const RoleEntry *entry = &table->entries[table->by_name[slot]];
+		if (!strcmp (entry->role.name, role_name)) {
+			retval = entry;
+			break;
+		}
+
+		slot = (slot + 1) & table->mask;
+	}
+
+	return retval;
+
+}
+
+// builds a new table with every role from the storage
+static RolesTable *roles_table_load (void) {
+
+	RolesTable *table = roles_table_new ();
+	if (table) {
+		unsigned int errors = jeeves_storage->roles_get_all (
+			roles_table_add_role, table
+		);
+
+		errors |= table->errors;
+		if (!errors) errors |= roles_table_index (table);
+
+		if (!errors) {
+			table->common = roles_table_get_by_name (table, "common");
+			if (!table->common) {
+				cerver_log_error ("Failed to get common role!");
 				errors |= 1;
 			}
 		}
 
-		mongoc_cursor_destroy (roles_cursor);
+		if (errors) {
+			roles_table_delete (table);
+			table = NULL;
+		}
+	}
+
+	return table;
 
-		retval = errors;
+}
+
+// frees the replaced tables that have no readers left
+// the grace period covers the readers that loaded the table
+// right before it was replaced & have not counted themselves yet
+static void roles_retired_collect (const bool force) {
+
+	const time_t now = time (NULL);
+
+	RolesTable **link = &roles.retired;
+	while (*link) {
+		RolesTable *table = *link;
+		if (
+			force || (
+				((table->retired + JEEVES_ROLES_GRACE) <= now)
+				&& !atomic_load (&table->readers)
+			)
+		) {
+			*link = table->next;
+			roles_table_delete (table);
+		}
+
+		else {
+			link = &table->next;
+		}
 	}
 
-	else {
-		(void) fprintf (stderr, "Failed to get roles cursor!");
+}
+
+// publishes a new table & keeps the current one until
+// the requests that are using its roles are done
+static unsigned int roles_reload (void) {
+
+	unsigned int retval = 1;
+
+	RolesTable *table = roles_table_load ();
+	if (table) {
+		RolesTable *old = atomic_exchange (&roles_table, table);
+
+		if (old) {
+			old->retired = time (NULL);
+			old->next = roles.retired;
+			roles.retired = old;
+		}
+
+		roles_retired_collect (false);
+
+		(void) pthread_mutex_lock (&roles_actions.mutex);
+		const unsigned int n_actions = roles_actions.count;
+		(void) pthread_mutex_unlock (&roles_actions.mutex);
+
+		cerver_log_success (
+			"Loaded %zu roles with %u actions!",
+			table->n_entries, n_actions
+		);
+
+		retval = 0;
 	}
 
-	cmongo_select_delete (select);
+	else {
+		cerver_log_error ("Failed to get roles - keeping the current ones!");
+	}
 
 	return retval;
 
 }
 
-unsigned int jeeves_roles_init (void) {
+static void *jeeves_roles_reload_thread (void *data) {
+
+	while (atomic_load (&roles.running)) {
+		int waited = 0;
+		if (roles.reload_interval) {
+			struct timespec timeout = { 0 };
+			(void) clock_gettime (CLOCK_REALTIME, &timeout);
+			timeout.tv_sec += (time_t) roles.reload_interval;
+
+			waited = sem_timedwait (&roles.reload, &timeout);
+		}
+
+		else {
+			waited = sem_wait (&roles.reload);
+		}
+
+		if (atomic_load (&roles.running) && (!waited || (errno == ETIMEDOUT))) {
+			(void) roles_reload ();
+		}
+	}
+
+	return NULL;
+
+}
+
+// signal handler that wakes up the reload thread
+void jeeves_roles_reload_signal (int signum) {
+
+	(void) signum;
+
+	if (roles.thread_created) (void) sem_post (&roles.reload);
+
+}
+
+// loads the roles & reloads them every reload_interval seconds
+// a value of 0 only reloads them on SIGHUP
+unsigned int jeeves_roles_init (const unsigned int reload_interval) {
 
 	unsigned int retval = 1;
 
-	roles = dlist_init (role_delete, NULL);
-	if (!jeeves_roles_init_get_roles ()) {
-		common_role = jeeves_role_get_by_name ("common");
-		if (common_role) {
-			retval = 0;
+	if (!roles_reload ()) {
+		roles.reload_interval = reload_interval;
+		atomic_store (&roles.running, true);
+
+		if (
+			!sem_init (&roles.reload, 0, 0)
+			&& !pthread_create (&roles.thread, NULL, jeeves_roles_reload_thread, NULL)
+		) {
+			roles.thread_created = true;
 		}
+
+		else {
+			cerver_log_warning ("Failed to create roles reload thread!");
+		}
+
+		retval = 0;
 	}
 
 	return retval;
@@ -82,57 +464,152 @@ unsigned int jeeves_roles_init (void) {
 
 void jeeves_roles_end (void) {
 
-	dlist_delete (roles);
+	if (roles.thread_created) {
+		atomic_store (&roles.running, false);
+		(void) sem_post (&roles.reload);
+		(void) pthread_join (roles.thread, NULL);
+
+		roles.thread_created = false;
+		(void) sem_destroy (&roles.reload);
+	}
+
+	roles_retired_collect (true);
+
+	roles_table_delete (atomic_exchange (&roles_table, NULL));
 
 }
 
-const Role *jeeves_role_get_by_oid (const bson_oid_t *role_oid) {
+// copies the oid of the role that is assigned to new users
+// returns 0 on success, 1 if the roles are not loaded
+unsigned int jeeves_role_common_oid (bson_oid_t *role_oid) {
 
-	const Role *retval = NULL;
+	unsigned int retval = 1;
 
-	if (role_oid) {
-		for (ListElement *le = dlist_start (roles); le; le = le->next) {
-			if (!bson_oid_compare (&((Role *) le->data)->oid, role_oid)) {
-				retval = ((Role *) le->data);
-				break;
-			}
+	RolesTable *table = roles_table_acquire ();
+	if (table) {
+		bson_oid_copy (&table->common->role.oid, role_oid);
+		retval = 0;
+	}
+
+	roles_table_release (table);
+
+	return retval;
+
+}
+
+// copies the role with the oid
+// returns 0 on success, 1 if it was not found
+unsigned int jeeves_role_get_by_oid (
+	const bson_oid_t *role_oid, Role *role
+) {
+
+	unsigned int retval = 1;
+
+	RolesTable *table = roles_table_acquire ();
+	if (table && role_oid) {
+		const RoleEntry *entry = roles_table_get_by_oid (table, role_oid);
+		if (entry) {
+			(void) memcpy (role, &entry->role, sizeof (Role));
+			retval = 0;
 		}
 	}
 
+	roles_table_release (table);
+
 	return retval;
 
 }
 
-const Role *jeeves_role_get_by_name (
-	const char *role_name
+// copies the role with the name
+// returns 0 on success, 1 if it was not found
+unsigned int jeeves_role_get_by_name (
+	const char *role_name, Role *role
 ) {
 
-	const Role *retval = NULL;
+	unsigned int retval = 1;
 
-	if (role_name) {
-		for (ListElement *le = dlist_start (roles); le; le = le->next) {
-			if (!strcmp (((Role *) le->data)->name, role_name)) {
-				retval = ((Role *) le->data);
-				break;
-			}
+	RolesTable *table = roles_table_acquire ();
+	if (table && role_name) {
+		const RoleEntry *entry = roles_table_get_by_name (table, role_name);
+		if (entry) {
+			(void) memcpy (role, &entry->role, sizeof (Role));
+			retval = 0;
 		}
 	}
 
+	roles_table_release (table);
+
+	return retval;
+
+}
+
+// copies the name of the role with the oid
+// into a buffer of ROLE_NAME_SIZE bytes
+// returns 0 on success, 1 if it was not found
+unsigned int jeeves_role_name_get_by_oid (
+	const bson_oid_t *role_oid, char *role_name
+) {
+
+	unsigned int retval = 1;
+
+	RolesTable *table = roles_table_acquire ();
+	if (table && role_oid) {
+		const RoleEntry *entry = roles_table_get_by_oid (table, role_oid);
+		if (entry) {
+			(void) strncpy (role_name, entry->role.name, ROLE_NAME_SIZE - 1);
+			role_name[ROLE_NAME_SIZE - 1] = '\0';
+			retval = 0;
+		}
+	}
+
+	roles_table_release (table);
+
 	return retval;
 
 }
 
-const char *jeeves_role_name_get_by_oid (
-	const bson_oid_t *role_oid
+// resolves the action's bit to be used by every check
+// must be called once when setting up the routes
+JeevesRoleAction jeeves_roles_action_get (const char *action) {
+
+	JeevesRoleAction retval = JEEVES_ROLE_ACTION_NONE;
+
+	if (action) {
+		(void) pthread_mutex_lock (&roles_actions.mutex);
+		retval = roles_actions_add (action);
+		(void) pthread_mutex_unlock (&roles_actions.mutex);
+
+		if (retval == JEEVES_ROLE_ACTION_NONE) {
+			cerver_log_warning (
+				"Action %s is past the %d actions limit!",
+				action, JEEVES_ROLES_MAX_ACTIONS
+			);
+		}
+	}
+
+	return retval;
+
+}
+
+// returns true if the role with the oid is allowed to perform the action
+bool jeeves_role_oid_has_action (
+	const bson_oid_t *role_oid, const JeevesRoleAction action
 ) {
 
-	const char *retval = NULL;
+	bool retval = false;
 
-	const Role *role = jeeves_role_get_by_oid (role_oid);
-	if (role) {
-		retval = role->name;
+	if (role_oid && (action > JEEVES_ROLE_ACTION_NONE)) {
+		RolesTable *table = roles_table_acquire ();
+		if (table) {
+			const RoleEntry *entry = roles_table_get_by_oid (table, role_oid);
+			if (entry) {
+				retval = (entry->actions & ((uint64_t) 1 << action)) != 0;
+			}
+		}
+
+		roles_table_release (table);
 	}
 
 	return retval;
 
-}
\ No newline at end of file
+}
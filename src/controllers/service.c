@@ -9,6 +9,9 @@
 #include "version.h"
 
 HttpResponse *missing_values = NULL;
+HttpResponse *bad_image = NULL;
+
+HttpResponse *server_busy = NULL;
 
 HttpResponse *jeeves_works = NULL;
 HttpResponse *current_version = NULL;
@@ -23,6 +26,14 @@ unsigned int jeeves_service_init (void) {
 		HTTP_STATUS_BAD_REQUEST, "error", "Missing values!"
 	);
 
+	bad_image = http_response_json_key_value (
+		HTTP_STATUS_BAD_REQUEST, "error", "Bad image!"
+	);
+
+	server_busy = http_response_json_key_value (
+		HTTP_STATUS_SERVICE_UNAVAILABLE, "error", "Server busy!"
+	);
+
 	jeeves_works = http_response_json_key_value (
 		HTTP_STATUS_OK, "msg", "Jeeves works!"
 	);
@@ -44,7 +55,8 @@ unsigned int jeeves_service_init (void) {
 	);
 
 	if (
-		missing_values
+		missing_values && bad_image
+		&& server_busy
 		&& jeeves_works && current_version
 		&& catch_all
 	) retval = 0;
@@ -56,6 +68,9 @@ unsigned int jeeves_service_init (void) {
 void jeeves_service_end (void) {
 
 	http_response_delete (missing_values);
+	http_response_delete (bad_image);
+
+	http_response_delete (server_busy);
 
 	http_response_delete (jeeves_works);
 	http_response_delete (current_version);
@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <sys/stat.h>
+
+#include <cerver/http/response.h>
+
+#include <cerver/utils/log.h>
+
+#include "controllers/uploads.h"
+
+static UploadFile files_cache[JEEVES_UPLOADS_FILES_CACHE_SIZE] = { 0 };
+static unsigned long files_cache_clock = 0;
+static pthread_mutex_t files_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+HttpResponse *upload_not_found = NULL;
+
+unsigned int jeeves_uploads_init (void) {
+
+	unsigned int retval = 1;
+
+	for (unsigned int i = 0; i < JEEVES_UPLOADS_FILES_CACHE_SIZE; i++) {
+		files_cache[i].fd = -1;
+	}
+
+	upload_not_found = http_response_json_key_value (
+		HTTP_STATUS_NOT_FOUND, "msg", "File was not found"
+	);
+
+	if (upload_not_found) retval = 0;
+
+	return retval;
+
+}
+
+void jeeves_uploads_end (void) {
+
+	(void) pthread_mutex_lock (&files_cache_mutex);
+
+	for (unsigned int i = 0; i < JEEVES_UPLOADS_FILES_CACHE_SIZE; i++) {
+		if (files_cache[i].fd >= 0) {
+			(void) close (files_cache[i].fd);
+			files_cache[i].fd = -1;
+		}
+	}
+
+	(void) pthread_mutex_unlock (&files_cache_mutex);
+
+	http_response_delete (upload_not_found);
+
+}
+
+static unsigned int jeeves_uploads_file_hash (const char *path) {
+
+	unsigned int hash = 2166136261u;
+	for (const char *p = path; *p; p++) {
+		hash = (hash ^ (unsigned char) *p) * 16777619u;
+	}
+
+	return hash;
+
+}
+
+static inline bool jeeves_uploads_file_changed (
+	const struct stat *cached, const struct stat *current
+) {
+
+	return (cached->st_ino != current->st_ino)
+		|| (cached->st_dev != current->st_dev)
+		|| (cached->st_size != current->st_size)
+		|| (cached->st_mtim.tv_sec != current->st_mtim.tv_sec)
+		|| (cached->st_mtim.tv_nsec != current->st_mtim.tv_nsec);
+
+}
+
+static unsigned int jeeves_uploads_file_load (
+	UploadFile *file, const char *path, const unsigned int hash
+) {
+
+	unsigned int retval = 1;
+
+	int fd = open (path, O_RDONLY | O_CLOEXEC);
+	if (fd >= 0) {
+		if (!fstat (fd, &file->st) && S_ISREG (file->st.st_mode)) {
+			(void) strncpy (file->path, path, JEEVES_UPLOADS_FILE_PATH_SIZE - 1);
+			file->hash = hash;
+			file->fd = fd;
+			file->content_type = jeeves_uploads_file_content_type (path);
+
+			(void) snprintf (
+				file->etag, JEEVES_UPLOADS_FILE_ETAG_SIZE,
+				"\"%lx-%lx-%lx\"",
+				(unsigned long) file->st.st_ino,
+				(unsigned long) file->st.st_size,
+				(unsigned long) (file->st.st_mtim.tv_sec * 1000000000L + file->st.st_mtim.tv_nsec)
+			);
+
+			retval = 0;
+		}
+
+		else {
+			(void) close (fd);
+		}
+	}
+
+	return retval;
+
+}
+
+// returns a file that is not stored in the cache
+// used when every cache entry is being used
+static const UploadFile *jeeves_uploads_file_open_uncached (
+	const char *path, const unsigned int hash
+) {
+
+	UploadFile *file = (UploadFile *) malloc (sizeof (UploadFile));
+	if (file) {
+		(void) memset (file, 0, sizeof (UploadFile));
+		if (jeeves_uploads_file_load (file, path, hash)) {
+			free (file);
+			file = NULL;
+		}
+	}
+
+	return file;
+
+}
+
+static UploadFile *jeeves_uploads_file_cache_get (
+	const char *path, const unsigned int hash
+) {
+
+	UploadFile *file = NULL;
+
+	for (unsigned int i = 0; i < JEEVES_UPLOADS_FILES_CACHE_SIZE; i++) {
+		if (
+			(files_cache[i].fd >= 0)
+			&& (files_cache[i].hash == hash)
+			&& !strcmp (files_cache[i].path, path)
+		) {
+			file = &files_cache[i];
+			break;
+		}
+	}
+
+	return file;
+
+}
+
+// gets an unused entry, evicting the least recently used one
+static UploadFile *jeeves_uploads_file_cache_get_free (void) {
+
+	UploadFile *file = NULL;
+
+	for (unsigned int i = 0; i < JEEVES_UPLOADS_FILES_CACHE_SIZE; i++) {
+		if (files_cache[i].fd < 0) {
+			file = &files_cache[i];
+			break;
+		}
+
+		if (
+			!files_cache[i].refs
+			&& (!file || (files_cache[i].last_used < file->last_used))
+		) {
+			file = &files_cache[i];
+		}
+	}
+
+	if (file && (file->fd >= 0)) {
+		(void) close (file->fd);
+		file->fd = -1;
+	}
+
+	return file;
+
+}
+
+// gets an open file descriptor for the requested upload
+// reuses cached descriptors if the file has not changed
+const UploadFile *jeeves_uploads_file_open (
+	const char *path
+) {
+
+	const UploadFile *retval = NULL;
+
+	// the file might have been replaced since it was cached
+	struct stat current = { 0 };
+	if (path && !stat (path, &current)) {
+		unsigned int hash = jeeves_uploads_file_hash (path);
+
+		(void) pthread_mutex_lock (&files_cache_mutex);
+
+		UploadFile *file = jeeves_uploads_file_cache_get (path, hash);
+		if (file && jeeves_uploads_file_changed (&file->st, &current)) {
+			if (!file->refs) {
+				(void) close (file->fd);
+				file->fd = -1;
+			}
+
+			else {
+				// keep it open for current readers
+				// until it gets evicted
+				file->path[0] = '\0';
+				file->hash = 0;
+			}
+
+			file = NULL;
+		}
+
+		if (!file) {
+			file = jeeves_uploads_file_cache_get_free ();
+			if (file && jeeves_uploads_file_load (file, path, hash)) {
+				file->fd = -1;
+				file = NULL;
+			}
+
+			else if (file) {
+				file->cached = true;
+			}
+		}
+
+		if (file) {
+			file->refs += 1;
+			file->last_used = ++files_cache_clock;
+			retval = file;
+		}
+
+		(void) pthread_mutex_unlock (&files_cache_mutex);
+
+		if (!retval) {
+			retval = jeeves_uploads_file_open_uncached (path, hash);
+		}
+	}
+
+	return retval;
+
+}
+
+// releases the file that was returned by jeeves_uploads_file_open ()
+void jeeves_uploads_file_close (
+	const UploadFile *file
+) {
+
+	if (file) {
+		if (file->cached) {
+			(void) pthread_mutex_lock (&files_cache_mutex);
+			((UploadFile *) file)->refs -= 1;
+			(void) pthread_mutex_unlock (&files_cache_mutex);
+		}
+
+		else {
+			(void) close (file->fd);
+			free ((UploadFile *) file);
+		}
+	}
+
+}
+
+// returns the file's content type based on its extension
+const char *jeeves_uploads_file_content_type (
+	const char *path
+) {
+
+	const char *content_type = "application/octet-stream";
+
+	const char *ext = strrchr (path, '.');
+	if (ext) {
+		ext += 1;
+		if (!strcasecmp (ext, "jpg") || !strcasecmp (ext, "jpeg")) content_type = "image/jpeg";
+		else if (!strcasecmp (ext, "png")) content_type = "image/png";
+		else if (!strcasecmp (ext, "bmp")) content_type = "image/bmp";
+		else if (!strcasecmp (ext, "gif")) content_type = "image/gif";
+		else if (!strcasecmp (ext, "tga")) content_type = "image/x-tga";
+	}
+
+	return content_type;
+
+}
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <stdatomic.h>
+
 #include <cerver/types/string.h>
 
 #include <cerver/collections/dlist.h>
@@ -19,7 +21,10 @@
 #include <cmongo/crud.h>
 #include <cmongo/select.h>
 
+#include "arena.h"
+#include "body.h"
 #include "jeeves.h"
+#include "storage.h"
 
 #include "controllers/roles.h"
 #include "controllers/users.h"
@@ -28,6 +33,9 @@
 
 static Pool *users_pool = NULL;
 
+// users that are in the pool right now
+static atomic_size_t users_pool_count = 0;
+
 const bson_t *user_login_query_opts = NULL;
 static CMongoSelect *user_login_select = NULL;
 
@@ -53,8 +61,9 @@ static unsigned int jeeves_users_init_pool (void) {
 	users_pool = pool_create (user_delete);
 	if (users_pool) {
 		pool_set_create (users_pool, user_new);
-		pool_set_produce_if_empty (users_pool, true);
+		pool_set_produce_if_empty (users_pool, false);
 		if (!pool_init (users_pool, user_new, DEFAULT_USERS_POOL_INIT)) {
+			atomic_store (&users_pool_count, DEFAULT_USERS_POOL_INIT);
 			retval = 0;
 		}
 
@@ -71,6 +80,44 @@ static unsigned int jeeves_users_init_pool (void) {
 
 }
 
+// gets a user that can outlive the request
+static User *jeeves_users_pool_pop (void) {
+
+	User *user = (User *) pool_pop (users_pool);
+	if (user) (void) atomic_fetch_sub (&users_pool_count, 1);
+	else user = (User *) user_new ();
+
+	return user;
+
+}
+
+// keeps the user only if the pool is not full
+static void jeeves_users_pool_push (User *user) {
+
+	(void) memset (user, 0, sizeof (User));
+
+	if (atomic_fetch_add (&users_pool_count, 1) < DEFAULT_USERS_POOL_MAX) {
+		(void) pool_push (users_pool, user);
+	}
+
+	else {
+		(void) atomic_fetch_sub (&users_pool_count, 1);
+		user_delete (user);
+	}
+
+}
+
+// users that are only used by the request's handler
+// are taken from its arena instead of the pool
+static User *jeeves_users_get (void) {
+
+	User *user = (User *) jeeves_arena_calloc (sizeof (User));
+	if (!user) user = jeeves_users_pool_pop ();
+
+	return user;
+
+}
+
 static unsigned int jeeves_users_init_query_opts (void) {
 
 	unsigned int retval = 1;
@@ -190,7 +237,7 @@ User *jeeves_user_create (
 	const bson_oid_t *role_oid
 ) {
 
-	User *user = (User *) pool_pop (users_pool);
+	User *user = jeeves_users_get ();
 	if (user) {
 		bson_oid_init (&user->oid, NULL);
 		bson_oid_to_string (&user->oid, user->id);
@@ -209,7 +256,7 @@ User *jeeves_user_create (
 
 User *jeeves_user_get (void) {
 
-	return (User *) pool_pop (users_pool);
+	return jeeves_users_get ();
 
 }
 
@@ -217,10 +264,10 @@ User *jeeves_user_get_by_email (const char *email) {
 
 	User *user = NULL;
 	if (email) {
-		user = (User *) pool_pop (users_pool);
+		user = jeeves_users_get ();
 		if (user) {
-			if (user_get_by_email (user, email, user_login_query_opts)) {
-				(void) pool_push (users_pool, user);
+			if (jeeves_storage->user_get_by_email (user, email, user_login_query_opts)) {
+				jeeves_user_delete (user);
 				user = NULL;
 			}
 		}
@@ -234,7 +281,7 @@ u8 jeeves_user_check_by_email (
 	const char *email
 ) {
 
-	return user_check_by_email (email);
+	return jeeves_storage->user_check_by_email (email);
 
 }
 
@@ -246,45 +293,61 @@ u8 jeeves_user_check_by_email (
 //   "role": "god",
 //   "username": "erick"
 // }
-void *jeeves_user_parse_from_json (void *user_json_ptr) {
+// fills the user with the values of a token's payload
+// returns 0 on success, 1 on error
+unsigned int jeeves_user_parse_json (User *user, void *user_json_ptr) {
+
+	unsigned int retval = 1;
 
 	json_t *user_json = (json_t *) user_json_ptr;
 
-	User *user = user_new ();
-	if (user) {
-		const char *email = NULL;
-		const char *id = NULL;
-		const char *name = NULL;
-		const char *role = NULL;
-		const char *username = NULL;
-
-		if (!json_unpack (
-			user_json,
-			"{s:s, s:i, s:s, s:s, s:s, s:s}",
-			"email", &email,
-			"iat", &user->iat,
-			"id", &id,
-			"name", &name,
-			"role", &role,
-			"username", &username
-		)) {
-			(void) strncpy (user->email, email, USER_EMAIL_SIZE - 1);
-			(void) strncpy (user->id, id, USER_ID_SIZE - 1);
-			(void) strncpy (user->name, name, USER_NAME_SIZE - 1);
-			(void) strncpy (user->role, role, USER_ROLE_SIZE - 1);
-			(void) strncpy (user->username, username, USER_USERNAME_SIZE - 1);
+	const char *email = NULL;
+	const char *id = NULL;
+	const char *name = NULL;
+	const char *role = NULL;
+	const char *username = NULL;
 
-			bson_oid_init_from_string (&user->oid, user->id);
+	if (!json_unpack (
+		user_json,
+		"{s:s, s:i, s:s, s:s, s:s, s:s}",
+		"email", &email,
+		"iat", &user->iat,
+		"id", &id,
+		"name", &name,
+		"role", &role,
+		"username", &username
+	)) {
+		(void) strncpy (user->email, email, USER_EMAIL_SIZE - 1);
+		(void) strncpy (user->id, id, USER_ID_SIZE - 1);
+		(void) strncpy (user->name, name, USER_NAME_SIZE - 1);
+		(void) strncpy (user->role, role, USER_ROLE_SIZE - 1);
+		(void) strncpy (user->username, username, USER_USERNAME_SIZE - 1);
 
-			if (RUNTIME == RUNTIME_TYPE_DEVELOPMENT) {
-				user_print (user);
-			}
+		bson_oid_init_from_string (&user->oid, user->id);
+
+		if (RUNTIME == RUNTIME_TYPE_DEVELOPMENT) {
+			user_print (user);
 		}
 
-		else {
-			cerver_log_error ("user_parse_from_json () - json_unpack () has failed!");
+		retval = 0;
+	}
+
+	else {
+		cerver_log_error ("user_parse_json () - json_unpack () has failed!");
+	}
+
+	return retval;
+
+}
+
+// the decoded user is deleted by cerver after the handler's scope
+// so it always comes from the pool
+void *jeeves_user_parse_from_json (void *user_json_ptr) {
 
-			(void) pool_push (users_pool, user);
+	User *user = jeeves_users_pool_pop ();
+	if (user) {
+		if (jeeves_user_parse_json (user, user_json_ptr)) {
+			jeeves_users_pool_push (user);
 			user = NULL;
 		}
 	}
@@ -299,13 +362,16 @@ unsigned int jeeves_user_generate_token (
 
 	unsigned int retval = 1;
 
+	char role_name[ROLE_NAME_SIZE] = { 0 };
+	(void) jeeves_role_name_get_by_oid (&user->role_oid, role_name);
+
 	HttpJwt *http_jwt = http_cerver_auth_jwt_new ();
 	if (http_jwt) {
 		http_cerver_auth_jwt_add_value_int (http_jwt, "iat", time (NULL));
 		http_cerver_auth_jwt_add_value (http_jwt, "id", user->id);
 		http_cerver_auth_jwt_add_value (http_jwt, "email", user->email);
 		http_cerver_auth_jwt_add_value (http_jwt, "name", user->name);
-		http_cerver_auth_jwt_add_value (http_jwt, "role", jeeves_role_name_get_by_oid (&user->role_oid));
+		http_cerver_auth_jwt_add_value (http_jwt, "role", role_name);
 		http_cerver_auth_jwt_add_value (http_jwt, "username", user->username);
 
 		// generate & send back auth token
@@ -323,72 +389,39 @@ unsigned int jeeves_user_generate_token (
 
 }
 
-static void users_input_parse_json (
-	json_t *json_body,
-	const char **name,
-	const char **username,
-	const char **email,
-	const char **password,
-	const char **confirm
-) {
+// POST /api/users/register
+typedef struct UsersInputValues {
 
-	// get values from json to create a new transaction
-	char *string = NULL;
-	const char *key = NULL;
-	json_t *value = NULL;
-	if (json_typeof (json_body) == JSON_OBJECT) {
-		json_object_foreach (json_body, key, value) {
-			if (!strcmp (key, "name")) {
-				string = (char *) json_string_value (value);
-				if (strlen (string)) {
-					*name = string;
-					#ifdef JEEVES_DEBUG
-					(void) printf ("name: \"%s\"\n", *name);
-					#endif
-				}
-			}
+	char name[USER_NAME_SIZE];
+	char username[USER_USERNAME_SIZE];
+	char email[USER_EMAIL_SIZE];
+	char password[USER_PASSWORD_SIZE];
+	char confirm[USER_PASSWORD_SIZE];
 
-			else if (!strcmp (key, "username")) {
-				string = (char *) json_string_value (value);
-				if (strlen (string)) {
-					*username = string;
-					#ifdef JEEVES_DEBUG
-					(void) printf ("username: \"%s\"\n", *username);
-					#endif
-				}
-			}
+} UsersInputValues;
 
-			else if (!strcmp (key, "email")) {
-				string = (char *) json_string_value (value);
-				if (strlen (string)) {
-					*email = string;
-					#ifdef JEEVES_DEBUG
-					(void) printf ("email: \"%s\"\n", *email);
-					#endif
-				}
-			}
+static const JeevesBodyField users_register_fields[] = {
+	JEEVES_BODY_STRING ("name", UsersInputValues, name),
+	JEEVES_BODY_STRING ("username", UsersInputValues, username),
+	JEEVES_BODY_STRING ("email", UsersInputValues, email),
+	JEEVES_BODY_STRING ("password", UsersInputValues, password),
+	JEEVES_BODY_STRING ("confirm", UsersInputValues, confirm)
+};
 
-			else if (!strcmp (key, "password")) {
-				string = (char *) json_string_value (value);
-				if (strlen (string)) {
-					*password = string;
-					#ifdef JEEVES_DEBUG
-					(void) printf ("password: \"%s\"\n", *password);
-					#endif
-				}
-			}
+#define USERS_REGISTER_FIELDS			5
 
-			else if (!strcmp (key, "confirm")) {
-				string = (char *) json_string_value (value);
-				if (strlen (string)) {
-					*confirm = string;
-					#ifdef JEEVES_DEBUG
-					(void) printf ("confirm: \"%s\"\n", *confirm);
-					#endif
-				}
-			}
-		}
-	}
+// POST /api/users/login
+static const JeevesBodyField users_login_fields[] = {
+	JEEVES_BODY_STRING ("email", User, email),
+	JEEVES_BODY_STRING ("password", User, password)
+};
+
+#define USERS_LOGIN_FIELDS				2
+
+// empty values are handled as missing
+static inline const char *users_input_value (const char *value) {
+
+	return value[0] ? value : NULL;
 
 }
 
@@ -449,23 +482,19 @@ static JeevesUserError jeeves_user_register_parse_json (
 
 	JeevesUserError error = JEEVES_USER_ERROR_NONE;
 
-	const char *name = NULL;
-	const char *username = NULL;
-	const char *email = NULL;
-	const char *password = NULL;
-	const char *confirm = NULL;
-
-	json_error_t json_error =  { 0 };
-	json_t *json_body = json_loads (request_body->str, 0, &json_error);
-	if (json_body) {
-		users_input_parse_json (
-			json_body,
-			&name,
-			&username,
-			&email,
-			&password,
-			&confirm
-		);
+	UsersInputValues values = { 0 };
+
+	uint32_t found = 0;
+	if (!jeeves_body_parse (
+		request_body,
+		users_register_fields, USERS_REGISTER_FIELDS,
+		&values, &found
+	)) {
+		const char *name = users_input_value (values.name);
+		const char *username = users_input_value (values.username);
+		const char *email = users_input_value (values.email);
+		const char *password = users_input_value (values.password);
+		const char *confirm = users_input_value (values.confirm);
 
 		error = jeeves_user_register_validate_input (
 			input,
@@ -476,25 +505,27 @@ static JeevesUserError jeeves_user_register_parse_json (
 			confirm
 		);
 
+		bson_oid_t role_oid = { 0 };
+		if (error == JEEVES_USER_ERROR_NONE) {
+			if (jeeves_role_common_oid (&role_oid)) {
+				error = JEEVES_USER_ERROR_SERVER_ERROR;
+			}
+		}
+
 		if (error == JEEVES_USER_ERROR_NONE) {
 			*user = jeeves_user_create (
 				name,
 				username,
 				email,
 				password,
-				&common_role->oid
+				&role_oid
 			);
 		}
-
-		json_decref (json_body);
 	}
 
 	else {
 		#ifdef JEEVES_DEBUG
-		cerver_log_error (
-			"json_loads () - json error on line %d: %s\n", 
-			json_error.line, json_error.text
-		);
+		cerver_log_error ("jeeves_user_register_parse_json () - bad json body!");
 		#endif
 
 		error = JEEVES_USER_ERROR_BAD_REQUEST;
@@ -519,7 +550,7 @@ User *jeeves_user_register (
 
 		if (*error == JEEVES_USER_ERROR_NONE) {
 			if (user) {
-				if (!user_insert_one (user)) {
+				if (!jeeves_storage->user_insert_one (user)) {
 					retval = user;
 				}
 
@@ -560,6 +591,7 @@ static JeevesUserInput jeeves_user_login_validate_input_internal (
 
 }
 
+// the values are copied straight into the user
 static JeevesUserError jeeves_user_login_parse_json (
 	const String *request_body, JeevesUserInput *input,
 	User *user_values
@@ -567,46 +599,25 @@ static JeevesUserError jeeves_user_login_parse_json (
 
 	JeevesUserError error = JEEVES_USER_ERROR_NONE;
 
-	const char *name = NULL;
-	const char *username = NULL;
-	const char *email = NULL;
-	const char *password = NULL;
-	const char *confirm = NULL;
-
-	json_error_t json_error =  { 0 };
-	json_t *json_body = json_loads (request_body->str, 0, &json_error);
-	if (json_body) {
-		users_input_parse_json (
-			json_body,
-			&name,
-			&username,
-			&email,
-			&password,
-			&confirm
-		);
-
+	uint32_t found = 0;
+	if (!jeeves_body_parse (
+		request_body,
+		users_login_fields, USERS_LOGIN_FIELDS,
+		user_values, &found
+	)) {
 		*input = jeeves_user_login_validate_input_internal (
-			email, password
+			users_input_value (user_values->email),
+			users_input_value (user_values->password)
 		);
 
-		if (*input == JEEVES_USER_INPUT_NONE) {
-			(void) strncpy (user_values->email, email, USER_EMAIL_SIZE - 1);
-			(void) strncpy (user_values->password, password, USER_PASSWORD_SIZE - 1);
-		}
-
-		else {
+		if (*input != JEEVES_USER_INPUT_NONE) {
 			error = JEEVES_USER_ERROR_MISSING_VALUES;
 		}
-
-		json_decref (json_body);
 	}
 
 	else {
 		#ifdef JEEVES_DEBUG
-		cerver_log_error (
-			"json_loads () - json error on line %d: %s\n", 
-			json_error.line, json_error.text
-		);
+		cerver_log_error ("jeeves_user_login_parse_json () - bad json body!");
 		#endif
 
 		error = JEEVES_USER_ERROR_BAD_REQUEST;
@@ -675,9 +686,9 @@ User *jeeves_user_login (
 
 void jeeves_user_delete (void *user_ptr) {
 
-	if (user_ptr) {
-		(void) memset (user_ptr, 0, sizeof (User));
-		(void) pool_push (users_pool, user_ptr);
+	// the arena's users are released when their request ends
+	if (user_ptr && !jeeves_arena_owns (user_ptr)) {
+		jeeves_users_pool_push ((User *) user_ptr);
 	}
 
 }
@@ -0,0 +1,774 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <stdatomic.h>
+
+#include <bson/bson.h>
+#include <mongoc/mongoc.h>
+
+#include <cerver/utils/log.h>
+
+#include "db.h"
+#include "jeeves.h"
+
+static mongoc_uri_t *db_uri = NULL;
+static mongoc_client_pool_t *db_pool = NULL;
+
+static char db_name[MONGO_DB_SIZE] = { 0 };
+
+static atomic_size_t db_clients_pops = 0;
+static atomic_size_t db_clients_waits = 0;
+static atomic_size_t db_clients_pinned = 0;
+static atomic_uint_fast64_t db_clients_wait_us = 0;
+static atomic_uint_fast64_t db_clients_max_wait_us = 0;
+
+// a client that is kept by a long lived thread
+static _Thread_local mongoc_client_t *db_thread_client = NULL;
+
+// appends maxPoolSize to the uri's options
+// so cmongo & the db clients pool are created with the same size
+// a pool size of 0 keeps the uri as it is
+// returns 0 on success, 1 if the uri does not fit
+unsigned int jeeves_db_uri_pool_size (
+	char *uri, const size_t uri_size, const unsigned int pool_size
+) {
+
+	unsigned int retval = 0;
+
+	if (pool_size) {
+		const size_t len = strlen (uri);
+
+		const char *hosts = strstr (uri, "://");
+		hosts = hosts ? hosts + 3 : uri;
+
+		// the options always come after the hosts' slash
+		const char *separator = "&";
+		if (!strchr (hosts, '?')) {
+			separator = strchr (hosts, '/') ? "?" : "/?";
+		}
+
+		else if (len && ((uri[len - 1] == '?') || (uri[len - 1] == '&'))) {
+			separator = "";
+		}
+
+		int written = snprintf (
+			uri + len, uri_size - len,
+			"%smaxPoolSize=%u", separator, pool_size
+		);
+
+		if ((written < 0) || ((size_t) written >= (uri_size - len))) {
+			uri[len] = '\0';
+			retval = 1;
+		}
+	}
+
+	return retval;
+
+}
+
+// dedicated clients pool for the operations
+// that are not available through cmongo
+unsigned int jeeves_db_init (
+	const char *uri, const char *app_name, const char *name
+) {
+
+	unsigned int retval = 1;
+
+	bson_error_t error = { 0 };
+	db_uri = mongoc_uri_new_with_error (uri, &error);
+	if (db_uri) {
+		(void) mongoc_uri_set_appname (db_uri, app_name);
+
+		db_pool = mongoc_client_pool_new (db_uri);
+		if (db_pool) {
+			(void) mongoc_client_pool_set_error_api (db_pool, 2);
+
+			(void) strncpy (db_name, name, MONGO_DB_SIZE - 1);
+
+			retval = 0;
+		}
+
+		else {
+			cerver_log_error ("Failed to create db clients pool!");
+		}
+	}
+
+	else {
+		cerver_log_error ("Failed to parse db uri: %s", error.message);
+	}
+
+	return retval;
+
+}
+
+void jeeves_db_end (void) {
+
+	if (db_pool) {
+		mongoc_client_pool_destroy (db_pool);
+		db_pool = NULL;
+	}
+
+	if (db_uri) {
+		mongoc_uri_destroy (db_uri);
+		db_uri = NULL;
+	}
+
+}
+
+static void jeeves_db_clients_wait (const uint64_t wait_us) {
+
+	(void) atomic_fetch_add_explicit (&db_clients_waits, 1, memory_order_relaxed);
+	(void) atomic_fetch_add_explicit (&db_clients_wait_us, wait_us, memory_order_relaxed);
+
+	uint_fast64_t max_wait_us = atomic_load_explicit (
+		&db_clients_max_wait_us, memory_order_relaxed
+	);
+
+	while (
+		(wait_us > max_wait_us)
+		&& !atomic_compare_exchange_weak_explicit (
+			&db_clients_max_wait_us, &max_wait_us, wait_us,
+			memory_order_relaxed, memory_order_relaxed
+		)
+	);
+
+}
+
+// gets a client from the pool, or the thread's pinned client
+// only pops that found the pool empty are counted as waits
+static mongoc_client_t *jeeves_db_client_pop (void) {
+
+	mongoc_client_t *client = db_thread_client;
+	if (!client) {
+		(void) atomic_fetch_add_explicit (&db_clients_pops, 1, memory_order_relaxed);
+
+		client = mongoc_client_pool_try_pop (db_pool);
+		if (!client) {
+			int64_t start = bson_get_monotonic_time ();
+
+			client = mongoc_client_pool_pop (db_pool);
+
+			jeeves_db_clients_wait ((uint64_t) (bson_get_monotonic_time () - start));
+		}
+	}
+
+	return client;
+
+}
+
+static void jeeves_db_client_push (mongoc_client_t *client) {
+
+	if (client != db_thread_client) {
+		mongoc_client_pool_push (db_pool, client);
+	}
+
+}
+
+// keeps a client for the calling thread until it is unpinned
+// does nothing if MONGO_PIN_CLIENTS is not set
+void jeeves_db_thread_pin (void) {
+
+	if (MONGO_PIN_CLIENTS && db_pool && !db_thread_client) {
+		db_thread_client = mongoc_client_pool_pop (db_pool);
+		if (db_thread_client) {
+			(void) atomic_fetch_add_explicit (&db_clients_pinned, 1, memory_order_relaxed);
+		}
+	}
+
+}
+
+// returns the thread's client to the pool
+// must be called before the thread exits
+void jeeves_db_thread_unpin (void) {
+
+	if (db_thread_client) {
+		mongoc_client_pool_push (db_pool, db_thread_client);
+		db_thread_client = NULL;
+
+		(void) atomic_fetch_sub_explicit (&db_clients_pinned, 1, memory_order_relaxed);
+	}
+
+}
+
+void jeeves_db_clients_stats (JeevesDbClientsStats *stats) {
+
+	if (stats) {
+		stats->pops = atomic_load_explicit (&db_clients_pops, memory_order_relaxed);
+		stats->waits = atomic_load_explicit (&db_clients_waits, memory_order_relaxed);
+		stats->pinned = atomic_load_explicit (&db_clients_pinned, memory_order_relaxed);
+		stats->wait_us = (uint64_t) atomic_load_explicit (&db_clients_wait_us, memory_order_relaxed);
+		stats->max_wait_us = (uint64_t) atomic_load_explicit (&db_clients_max_wait_us, memory_order_relaxed);
+	}
+
+}
+
+void jeeves_db_clients_print (void) {
+
+	JeevesDbClientsStats stats = { 0 };
+	jeeves_db_clients_stats (&stats);
+
+	cerver_log_msg ("\nDB clients:\n");
+	cerver_log_msg ("Pops: %zu\n", stats.pops);
+	cerver_log_msg ("Waits: %zu\n", stats.waits);
+	cerver_log_msg ("Pinned: %zu\n", stats.pinned);
+	cerver_log_msg (
+		"Average wait: %.2fms\n",
+		stats.waits ? ((double) stats.wait_us / (double) stats.waits) / 1000.0 : 0.0
+	);
+	cerver_log_msg ("Max wait: %.2fms\n", (double) stats.max_wait_us / 1000.0);
+
+}
+
+// uses the same projection as the find opts
+// so the callers can keep a single set of selects
+static bool jeeves_db_query_opts_projection (
+	const bson_t *query_opts, bson_t *fields
+) {
+
+	bool retval = false;
+
+	bson_iter_t iter = { 0 };
+	if (
+		query_opts
+		&& bson_iter_init_find (&iter, query_opts, "projection")
+		&& BSON_ITER_HOLDS_DOCUMENT (&iter)
+	) {
+		const uint8_t *data = NULL;
+		uint32_t len = 0;
+		bson_iter_document (&iter, &len, &data);
+
+		retval = bson_init_static (fields, data, len);
+	}
+
+	return retval;
+
+}
+
+// atomically updates the first document that matches the query
+// and parses the updated document into output using the opts projection
+// returns 0 if a document was updated, 1 if no document matched or on error
+unsigned int jeeves_db_find_and_modify (
+	const char *coll_name,
+	const bson_t *query, const bson_t *update, const bson_t *query_opts,
+	void (*parser)(void *output, const bson_t *doc), void *output
+) {
+
+	unsigned int retval = 1;
+
+	mongoc_client_t *client = jeeves_db_client_pop ();
+	if (client) {
+		mongoc_collection_t *collection = mongoc_client_get_collection (
+			client, db_name, coll_name
+		);
+
+		mongoc_find_and_modify_opts_t *opts = mongoc_find_and_modify_opts_new ();
+		(void) mongoc_find_and_modify_opts_set_update (opts, update);
+		(void) mongoc_find_and_modify_opts_set_flags (opts, MONGOC_FIND_AND_MODIFY_RETURN_NEW);
+
+		bson_t fields = { 0 };
+		if (jeeves_db_query_opts_projection (query_opts, &fields)) {
+			(void) mongoc_find_and_modify_opts_set_fields (opts, &fields);
+		}
+
+		JeevesDbTimer timer = { 0 };
+		jeeves_db_timer_start (&timer, coll_name, "findAndModify", query);
+
+		bson_t reply = BSON_INITIALIZER;
+		bson_error_t error = { 0 };
+		if (mongoc_collection_find_and_modify_with_opts (
+			collection, query, opts, &reply, &error
+		)) {
+			// value is null if no document matched the query
+			bson_iter_t iter = { 0 };
+			if (
+				bson_iter_init_find (&iter, &reply, "value")
+				&& BSON_ITER_HOLDS_DOCUMENT (&iter)
+			) {
+				const uint8_t *data = NULL;
+				uint32_t len = 0;
+				bson_iter_document (&iter, &len, &data);
+
+				bson_t doc = { 0 };
+				if (parser && output && bson_init_static (&doc, data, len)) {
+					parser (output, &doc);
+				}
+
+				retval = 0;
+			}
+		}
+
+		else {
+			cerver_log_error (
+				"jeeves_db_find_and_modify () - %s", error.message
+			);
+		}
+
+		bson_destroy (&reply);
+		mongoc_find_and_modify_opts_destroy (opts);
+		mongoc_collection_destroy (collection);
+
+		jeeves_db_client_push (client);
+
+		// the explain needs a client of its own
+		jeeves_db_timer_end (&timer);
+	}
+
+	return retval;
+
+}
+
+// iterates every document that matches the query
+// the callback returns false to stop the iteration
+// returns 0 on success, 1 on error
+unsigned int jeeves_db_find_each (
+	const char *coll_name,
+	const bson_t *query, const bson_t *opts,
+	bool (*each)(void *data, const bson_t *doc), void *data
+) {
+
+	unsigned int retval = 1;
+
+	mongoc_client_t *client = jeeves_db_client_pop ();
+	if (client) {
+		mongoc_collection_t *collection = mongoc_client_get_collection (
+			client, db_name, coll_name
+		);
+
+		JeevesDbTimer timer = { 0 };
+		jeeves_db_timer_start (&timer, coll_name, "find", query);
+
+		mongoc_cursor_t *cursor = mongoc_collection_find_with_opts (
+			collection, query, opts, NULL
+		);
+
+		const bson_t *doc = NULL;
+		int64_t each_start = 0;
+		bool more = true;
+		while (more && mongoc_cursor_next (cursor, &doc)) {
+			each_start = bson_get_monotonic_time ();
+			more = each (data, doc);
+
+			// only the time spent waiting for the db counts
+			timer.start += bson_get_monotonic_time () - each_start;
+		}
+
+		bson_error_t error = { 0 };
+		if (!mongoc_cursor_error (cursor, &error)) {
+			retval = 0;
+		}
+
+		else {
+			cerver_log_error (
+				"jeeves_db_find_each () - %s", error.message
+			);
+		}
+
+		mongoc_cursor_destroy (cursor);
+		mongoc_collection_destroy (collection);
+
+		jeeves_db_client_push (client);
+
+		jeeves_db_timer_end (&timer);
+	}
+
+	return retval;
+
+}
+
+// inserts the documents with a single command
+// returns 0 if every document was inserted, 1 on error
+unsigned int jeeves_db_insert_many (
+	const char *coll_name,
+	const bson_t **docs, const size_t n_docs
+) {
+
+	unsigned int retval = 1;
+
+	mongoc_client_t *client = jeeves_db_client_pop ();
+	if (client) {
+		mongoc_collection_t *collection = mongoc_client_get_collection (
+			client, db_name, coll_name
+		);
+
+		bson_error_t error = { 0 };
+		if (mongoc_collection_insert_many (
+			collection, docs, n_docs, NULL, NULL, &error
+		)) {
+			retval = 0;
+		}
+
+		else {
+			cerver_log_error (
+				"jeeves_db_insert_many () - %s", error.message
+			);
+		}
+
+		mongoc_collection_destroy (collection);
+
+		jeeves_db_client_push (client);
+	}
+
+	return retval;
+
+}
+
+static void jeeves_db_index_keys (
+	bson_t *keys, const JeevesDbIndex *index
+) {
+
+	for (
+		unsigned int i = 0;
+		(i < JEEVES_DB_INDEX_MAX_KEYS) && index->keys[i];
+		i++
+	) {
+		(void) bson_append_int32 (keys, index->keys[i], -1, 1);
+	}
+
+}
+
+static void jeeves_db_create_indexes_command (
+	bson_t *command, const char *coll_name,
+	const JeevesDbIndex *indexes, const size_t n_indexes
+) {
+
+	bson_init (command);
+	(void) bson_append_utf8 (command, "createIndexes", -1, coll_name, -1);
+
+	bson_t indexes_array = BSON_INITIALIZER;
+	(void) bson_append_array_begin (command, "indexes", -1, &indexes_array);
+
+	char buf[16] = { 0 };
+	const char *key = NULL;
+	for (size_t idx = 0; idx < n_indexes; idx++) {
+		(void) bson_uint32_to_string ((uint32_t) idx, &key, buf, sizeof (buf));
+
+		bson_t index_doc = BSON_INITIALIZER;
+		(void) bson_append_document_begin (&indexes_array, key, -1, &index_doc);
+
+		bson_t keys = BSON_INITIALIZER;
+		(void) bson_append_document_begin (&index_doc, "key", -1, &keys);
+		jeeves_db_index_keys (&keys, &indexes[idx]);
+		(void) bson_append_document_end (&index_doc, &keys);
+
+		(void) bson_append_utf8 (&index_doc, "name", -1, indexes[idx].name, -1);
+		if (indexes[idx].unique) {
+			(void) bson_append_bool (&index_doc, "unique", -1, true);
+		}
+
+		(void) bson_append_document_end (&indexes_array, &index_doc);
+	}
+
+	(void) bson_append_array_end (command, &indexes_array);
+
+}
+
+static int32_t jeeves_db_reply_int32 (
+	const bson_t *reply, const char *key
+) {
+
+	bson_iter_t iter = { 0 };
+	return bson_iter_init_find (&iter, reply, key) ?
+		(int32_t) bson_iter_as_int64 (&iter) : 0;
+
+}
+
+// creates the collection's indexes that do not exist yet
+// an index with the same name but different keys is reported as an error
+// returns 0 if every index exists, 1 on error
+unsigned int jeeves_db_create_indexes (
+	const char *coll_name,
+	const JeevesDbIndex *indexes, const size_t n_indexes
+) {
+
+	unsigned int retval = 1;
+
+	mongoc_client_t *client = jeeves_db_client_pop ();
+	if (client) {
+		mongoc_collection_t *collection = mongoc_client_get_collection (
+			client, db_name, coll_name
+		);
+
+		bson_t command;
+		jeeves_db_create_indexes_command (
+			&command, coll_name, indexes, n_indexes
+		);
+
+		bson_t reply;
+		bson_error_t error = { 0 };
+		if (mongoc_collection_write_command_with_opts (
+			collection, &command, NULL, &reply, &error
+		)) {
+			int32_t before = jeeves_db_reply_int32 (&reply, "numIndexesBefore");
+			int32_t after = jeeves_db_reply_int32 (&reply, "numIndexesAfter");
+
+			cerver_log_success (
+				"%s indexes are ready - %zu declared, %d created",
+				coll_name, n_indexes, (int) (after - before)
+			);
+
+			retval = 0;
+		}
+
+		else {
+			cerver_log_error (
+				"Failed to create %s indexes: %s",
+				coll_name, error.message
+			);
+		}
+
+		bson_destroy (&reply);
+		bson_destroy (&command);
+
+		mongoc_collection_destroy (collection);
+
+		jeeves_db_client_push (client);
+	}
+
+	return retval;
+
+}
+
+static void jeeves_db_append (
+	char *buffer, size_t *len, const size_t size,
+	const char *str
+) {
+
+	if (*len < size) {
+		int n = snprintf (buffer + *len, size - *len, "%s", str);
+		if (n > 0) *len += (size_t) n;
+		if (*len >= size) *len = size - 1;
+	}
+
+}
+
+// writes the query's keys & operators without its values
+// { user: ?, _id: { $lt: ? } }
+static void jeeves_db_query_shape (
+	bson_iter_t *iter,
+	char *shape, size_t *len, const size_t size
+) {
+
+	bson_iter_t child = { 0 };
+	bool first = true;
+
+	jeeves_db_append (shape, len, size, "{ ");
+	while (bson_iter_next (iter)) {
+		if (!first) jeeves_db_append (shape, len, size, ", ");
+		first = false;
+
+		jeeves_db_append (shape, len, size, bson_iter_key (iter));
+		jeeves_db_append (shape, len, size, ": ");
+
+		if (BSON_ITER_HOLDS_DOCUMENT (iter) && bson_iter_recurse (iter, &child)) {
+			jeeves_db_query_shape (&child, shape, len, size);
+		}
+
+		else {
+			jeeves_db_append (shape, len, size, "?");
+		}
+	}
+	jeeves_db_append (shape, len, size, " }");
+
+}
+
+// summarizes the winning plan's stages
+// FETCH > IXSCAN (user_1__id_1)
+static void jeeves_db_explain_summary (
+	const bson_t *reply, char *summary
+) {
+
+	size_t len = 0;
+
+	bson_iter_t plan = { 0 };
+	bson_iter_t iter = { 0 };
+	if (
+		bson_iter_init (&iter, reply)
+		&& bson_iter_find_descendant (&iter, "queryPlanner.winningPlan", &plan)
+	) {
+		// the slot based engine wraps the classic plan
+		bson_iter_t query_plan = { 0 };
+		if (
+			bson_iter_recurse (&plan, &iter)
+			&& bson_iter_find_descendant (&iter, "queryPlan", &query_plan)
+		) plan = query_plan;
+
+		bson_iter_t child = { 0 };
+		bson_iter_t next = { 0 };
+		bool has_next = true;
+		while (has_next && BSON_ITER_HOLDS_DOCUMENT (&plan)) {
+			has_next = false;
+
+			if (bson_iter_recurse (&plan, &child)) {
+				while (bson_iter_next (&child)) {
+					const char *key = bson_iter_key (&child);
+					if (!strcmp (key, "stage") && BSON_ITER_HOLDS_UTF8 (&child)) {
+						if (len) jeeves_db_append (summary, &len, JEEVES_DB_EXPLAIN_SIZE, " > ");
+						jeeves_db_append (
+							summary, &len, JEEVES_DB_EXPLAIN_SIZE,
+							bson_iter_utf8 (&child, NULL)
+						);
+					}
+
+					else if (!strcmp (key, "indexName") && BSON_ITER_HOLDS_UTF8 (&child)) {
+						jeeves_db_append (summary, &len, JEEVES_DB_EXPLAIN_SIZE, " (");
+						jeeves_db_append (
+							summary, &len, JEEVES_DB_EXPLAIN_SIZE,
+							bson_iter_utf8 (&child, NULL)
+						);
+						jeeves_db_append (summary, &len, JEEVES_DB_EXPLAIN_SIZE, ")");
+					}
+
+					else if (!strcmp (key, "inputStage")) {
+						next = child;
+						has_next = true;
+					}
+				}
+			}
+
+			plan = next;
+		}
+	}
+
+	if (!len) jeeves_db_append (summary, &len, JEEVES_DB_EXPLAIN_SIZE, "unknown plan");
+
+}
+
+// when each collection & shape was last explained
+// the shapes that share a slot also share their interval
+static atomic_int_fast64_t db_explained[JEEVES_DB_EXPLAIN_SLOTS];
+
+// returns true if the shape has not been explained in the last interval
+// & claims the interval for the caller
+static bool jeeves_db_explain_claim (const char *coll_name, const char *shape) {
+
+	size_t hash = 14695981039346656037ULL;
+	for (const char *c = coll_name; *c; c++) hash = (hash ^ (unsigned char) *c) * 1099511628211ULL;
+	for (const char *c = shape; *c; c++) hash = (hash ^ (unsigned char) *c) * 1099511628211ULL;
+
+	atomic_int_fast64_t *explained = &db_explained[hash & (JEEVES_DB_EXPLAIN_SLOTS - 1)];
+
+	const int_fast64_t now = bson_get_monotonic_time ();
+	int_fast64_t last = atomic_load_explicit (explained, memory_order_relaxed);
+
+	return (
+		(!last || ((now - last) >= ((int_fast64_t) JEEVES_DB_EXPLAIN_INTERVAL * 1000000)))
+		&& atomic_compare_exchange_strong_explicit (
+			explained, &last, now,
+			memory_order_relaxed, memory_order_relaxed
+		)
+	);
+
+}
+
+// explains the query's filter as a find
+// updates select their documents with the same plan
+static void jeeves_db_explain (
+	const char *coll_name, const bson_t *query, char *summary
+) {
+
+	mongoc_client_t *client = jeeves_db_client_pop ();
+	if (client) {
+		mongoc_collection_t *collection = mongoc_client_get_collection (
+			client, db_name, coll_name
+		);
+
+		bson_t command;
+		bson_init (&command);
+
+		bson_t explain_doc = BSON_INITIALIZER;
+		(void) bson_append_document_begin (&command, "explain", -1, &explain_doc);
+		(void) bson_append_utf8 (&explain_doc, "find", -1, coll_name, -1);
+		(void) bson_append_document (&explain_doc, "filter", -1, query);
+		(void) bson_append_document_end (&command, &explain_doc);
+
+		(void) bson_append_utf8 (&command, "verbosity", -1, "queryPlanner", -1);
+
+		bson_t reply;
+		bson_error_t error = { 0 };
+		if (mongoc_collection_read_command_with_opts (
+			collection, &command, NULL, NULL, &reply, &error
+		)) {
+			jeeves_db_explain_summary (&reply, summary);
+		}
+
+		else {
+			(void) snprintf (
+				summary, JEEVES_DB_EXPLAIN_SIZE,
+				"explain failed: %s", error.message
+			);
+		}
+
+		bson_destroy (&reply);
+		bson_destroy (&command);
+
+		mongoc_collection_destroy (collection);
+
+		jeeves_db_client_push (client);
+	}
+
+}
+
+void jeeves_db_timer_start (
+	JeevesDbTimer *timer,
+	const char *coll_name, const char *operation,
+	const bson_t *query
+) {
+
+	timer->coll_name = coll_name;
+	timer->operation = operation;
+
+	// the caller's query might be destroyed by the operation
+	timer->query_len = 0;
+	if (DB_SLOW_QUERY_MS && query && (query->len <= JEEVES_DB_QUERY_SIZE)) {
+		(void) memcpy (timer->query, bson_get_data (query), query->len);
+		timer->query_len = query->len;
+	}
+
+	timer->start = bson_get_monotonic_time ();
+
+}
+
+// logs the operation with its query shape if it took longer
+// than DB_SLOW_QUERY_MS & then its explain summary
+// if its shape was not explained in the last interval
+void jeeves_db_timer_end (JeevesDbTimer *timer) {
+
+	int64_t elapsed = (bson_get_monotonic_time () - timer->start) / 1000;
+	if (DB_SLOW_QUERY_MS && (elapsed >= (int64_t) DB_SLOW_QUERY_MS)) {
+		char shape[JEEVES_DB_SHAPE_SIZE] = { 0 };
+		size_t shape_len = 0;
+
+		bson_t query = { 0 };
+		bson_iter_t iter = { 0 };
+		const bool kept = bson_init_static (&query, timer->query, timer->query_len)
+			&& bson_iter_init (&iter, &query);
+
+		if (kept) {
+			jeeves_db_query_shape (&iter, shape, &shape_len, JEEVES_DB_SHAPE_SIZE);
+		}
+
+		else {
+			// the query was bigger than JEEVES_DB_QUERY_SIZE
+			(void) strncpy (shape, "unknown shape", JEEVES_DB_SHAPE_SIZE - 1);
+		}
+
+		cerver_log_warning (
+			"Slow %s %s took %ldms - %s",
+			timer->coll_name, timer->operation, (long) elapsed, shape
+		);
+
+		// a slow db makes every operation slow
+		// so each shape only pays for an explain once per interval
+		if (kept && jeeves_db_explain_claim (timer->coll_name, shape)) {
+			char summary[JEEVES_DB_EXPLAIN_SIZE] = { 0 };
+			jeeves_db_explain (timer->coll_name, &query, summary);
+
+			cerver_log_warning (
+				"Slow %s %s plan - %s - %s",
+				timer->coll_name, timer->operation, shape, summary
+			);
+		}
+	}
+
+}
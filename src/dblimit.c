@@ -0,0 +1,131 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <stdatomic.h>
+
+#include <cerver/handler.h>
+
+#include <cerver/http/http.h>
+#include <cerver/http/request.h>
+
+#include <cerver/utils/log.h>
+
+#include "arena.h"
+#include "dblimit.h"
+#include "errors.h"
+
+static unsigned int db_limit_max_inflight = 0;
+
+// handlers that are blocking a handler thread right now
+static atomic_size_t db_limit_inflight = 0;
+
+static atomic_size_t db_limit_handled = 0;
+static atomic_size_t db_limit_rejected = 0;
+static atomic_size_t db_limit_max_seen = 0;
+
+// set while the calling thread runs a limited handler
+static _Thread_local bool db_limit_running = false;
+
+// limits the db bound handlers that block cerver's handler threads
+// a value of 0 does not limit them
+void jeeves_db_limit_init (const unsigned int max_inflight) {
+
+	db_limit_max_inflight = max_inflight;
+
+	if (max_inflight) {
+		cerver_log_success (
+			"DB bound handlers are limited to %u in flight!", max_inflight
+		);
+	}
+
+	else {
+		cerver_log_warning ("DB bound handlers are not limited - requests are never rejected!");
+	}
+
+}
+
+static void jeeves_db_limit_max (const size_t inflight) {
+
+	size_t max_seen = atomic_load_explicit (&db_limit_max_seen, memory_order_relaxed);
+
+	while (
+		(inflight > max_seen)
+		&& !atomic_compare_exchange_weak_explicit (
+			&db_limit_max_seen, &max_seen, inflight,
+			memory_order_relaxed, memory_order_relaxed
+		)
+	);
+
+}
+
+// runs the route's handler in the caller's thread
+// replies with 503 if too many handlers are already in flight
+// the handler always runs in its own request arena scope
+// returns false if the caller is the handler that is already running
+bool jeeves_db_limit_handle (
+	const HttpReceive *http_receive,
+	const HttpRequest *request,
+	void (*handler)(
+		const HttpReceive *http_receive,
+		const HttpRequest *request
+	)
+) {
+
+	bool retval = false;
+
+	if (!db_limit_running) {
+		const size_t inflight = atomic_fetch_add_explicit (
+			&db_limit_inflight, 1, memory_order_relaxed
+		) + 1;
+
+		if (!db_limit_max_inflight || (inflight <= db_limit_max_inflight)) {
+			(void) atomic_fetch_add_explicit (&db_limit_handled, 1, memory_order_relaxed);
+			jeeves_db_limit_max (inflight);
+
+			db_limit_running = true;
+
+			jeeves_arena_request_begin ();
+			handler (http_receive, request);
+			jeeves_arena_request_end ();
+
+			db_limit_running = false;
+		}
+
+		else {
+			(void) atomic_fetch_add_explicit (&db_limit_rejected, 1, memory_order_relaxed);
+
+			jeeves_error_send_response (JEEVES_ERROR_SERVER_BUSY, http_receive);
+		}
+
+		(void) atomic_fetch_sub_explicit (&db_limit_inflight, 1, memory_order_relaxed);
+
+		retval = true;
+	}
+
+	return retval;
+
+}
+
+void jeeves_db_limit_stats (JeevesDbLimitStats *stats) {
+
+	if (stats) {
+		stats->handled = atomic_load_explicit (&db_limit_handled, memory_order_relaxed);
+		stats->rejected = atomic_load_explicit (&db_limit_rejected, memory_order_relaxed);
+		stats->max_inflight = atomic_load_explicit (&db_limit_max_seen, memory_order_relaxed);
+	}
+
+}
+
+void jeeves_db_limit_print (void) {
+
+	JeevesDbLimitStats stats = { 0 };
+	jeeves_db_limit_stats (&stats);
+
+	cerver_log_msg ("\nDB in flight limit:\n");
+	cerver_log_msg ("Max in flight: %u\n", db_limit_max_inflight);
+	cerver_log_msg ("Handled: %zu\n", stats.handled);
+	cerver_log_msg ("Rejected: %zu\n", stats.rejected);
+	cerver_log_msg ("Most in flight: %zu\n", stats.max_inflight);
+
+}
@@ -40,10 +40,18 @@ void jeeves_error_send_response (
 			(void) http_response_send (bad_user_error, http_receive);
 			break;
 
+		case JEEVES_ERROR_BAD_IMAGE:
+			(void) http_response_send (bad_image, http_receive);
+			break;
+
 		case JEEVES_ERROR_SERVER_ERROR:
 			(void) http_response_send (server_error, http_receive);
 			break;
 
+		case JEEVES_ERROR_SERVER_BUSY:
+			(void) http_response_send (server_busy, http_receive);
+			break;
+
 		default: break;
 	}
 
@@ -1,10 +1,26 @@
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
 
 #include <cerver/types/string.h>
 
 #include <cerver/handler.h>
+#include <cerver/files.h>
 
 #include <cerver/utils/utils.h>
+#include <cerver/utils/log.h>
+
+#include "files.h"
+
+#define JEEVES_FILES_PATH_SIZE			1024
+#define JEEVES_FILES_COPY_SIZE			(32 * 1024)
 
 String *jeeves_uploads_dirname_generator (
 	const CerverReceive *cr
@@ -19,4 +35,189 @@ String *jeeves_uploads_dirname_generator (
 
 	return dirname;
 
-}
\ No newline at end of file
+}
+
+static unsigned int jeeves_files_copy_fd (const int from, const int to) {
+
+	unsigned int retval = 0;
+
+	char buffer[JEEVES_FILES_COPY_SIZE];
+
+	ssize_t n_read = 0;
+	while ((n_read = read (from, buffer, JEEVES_FILES_COPY_SIZE))) {
+		if (n_read < 0) {
+			if (errno == EINTR) continue;
+
+			retval = 1;
+			break;
+		}
+
+		// writes can be partial
+		ssize_t written = 0;
+		while (written < n_read) {
+			ssize_t n_written = write (to, buffer + written, (size_t) (n_read - written));
+			if (n_written < 0) {
+				if (errno == EINTR) continue;
+
+				retval = 1;
+				break;
+			}
+
+			written += n_written;
+		}
+
+		if (retval) break;
+	}
+
+	return retval;
+
+}
+
+// copies the file into the destination device using a temporary name
+// so readers never see a partially written file
+static unsigned int jeeves_files_move_file_copy (
+	const char *old_location, const char *new_location
+) {
+
+	unsigned int retval = 1;
+
+	char temp_location[JEEVES_FILES_PATH_SIZE] = { 0 };
+	(void) snprintf (
+		temp_location, JEEVES_FILES_PATH_SIZE,
+		"%s.part", new_location
+	);
+
+	int from = open (old_location, O_RDONLY);
+	if (from >= 0) {
+		struct stat from_stat = { 0 };
+		mode_t mode = !fstat (from, &from_stat) ? (from_stat.st_mode & 0777) : 0644;
+
+		int to = open (temp_location, O_WRONLY | O_CREAT | O_TRUNC, mode);
+		if (to >= 0) {
+			unsigned int errors = jeeves_files_copy_fd (from, to);
+
+			// the data must be in the disk before it gets its final name
+			if (!errors) errors |= (unsigned int) (fsync (to) != 0);
+			errors |= (unsigned int) (close (to) != 0);
+
+			if (!errors && !rename (temp_location, new_location)) {
+				(void) unlink (old_location);
+				retval = 0;
+			}
+
+			else {
+				(void) unlink (temp_location);
+			}
+		}
+
+		(void) close (from);
+	}
+
+	return retval;
+
+}
+
+// moves a file into its new location
+// the file is first written with a temporary name in the
+// destination directory & then renamed to its final name
+unsigned int jeeves_files_move_file (
+	const char *old_location, const char *new_location
+) {
+
+	unsigned int retval = 1;
+
+	if (old_location && new_location) {
+		// same device - just update the directory entry
+		if (!rename (old_location, new_location)) {
+			retval = 0;
+		}
+
+		else if (errno == EXDEV) {
+			retval = jeeves_files_move_file_copy (
+				old_location, new_location
+			);
+		}
+
+		if (retval) {
+			cerver_log_error (
+				"Failed to move %s to %s",
+				old_location, new_location
+			);
+		}
+	}
+
+	return retval;
+
+}
+
+// requests the kernel to start reading the file into the page cache
+// returns right away, the actual reads happen in the background
+unsigned int jeeves_files_prefetch (const char *filename) {
+
+	unsigned int retval = 1;
+
+	int fd = open (filename, O_RDONLY);
+	if (fd >= 0) {
+		if (!posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED)) {
+			retval = 0;
+		}
+
+		(void) close (fd);
+	}
+
+	return retval;
+
+}
+
+// moves every file inside old_dirname into new_dirname
+// and removes old_dirname once it is empty
+unsigned int jeeves_files_move_dir (
+	const char *old_dirname, const char *new_dirname
+) {
+
+	unsigned int errors = 0;
+
+	if (old_dirname && new_dirname) {
+		(void) files_create_dir (new_dirname, 0777);
+
+		DIR *dir = opendir (old_dirname);
+		if (dir) {
+			char old_location[JEEVES_FILES_PATH_SIZE] = { 0 };
+			char new_location[JEEVES_FILES_PATH_SIZE] = { 0 };
+
+			struct dirent *entry = NULL;
+			while ((entry = readdir (dir))) {
+				if (
+					!strcmp (entry->d_name, ".")
+					|| !strcmp (entry->d_name, "..")
+				) continue;
+
+				(void) snprintf (
+					old_location, JEEVES_FILES_PATH_SIZE,
+					"%s/%s", old_dirname, entry->d_name
+				);
+
+				(void) snprintf (
+					new_location, JEEVES_FILES_PATH_SIZE,
+					"%s/%s", new_dirname, entry->d_name
+				);
+
+				errors |= jeeves_files_move_file (
+					old_location, new_location
+				);
+			}
+
+			(void) closedir (dir);
+
+			if (!errors) (void) rmdir (old_dirname);
+		}
+
+		else {
+			cerver_log_error ("Failed to open %s dir!", old_dirname);
+			errors = 1;
+		}
+	}
+
+	return errors;
+
+}
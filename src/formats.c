@@ -0,0 +1,395 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include <bson/bson.h>
+
+#include "formats.h"
+#include "json.h"
+
+#define JEEVES_FORMAT_TYPE_SIZE			64
+
+const char *jeeves_format_content_type (
+	const JeevesFormat format
+) {
+
+	switch (format) {
+		#define XX(num, name, type) case JEEVES_FORMAT_##name: return #type;
+		JEEVES_FORMAT_MAP(XX)
+		#undef XX
+	}
+
+	return jeeves_format_content_type (JEEVES_FORMAT_JSON);
+
+}
+
+// returns false if the media type is not supported
+static bool jeeves_format_from_type (
+	const char *type, JeevesFormat *format
+) {
+
+	bool retval = true;
+
+	if (
+		!strcasecmp (type, "application/json")
+		|| !strcasecmp (type, "application/*")
+		|| !strcasecmp (type, "*/*")
+	) {
+		*format = JEEVES_FORMAT_JSON;
+	}
+
+	else if (!strcasecmp (type, "application/bson")) {
+		*format = JEEVES_FORMAT_BSON;
+	}
+
+	else if (
+		!strcasecmp (type, "application/msgpack")
+		|| !strcasecmp (type, "application/x-msgpack")
+		|| !strcasecmp (type, "application/vnd.msgpack")
+	) {
+		*format = JEEVES_FORMAT_MSGPACK;
+	}
+
+	else {
+		retval = false;
+	}
+
+	return retval;
+
+}
+
+// gets the media range's q value from its parameters
+static double jeeves_format_quality (const char *params, const size_t len) {
+
+	double quality = 1.0;
+
+	const char *end = params + len;
+	const char *q = params;
+	while ((q = strchr (q, ';')) && (q < end)) {
+		q += 1;
+		while ((q < end) && (*q == ' ')) q += 1;
+
+		if (((end - q) > 2) && ((q[0] == 'q') || (q[0] == 'Q')) && (q[1] == '=')) {
+			quality = strtod (q + 2, NULL);
+		}
+	}
+
+	return quality;
+
+}
+
+// picks the supported type with the highest q value
+// json is used if there is no header or nothing else matches
+JeevesFormat jeeves_format_from_accept (const char *accept) {
+
+	JeevesFormat best = JEEVES_FORMAT_JSON;
+	double best_quality = 0.0;
+
+	const char *range = accept;
+	while (range && *range) {
+		const char *comma = strchr (range, ',');
+		size_t range_len = comma ? (size_t) (comma - range) : strlen (range);
+
+		while (range_len && (*range == ' ')) {
+			range += 1;
+			range_len -= 1;
+		}
+
+		const char *semicolon = memchr (range, ';', range_len);
+		size_t type_len = semicolon ? (size_t) (semicolon - range) : range_len;
+		while (type_len && (range[type_len - 1] == ' ')) type_len -= 1;
+
+		char type[JEEVES_FORMAT_TYPE_SIZE] = { 0 };
+		JeevesFormat format = JEEVES_FORMAT_JSON;
+		if (type_len && (type_len < JEEVES_FORMAT_TYPE_SIZE)) {
+			(void) memcpy (type, range, type_len);
+
+			if (jeeves_format_from_type (type, &format)) {
+				// the first of the types with the same quality wins
+				double quality = jeeves_format_quality (range, range_len);
+				if (quality > best_quality) {
+					best = format;
+					best_quality = quality;
+				}
+			}
+		}
+
+		range = comma ? comma + 1 : NULL;
+	}
+
+	return best;
+
+}
+
+static inline void jeeves_msgpack_write_byte (
+	JeevesJson *buffer, const uint8_t byte
+) {
+
+	jeeves_json_write (buffer, (const char *) &byte, 1);
+
+}
+
+static inline void jeeves_msgpack_put_be (
+	uint8_t *bytes, const uint64_t value, const unsigned int n_bytes
+) {
+
+	for (unsigned int i = 0; i < n_bytes; i++) {
+		bytes[i] = (uint8_t) (value >> (8 * (n_bytes - 1 - i)));
+	}
+
+}
+
+// writes the type byte followed by the big endian value
+static void jeeves_msgpack_write_be (
+	JeevesJson *buffer, const uint8_t type,
+	const uint64_t value, const unsigned int n_bytes
+) {
+
+	uint8_t bytes[9] = { type };
+	jeeves_msgpack_put_be (bytes + 1, value, n_bytes);
+
+	jeeves_json_write (buffer, (const char *) bytes, 1 + n_bytes);
+
+}
+
+static void jeeves_msgpack_write_int (JeevesJson *buffer, const int64_t value) {
+
+	// positive & negative fixint
+	if ((value >= -32) && (value <= 127)) {
+		jeeves_msgpack_write_byte (buffer, (uint8_t) value);
+	}
+
+	else if (value > 0) {
+		if (value <= UINT8_MAX) jeeves_msgpack_write_be (buffer, 0xcc, (uint64_t) value, 1);
+		else if (value <= UINT16_MAX) jeeves_msgpack_write_be (buffer, 0xcd, (uint64_t) value, 2);
+		else if (value <= UINT32_MAX) jeeves_msgpack_write_be (buffer, 0xce, (uint64_t) value, 4);
+		else jeeves_msgpack_write_be (buffer, 0xcf, (uint64_t) value, 8);
+	}
+
+	else {
+		if (value >= INT8_MIN) jeeves_msgpack_write_be (buffer, 0xd0, (uint64_t) value, 1);
+		else if (value >= INT16_MIN) jeeves_msgpack_write_be (buffer, 0xd1, (uint64_t) value, 2);
+		else if (value >= INT32_MIN) jeeves_msgpack_write_be (buffer, 0xd2, (uint64_t) value, 4);
+		else jeeves_msgpack_write_be (buffer, 0xd3, (uint64_t) value, 8);
+	}
+
+}
+
+static void jeeves_msgpack_write_double (JeevesJson *buffer, const double value) {
+
+	uint64_t bits = 0;
+	(void) memcpy (&bits, &value, sizeof (double));
+
+	jeeves_msgpack_write_be (buffer, 0xcb, bits, 8);
+
+}
+
+// uses the timestamp extension type
+static void jeeves_msgpack_write_date (JeevesJson *buffer, const int64_t millis) {
+
+	int64_t seconds = millis / 1000;
+	int64_t ms = millis % 1000;
+	if (ms < 0) {
+		seconds -= 1;
+		ms += 1000;
+	}
+
+	const uint64_t nanoseconds = (uint64_t) ms * 1000000;
+
+	// timestamp 64 holds seconds in 34 bits
+	if ((seconds >= 0) && (seconds < (INT64_C (1) << 34))) {
+		uint8_t bytes[10] = { 0xd7, 0xff };
+		jeeves_msgpack_put_be (bytes + 2, (nanoseconds << 34) | (uint64_t) seconds, 8);
+
+		jeeves_json_write (buffer, (const char *) bytes, sizeof (bytes));
+	}
+
+	// timestamp 96
+	else {
+		uint8_t bytes[15] = { 0xc7, 12, 0xff };
+		jeeves_msgpack_put_be (bytes + 3, nanoseconds, 4);
+		jeeves_msgpack_put_be (bytes + 7, (uint64_t) seconds, 8);
+
+		jeeves_json_write (buffer, (const char *) bytes, sizeof (bytes));
+	}
+
+}
+
+void jeeves_msgpack_write_map (JeevesJson *buffer, const uint32_t n) {
+
+	if (n < 16) jeeves_msgpack_write_byte (buffer, (uint8_t) (0x80 | n));
+	else if (n <= UINT16_MAX) jeeves_msgpack_write_be (buffer, 0xde, n, 2);
+	else jeeves_msgpack_write_be (buffer, 0xdf, n, 4);
+
+}
+
+static void jeeves_msgpack_write_array (JeevesJson *buffer, const uint32_t n) {
+
+	if (n < 16) jeeves_msgpack_write_byte (buffer, (uint8_t) (0x90 | n));
+	else if (n <= UINT16_MAX) jeeves_msgpack_write_be (buffer, 0xdc, n, 2);
+	else jeeves_msgpack_write_be (buffer, 0xdd, n, 4);
+
+}
+
+void jeeves_msgpack_write_str (
+	JeevesJson *buffer, const char *str, const size_t len
+) {
+
+	if (len < 32) jeeves_msgpack_write_byte (buffer, (uint8_t) (0xa0 | len));
+	else if (len <= UINT8_MAX) jeeves_msgpack_write_be (buffer, 0xd9, len, 1);
+	else if (len <= UINT16_MAX) jeeves_msgpack_write_be (buffer, 0xda, len, 2);
+	else jeeves_msgpack_write_be (buffer, 0xdb, len, 4);
+
+	jeeves_json_write (buffer, str, len);
+
+}
+
+// writes an array header with a count to be set later
+// returns the header's offset
+size_t jeeves_msgpack_write_array_begin (JeevesJson *buffer) {
+
+	const size_t offset = buffer->len;
+
+	jeeves_msgpack_write_be (buffer, 0xdd, 0, 4);
+
+	return offset;
+
+}
+
+void jeeves_msgpack_write_array_end (
+	JeevesJson *buffer, const size_t offset, const uint32_t count
+) {
+
+	if (!buffer->error) {
+		jeeves_msgpack_put_be ((uint8_t *) buffer->data + offset + 1, count, 4);
+	}
+
+}
+
+static void jeeves_msgpack_write_document (
+	JeevesJson *buffer, const bson_value_t *value,
+	JeevesJsonEnum enum_name
+) {
+
+	bson_t doc = { 0 };
+	bson_iter_t iter = { 0 };
+	if (
+		bson_init_static (&doc, value->value.v_doc.data, value->value.v_doc.data_len)
+		&& bson_iter_init (&iter, &doc)
+	) {
+		const bool is_array = (value->value_type == BSON_TYPE_ARRAY);
+		const uint32_t n = bson_count_keys (&doc);
+
+		if (is_array) jeeves_msgpack_write_array (buffer, n);
+		else jeeves_msgpack_write_map (buffer, n);
+
+		while (bson_iter_next (&iter)) {
+			const char *key = bson_iter_key (&iter);
+			if (!is_array) jeeves_msgpack_write_str (buffer, key, strlen (key));
+
+			jeeves_msgpack_write_value (
+				buffer, bson_iter_value (&iter), key, enum_name
+			);
+		}
+	}
+
+	else {
+		jeeves_msgpack_write_byte (buffer, 0xc0);
+	}
+
+}
+
+void jeeves_msgpack_write_value (
+	JeevesJson *buffer, const bson_value_t *value,
+	const char *key, JeevesJsonEnum enum_name
+) {
+
+	switch (value->value_type) {
+		case BSON_TYPE_UTF8:
+			jeeves_msgpack_write_str (
+				buffer, value->value.v_utf8.str, value->value.v_utf8.len
+			);
+			break;
+
+		case BSON_TYPE_OID: {
+			char oid[25] = { 0 };
+			bson_oid_to_string (&value->value.v_oid, oid);
+			jeeves_msgpack_write_str (buffer, oid, 24);
+		} break;
+
+		case BSON_TYPE_DATE_TIME:
+			jeeves_msgpack_write_date (buffer, value->value.v_datetime);
+			break;
+
+		case BSON_TYPE_INT32: {
+			const char *name = (enum_name && key) ?
+				enum_name (key, value->value.v_int32) : NULL;
+
+			if (name) jeeves_msgpack_write_str (buffer, name, strlen (name));
+			else jeeves_msgpack_write_int (buffer, value->value.v_int32);
+		} break;
+
+		case BSON_TYPE_INT64:
+			jeeves_msgpack_write_int (buffer, value->value.v_int64);
+			break;
+
+		case BSON_TYPE_DOUBLE:
+			jeeves_msgpack_write_double (buffer, value->value.v_double);
+			break;
+
+		case BSON_TYPE_BOOL:
+			jeeves_msgpack_write_byte (buffer, value->value.v_bool ? 0xc3 : 0xc2);
+			break;
+
+		case BSON_TYPE_DOCUMENT:
+		case BSON_TYPE_ARRAY:
+			jeeves_msgpack_write_document (buffer, value, enum_name);
+			break;
+
+		// the values that jeeves never stores
+		default:
+			jeeves_msgpack_write_byte (buffer, 0xc0);
+			break;
+	}
+
+}
+
+// appends the document in the format
+// bson documents are copied as they are
+// returns 0 on success, 1 on error
+unsigned int jeeves_format_write_bson (
+	JeevesJson *buffer, const JeevesFormat format,
+	const bson_t *doc, JeevesJsonEnum enum_name
+) {
+
+	unsigned int retval = 1;
+
+	switch (format) {
+		case JEEVES_FORMAT_JSON:
+			retval = jeeves_json_write_bson (buffer, doc, enum_name);
+			break;
+
+		case JEEVES_FORMAT_BSON:
+			jeeves_json_write (
+				buffer, (const char *) bson_get_data (doc), doc->len
+			);
+
+			retval = buffer->error ? 1 : 0;
+			break;
+
+		case JEEVES_FORMAT_MSGPACK: {
+			bson_value_t value = { 0 };
+			value.value_type = BSON_TYPE_DOCUMENT;
+			value.value.v_doc.data = (uint8_t *) bson_get_data (doc);
+			value.value.v_doc.data_len = doc->len;
+
+			jeeves_msgpack_write_value (buffer, &value, NULL, enum_name);
+
+			retval = buffer->error ? 1 : 0;
+		} break;
+	}
+
+	return retval;
+
+}
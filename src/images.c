@@ -0,0 +1,329 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <cerver/types/types.h>
+
+#include <cerver/utils/log.h>
+
+#include "images.h"
+
+// enough to hold the fixed headers of every supported format
+// and a pnm header with a few comments
+#define JEEVES_IMAGE_HEADER_SIZE		256
+
+const char *jeeves_image_format_to_string (
+	const ImageFormat format
+) {
+
+	switch (format) {
+		#define XX(num, name, string) case IMAGE_FORMAT_##name: return #string;
+		JEEVES_IMAGE_FORMAT_MAP(XX)
+		#undef XX
+	}
+
+	return jeeves_image_format_to_string (IMAGE_FORMAT_NONE);
+
+}
+
+static inline u32 jeeves_image_be16 (const u8 *p) {
+
+	return ((u32) p[0] << 8) | (u32) p[1];
+
+}
+
+static inline u32 jeeves_image_be32 (const u8 *p) {
+
+	return ((u32) p[0] << 24) | ((u32) p[1] << 16)
+		| ((u32) p[2] << 8) | (u32) p[3];
+
+}
+
+static inline u32 jeeves_image_le16 (const u8 *p) {
+
+	return (u32) p[0] | ((u32) p[1] << 8);
+
+}
+
+static inline u32 jeeves_image_le32 (const u8 *p) {
+
+	return (u32) p[0] | ((u32) p[1] << 8)
+		| ((u32) p[2] << 16) | ((u32) p[3] << 24);
+
+}
+
+static ImageFormat jeeves_image_sniff (
+	const u8 *header, const size_t len
+) {
+
+	ImageFormat format = IMAGE_FORMAT_NONE;
+
+	if (len >= 8 && !memcmp (header, "\x89PNG\r\n\x1a\n", 8))
+		format = IMAGE_FORMAT_PNG;
+
+	else if (len >= 3 && header[0] == 0xFF && header[1] == 0xD8 && header[2] == 0xFF)
+		format = IMAGE_FORMAT_JPEG;
+
+	else if (len >= 2 && header[0] == 'B' && header[1] == 'M')
+		format = IMAGE_FORMAT_BMP;
+
+	else if (len >= 6 && (!memcmp (header, "GIF87a", 6) || !memcmp (header, "GIF89a", 6)))
+		format = IMAGE_FORMAT_GIF;
+
+	else if (len >= 2 && header[0] == 'P' && (header[1] == '5' || header[1] == '6'))
+		format = IMAGE_FORMAT_PNM;
+
+	return format;
+
+}
+
+// signature (8) + IHDR length (4) + "IHDR" (4) + width (4) + height (4)
+// + bit depth (1) + color type (1)
+static unsigned int jeeves_image_info_png (
+	const u8 *header, const size_t len, ImageInfo *info
+) {
+
+	unsigned int retval = 1;
+
+	if (len >= 26 && !memcmp (header + 12, "IHDR", 4)) {
+		info->width = (int) jeeves_image_be32 (header + 16);
+		info->height = (int) jeeves_image_be32 (header + 20);
+
+		switch (header[25]) {
+			case 0: info->channels = 1; retval = 0; break;	// grey
+			case 2: info->channels = 3; retval = 0; break;	// rgb
+			case 3: info->channels = 3; retval = 0; break;	// palette
+			case 4: info->channels = 2; retval = 0; break;	// grey + alpha
+			case 6: info->channels = 4; retval = 0; break;	// rgba
+			default: break;
+		}
+	}
+
+	return retval;
+
+}
+
+// walks the segments until the first start of frame marker
+static unsigned int jeeves_image_info_jpeg (
+	FILE *file, ImageInfo *info
+) {
+
+	unsigned int retval = 1;
+
+	u8 segment[8] = { 0 };
+	int c = 0;
+
+	if (!fseek (file, 2, SEEK_SET)) {
+		for (;;) {
+			// markers can be padded with any number of 0xFF
+			if ((c = fgetc (file)) != 0xFF) break;
+			while ((c = fgetc (file)) == 0xFF);
+			if (c == EOF) break;
+
+			// standalone markers have no length
+			if (c == 0x01 || (c >= 0xD0 && c <= 0xD7)) continue;
+
+			// end of image or start of scan before any frame
+			if (c == 0xD9 || c == 0xDA) break;
+
+			if (fread (segment, 1, 2, file) != 2) break;
+			u32 segment_len = jeeves_image_be16 (segment);
+			if (segment_len < 2) break;
+
+			// SOF0 - SOF15 except DHT, JPG & DAC
+			if (
+				c >= 0xC0 && c <= 0xCF
+				&& c != 0xC4 && c != 0xC8 && c != 0xCC
+			) {
+				if (segment_len >= 8 && fread (segment, 1, 6, file) == 6) {
+					info->height = (int) jeeves_image_be16 (segment + 1);
+					info->width = (int) jeeves_image_be16 (segment + 3);
+					info->channels = (int) segment[5];
+
+					if (info->channels == 1 || info->channels == 3 || info->channels == 4)
+						retval = 0;
+				}
+
+				break;
+			}
+
+			if (fseek (file, (long) segment_len - 2, SEEK_CUR)) break;
+		}
+	}
+
+	return retval;
+
+}
+
+static unsigned int jeeves_image_info_bmp (
+	const u8 *header, const size_t len, ImageInfo *info
+) {
+
+	unsigned int retval = 1;
+
+	if (len >= 26) {
+		u32 dib_size = jeeves_image_le32 (header + 14);
+		u32 bpp = 0;
+
+		// OS/2 BITMAPCOREHEADER
+		if (dib_size == 12) {
+			info->width = (int) jeeves_image_le16 (header + 18);
+			info->height = (int) jeeves_image_le16 (header + 20);
+			bpp = jeeves_image_le16 (header + 24);
+		}
+
+		else if (dib_size >= 40 && len >= 30) {
+			info->width = (int) jeeves_image_le32 (header + 18);
+			// negative height means top-down rows
+			info->height = abs ((int) jeeves_image_le32 (header + 22));
+			bpp = jeeves_image_le16 (header + 28);
+		}
+
+		switch (bpp) {
+			case 1: case 4: case 8: case 16: case 24:
+				info->channels = 3; retval = 0; break;
+			case 32:
+				info->channels = 4; retval = 0; break;
+			default: break;
+		}
+	}
+
+	return retval;
+
+}
+
+static unsigned int jeeves_image_info_gif (
+	const u8 *header, const size_t len, ImageInfo *info
+) {
+
+	unsigned int retval = 1;
+
+	if (len >= 10) {
+		info->width = (int) jeeves_image_le16 (header + 6);
+		info->height = (int) jeeves_image_le16 (header + 8);
+		// frames are always decoded as rgba
+		info->channels = 4;
+
+		retval = 0;
+	}
+
+	return retval;
+
+}
+
+// gets the next ascii integer skipping whitespaces & comments
+static int jeeves_image_pnm_next_int (
+	const u8 *header, const size_t len, size_t *idx
+) {
+
+	int value = -1;
+
+	size_t i = *idx;
+	while (i < len) {
+		if (header[i] == '#') {
+			while (i < len && header[i] != '\n') i++;
+		}
+
+		else if (isspace (header[i])) i++;
+
+		else break;
+	}
+
+	if (i < len && isdigit (header[i])) {
+		value = 0;
+		while (i < len && isdigit (header[i]) && value < JEEVES_IMAGE_MAX_DIMENSION * 10) {
+			value = value * 10 + (header[i] - '0');
+			i++;
+		}
+	}
+
+	*idx = i;
+
+	return value;
+
+}
+
+static unsigned int jeeves_image_info_pnm (
+	const u8 *header, const size_t len, ImageInfo *info
+) {
+
+	unsigned int retval = 1;
+
+	size_t idx = 2;
+	info->width = jeeves_image_pnm_next_int (header, len, &idx);
+	info->height = jeeves_image_pnm_next_int (header, len, &idx);
+	int max_value = jeeves_image_pnm_next_int (header, len, &idx);
+
+	if (max_value > 0 && max_value < 65536) {
+		info->channels = (header[1] == '5') ? 1 : 3;
+
+		retval = 0;
+	}
+
+	return retval;
+
+}
+
+static unsigned int jeeves_image_info_check (const ImageInfo *info) {
+
+	unsigned int retval = 1;
+
+	if (
+		(info->width > 0) && (info->width <= JEEVES_IMAGE_MAX_DIMENSION)
+		&& (info->height > 0) && (info->height <= JEEVES_IMAGE_MAX_DIMENSION)
+		&& ((long) info->width * (long) info->height <= JEEVES_IMAGE_MAX_PIXELS)
+	) {
+		retval = 0;
+	}
+
+	return retval;
+
+}
+
+// sniffs the file's magic bytes & parses only its headers
+// to get the image's format, dimensions & number of channels
+// returns 0 if the file is a valid image, 1 on error
+unsigned int jeeves_image_info_read (
+	const char *filename, ImageInfo *info
+) {
+
+	unsigned int retval = 1;
+
+	if (filename && info) {
+		(void) memset (info, 0, sizeof (ImageInfo));
+
+		FILE *file = fopen (filename, "rb");
+		if (file) {
+			u8 header[JEEVES_IMAGE_HEADER_SIZE] = { 0 };
+			size_t len = fread (header, 1, JEEVES_IMAGE_HEADER_SIZE, file);
+
+			unsigned int errors = 1;
+			info->format = jeeves_image_sniff (header, len);
+			switch (info->format) {
+				case IMAGE_FORMAT_PNG: errors = jeeves_image_info_png (header, len, info); break;
+				case IMAGE_FORMAT_JPEG: errors = jeeves_image_info_jpeg (file, info); break;
+				case IMAGE_FORMAT_BMP: errors = jeeves_image_info_bmp (header, len, info); break;
+				case IMAGE_FORMAT_GIF: errors = jeeves_image_info_gif (header, len, info); break;
+				case IMAGE_FORMAT_PNM: errors = jeeves_image_info_pnm (header, len, info); break;
+
+				default: break;
+			}
+
+			if (!errors) retval = jeeves_image_info_check (info);
+
+			(void) fclose (file);
+		}
+	}
+
+	#ifdef JEEVES_DEBUG
+	if (retval) {
+		cerver_log_warning (
+			"jeeves_image_info_read () - %s is not a valid image!", filename
+		);
+	}
+	#endif
+
+	return retval;
+
+}
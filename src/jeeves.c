@@ -17,11 +17,16 @@
 
 #include <cmongo/mongo.h>
 
+#include "auth.h"
+#include "db.h"
+#include "dblimit.h"
 #include "jeeves.h"
 #include "runtime.h"
+#include "storage.h"
 #include "worker.h"
 
 #include "models/action.h"
+#include "models/fields.h"
 #include "models/job.h"
 #include "models/role.h"
 #include "models/user.h"
@@ -29,8 +34,12 @@
 #include "controllers/jobs.h"
 #include "controllers/roles.h"
 #include "controllers/service.h"
+#include "controllers/uploads.h"
 #include "controllers/users.h"
 
+#include "storage/memory.h"
+#include "storage/mongo.h"
+
 RuntimeType RUNTIME = RUNTIME_TYPE_NONE;
 
 unsigned int PORT = CERVER_DEFAULT_PORT;
@@ -39,6 +48,8 @@ unsigned int CERVER_RECEIVE_BUFFER_SIZE = CERVER_DEFAULT_RECEIVE_BUFFER_SIZE;
 unsigned int CERVER_TH_THREADS = CERVER_DEFAULT_POOL_THREADS;
 unsigned int CERVER_CONNECTION_QUEUE = CERVER_DEFAULT_CONNECTION_QUEUE;
 
+JeevesStorageType STORAGE_BACKEND = DEFAULT_STORAGE_BACKEND;
+
 static char MONGO_URI[MONGO_URI_SIZE] = { 0 };
 static char MONGO_APP_NAME[MONGO_APP_NAME_SIZE] = { 0 };
 static char MONGO_DB[MONGO_DB_SIZE] = { 0 };
@@ -51,6 +62,29 @@ const char *PUB_KEY = REAL_PUB_KEY;
 
 bool ENABLE_USERS_ROUTES = false;
 
+bool ENABLE_DIRECT_UPLOADS = false;
+const char *UPLOADS_TEMP_DIR = JEEVES_UPLOADS_TEMP_DIR;
+
+bool ENABLE_JOB_IMAGES_COLLECTION = false;
+
+unsigned int JOBS_WORKER_THREADS = DEFAULT_JOBS_WORKER_THREADS;
+JobsScheduler JOBS_SCHEDULER = DEFAULT_JOBS_SCHEDULER;
+double JOBS_SCHEDULER_AGING = DEFAULT_JOBS_SCHEDULER_AGING;
+
+size_t JOBS_CACHE_SIZE = DEFAULT_JOBS_CACHE_SIZE;
+
+unsigned int DB_SLOW_QUERY_MS = DEFAULT_DB_SLOW_QUERY_MS;
+
+unsigned int DB_INFLIGHT_LIMIT = DEFAULT_DB_INFLIGHT_LIMIT;
+
+unsigned int MONGO_POOL_SIZE = DEFAULT_MONGO_POOL_SIZE;
+bool MONGO_PIN_CLIENTS = false;
+
+unsigned int JWT_CACHE_TTL = DEFAULT_JWT_CACHE_TTL;
+size_t JWT_CACHE_SIZE = DEFAULT_JWT_CACHE_SIZE;
+
+unsigned int ROLES_RELOAD_INTERVAL = DEFAULT_ROLES_RELOAD_INTERVAL;
+
 static void jeeves_env_get_runtime (void) {
 	
 	char *runtime_env = getenv ("RUNTIME");
@@ -138,6 +172,25 @@ static void jeeves_env_get_cerver_connection_queue (void) {
 
 }
 
+static void jeeves_env_get_storage_backend (void) {
+
+	char *storage_backend = getenv ("STORAGE_BACKEND");
+	if (storage_backend && jeeves_storage_type_from_string (storage_backend)) {
+		STORAGE_BACKEND = jeeves_storage_type_from_string (storage_backend);
+		cerver_log_success (
+			"STORAGE_BACKEND -> %s", jeeves_storage_type_to_string (STORAGE_BACKEND)
+		);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get STORAGE_BACKEND from env - using default %s!",
+			jeeves_storage_type_to_string (STORAGE_BACKEND)
+		);
+	}
+
+}
+
 static unsigned int jeeves_env_get_mongo_app_name (void) {
 
 	unsigned int retval = 1;
@@ -276,6 +329,275 @@ static void jeeves_env_get_enable_users_routes (void) {
 
 }
 
+static void jeeves_env_get_enable_direct_uploads (void) {
+
+	char *direct_uploads = getenv ("ENABLE_DIRECT_UPLOADS");
+	if (direct_uploads) {
+		if (!strcmp (direct_uploads, "TRUE")) {
+			ENABLE_DIRECT_UPLOADS = true;
+			UPLOADS_TEMP_DIR = JEEVES_UPLOADS_INCOMING_DIR;
+			cerver_log_success ("ENABLE_DIRECT_UPLOADS -> TRUE\n");
+		}
+
+		else {
+			ENABLE_DIRECT_UPLOADS = false;
+			UPLOADS_TEMP_DIR = JEEVES_UPLOADS_TEMP_DIR;
+			cerver_log_success ("ENABLE_DIRECT_UPLOADS -> FALSE\n");
+		}
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get ENABLE_DIRECT_UPLOADS from env - using default FALSE!"
+		);
+	}
+
+}
+
+static void jeeves_env_get_enable_job_images_collection (void) {
+
+	char *images_collection = getenv ("ENABLE_JOB_IMAGES_COLLECTION");
+	if (images_collection) {
+		if (!strcmp (images_collection, "TRUE")) {
+			ENABLE_JOB_IMAGES_COLLECTION = true;
+			cerver_log_success ("ENABLE_JOB_IMAGES_COLLECTION -> TRUE\n");
+		}
+
+		else {
+			ENABLE_JOB_IMAGES_COLLECTION = false;
+			cerver_log_success ("ENABLE_JOB_IMAGES_COLLECTION -> FALSE\n");
+		}
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get ENABLE_JOB_IMAGES_COLLECTION from env - using default FALSE!"
+		);
+	}
+
+}
+
+static void jeeves_env_get_jobs_worker_threads (void) {
+
+	char *worker_threads = getenv ("JOBS_WORKER_THREADS");
+	if (worker_threads && (atoi (worker_threads) > 0)) {
+		JOBS_WORKER_THREADS = (unsigned int) atoi (worker_threads);
+		cerver_log_success ("JOBS_WORKER_THREADS -> %d", JOBS_WORKER_THREADS);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get JOBS_WORKER_THREADS from env - using default %d!",
+			JOBS_WORKER_THREADS
+		);
+	}
+
+}
+
+static void jeeves_env_get_jobs_scheduler (void) {
+
+	char *scheduler = getenv ("JOBS_SCHEDULER");
+	if (scheduler && jeeves_scheduler_from_string (scheduler)) {
+		JOBS_SCHEDULER = jeeves_scheduler_from_string (scheduler);
+		cerver_log_success (
+			"JOBS_SCHEDULER -> %s", jeeves_scheduler_to_string (JOBS_SCHEDULER)
+		);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get JOBS_SCHEDULER from env - using default %s!",
+			jeeves_scheduler_to_string (JOBS_SCHEDULER)
+		);
+	}
+
+}
+
+static void jeeves_env_get_jobs_scheduler_aging (void) {
+
+	char *aging = getenv ("JOBS_SCHEDULER_AGING");
+	if (aging) {
+		JOBS_SCHEDULER_AGING = atof (aging);
+		cerver_log_success ("JOBS_SCHEDULER_AGING -> %g", JOBS_SCHEDULER_AGING);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get JOBS_SCHEDULER_AGING from env - using default %g!",
+			JOBS_SCHEDULER_AGING
+		);
+	}
+
+}
+
+static void jeeves_env_get_jobs_cache_size (void) {
+
+	char *cache_size = getenv ("JOBS_CACHE_SIZE");
+	if (cache_size && (atoll (cache_size) >= 0)) {
+		JOBS_CACHE_SIZE = (size_t) atoll (cache_size);
+		cerver_log_success ("JOBS_CACHE_SIZE -> %zu", JOBS_CACHE_SIZE);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get JOBS_CACHE_SIZE from env - using default %zu!",
+			JOBS_CACHE_SIZE
+		);
+	}
+
+}
+
+static void jeeves_env_get_db_slow_query_ms (void) {
+
+	char *slow_query_ms = getenv ("DB_SLOW_QUERY_MS");
+	if (slow_query_ms && (atoi (slow_query_ms) >= 0)) {
+		DB_SLOW_QUERY_MS = (unsigned int) atoi (slow_query_ms);
+		cerver_log_success ("DB_SLOW_QUERY_MS -> %u", DB_SLOW_QUERY_MS);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get DB_SLOW_QUERY_MS from env - using default %u!",
+			DB_SLOW_QUERY_MS
+		);
+	}
+
+}
+
+// must be called after getting CERVER_TH_THREADS
+static void jeeves_env_get_db_inflight_limit (void) {
+
+	// at least one handler thread is always left
+	// for the requests that don't use the db
+	const unsigned int max_limit = (CERVER_TH_THREADS > 1) ? CERVER_TH_THREADS - 1 : 0;
+
+	char *limit = getenv ("DB_INFLIGHT_LIMIT");
+	if (limit) {
+		DB_INFLIGHT_LIMIT = (unsigned int) atoi (limit);
+		cerver_log_success ("DB_INFLIGHT_LIMIT -> %u", DB_INFLIGHT_LIMIT);
+	}
+
+	else {
+		DB_INFLIGHT_LIMIT = max_limit;
+		cerver_log_warning (
+			"Failed to get DB_INFLIGHT_LIMIT from env - using default %u!",
+			DB_INFLIGHT_LIMIT
+		);
+	}
+
+	if (DB_INFLIGHT_LIMIT > max_limit) {
+		cerver_log_warning (
+			"DB_INFLIGHT_LIMIT %u must be less than CERVER_TH_THREADS %u - using %u!",
+			DB_INFLIGHT_LIMIT, CERVER_TH_THREADS, max_limit
+		);
+
+		DB_INFLIGHT_LIMIT = max_limit;
+	}
+
+}
+
+static void jeeves_env_get_mongo_pool_size (void) {
+
+	char *pool_size = getenv ("MONGO_POOL_SIZE");
+	if (pool_size) {
+		MONGO_POOL_SIZE = (unsigned int) atoi (pool_size);
+		cerver_log_success ("MONGO_POOL_SIZE -> %u", MONGO_POOL_SIZE);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get MONGO_POOL_SIZE from env - using default %u!",
+			MONGO_POOL_SIZE
+		);
+	}
+
+}
+
+static void jeeves_env_get_mongo_pin_clients (void) {
+
+	char *pin_clients = getenv ("MONGO_PIN_CLIENTS");
+	if (pin_clients) {
+		if (!strcmp (pin_clients, "TRUE")) {
+			MONGO_PIN_CLIENTS = true;
+			cerver_log_success ("MONGO_PIN_CLIENTS -> TRUE\n");
+		}
+
+		else {
+			MONGO_PIN_CLIENTS = false;
+			cerver_log_success ("MONGO_PIN_CLIENTS -> FALSE\n");
+		}
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get MONGO_PIN_CLIENTS from env - using default FALSE!"
+		);
+	}
+
+	// pinned clients are never returned to the pool
+	if (
+		MONGO_PIN_CLIENTS && MONGO_POOL_SIZE
+		&& (JOBS_WORKER_THREADS >= MONGO_POOL_SIZE)
+	) {
+		cerver_log_warning (
+			"MONGO_POOL_SIZE %u leaves no clients for threads that are not pinned!",
+			MONGO_POOL_SIZE
+		);
+	}
+
+}
+
+static void jeeves_env_get_jwt_cache_ttl (void) {
+
+	char *ttl = getenv ("JWT_CACHE_TTL");
+	if (ttl) {
+		JWT_CACHE_TTL = (unsigned int) atoi (ttl);
+		cerver_log_success ("JWT_CACHE_TTL -> %u", JWT_CACHE_TTL);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get JWT_CACHE_TTL from env - using default %u!",
+			JWT_CACHE_TTL
+		);
+	}
+
+}
+
+static void jeeves_env_get_jwt_cache_size (void) {
+
+	char *cache_size = getenv ("JWT_CACHE_SIZE");
+	if (cache_size) {
+		JWT_CACHE_SIZE = (size_t) atoll (cache_size);
+		cerver_log_success ("JWT_CACHE_SIZE -> %zu", JWT_CACHE_SIZE);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get JWT_CACHE_SIZE from env - using default %zu!",
+			JWT_CACHE_SIZE
+		);
+	}
+
+}
+
+static void jeeves_env_get_roles_reload_interval (void) {
+
+	char *interval = getenv ("ROLES_RELOAD_INTERVAL");
+	if (interval) {
+		ROLES_RELOAD_INTERVAL = (unsigned int) atoi (interval);
+		cerver_log_success ("ROLES_RELOAD_INTERVAL -> %u", ROLES_RELOAD_INTERVAL);
+	}
+
+	else {
+		cerver_log_warning (
+			"Failed to get ROLES_RELOAD_INTERVAL from env - using default %u!",
+			ROLES_RELOAD_INTERVAL
+		);
+	}
+
+}
+
 static unsigned int jeeves_init_env (void) {
 
 	unsigned int errors = 0;
@@ -290,11 +612,16 @@ static unsigned int jeeves_init_env (void) {
 
 	jeeves_env_get_cerver_connection_queue ();
 
-	errors |= jeeves_env_get_mongo_app_name ();
+	jeeves_env_get_storage_backend ();
 
-	errors |= jeeves_env_get_mongo_db ();
+	// mongo values are only required to connect to the db
+	if (STORAGE_BACKEND == JEEVES_STORAGE_MONGO) {
+		errors |= jeeves_env_get_mongo_app_name ();
 
-	errors |= jeeves_env_get_mongo_uri ();
+		errors |= jeeves_env_get_mongo_db ();
+
+		errors |= jeeves_env_get_mongo_uri ();
+	}
 
 	errors |= jeeves_env_get_private_key ();
 
@@ -302,6 +629,32 @@ static unsigned int jeeves_init_env (void) {
 
 	jeeves_env_get_enable_users_routes ();
 
+	jeeves_env_get_enable_direct_uploads ();
+
+	jeeves_env_get_enable_job_images_collection ();
+
+	jeeves_env_get_jobs_worker_threads ();
+
+	jeeves_env_get_jobs_scheduler ();
+
+	jeeves_env_get_jobs_scheduler_aging ();
+
+	jeeves_env_get_jobs_cache_size ();
+
+	jeeves_env_get_db_slow_query_ms ();
+
+	jeeves_env_get_db_inflight_limit ();
+
+	jeeves_env_get_mongo_pool_size ();
+
+	jeeves_env_get_mongo_pin_clients ();
+
+	jeeves_env_get_jwt_cache_ttl ();
+
+	jeeves_env_get_jwt_cache_size ();
+
+	jeeves_env_get_roles_reload_interval ();
+
 	return errors;
 
 }
@@ -312,6 +665,14 @@ static unsigned int jeeves_mongo_connect (void) {
 
 	bool connected_to_mongo = false;
 
+	// both clients pools are created from the same uri
+	if (jeeves_db_uri_pool_size (MONGO_URI, MONGO_URI_SIZE, MONGO_POOL_SIZE)) {
+		cerver_log_error ("Failed to add MONGO_POOL_SIZE to MONGO_URI!");
+		errors |= 1;
+	}
+
+	errors |= jeeves_db_init (MONGO_URI, MONGO_APP_NAME, MONGO_DB);
+
 	mongo_set_uri (MONGO_URI);
 	mongo_set_app_name (MONGO_APP_NAME);
 	mongo_set_db_name (MONGO_DB);
@@ -321,10 +682,16 @@ static unsigned int jeeves_mongo_connect (void) {
 		if (!mongo_ping_db ()) {
 			cerver_log_success ("Connected to Mongo DB!");
 
+			errors |= model_fields_init ();
+
 			errors |= actions_model_init ();
 
 			errors |= jobs_model_init ();
 
+			if (ENABLE_JOB_IMAGES_COLLECTION) errors |= jobs_model_images_collection_init ();
+
+			if (JOBS_CACHE_SIZE) errors |= jobs_model_cache_init (JOBS_CACHE_SIZE);
+
 			errors |= roles_model_init ();
 
 			errors |= users_model_init ();
@@ -342,12 +709,26 @@ static unsigned int jeeves_mongo_connect (void) {
 
 }
 
-static unsigned int jeeves_mongo_init (void) {
+// sets the storage backend that every controller uses
+static unsigned int jeeves_storage_init (void) {
 
 	unsigned int retval = 1;
 
-	if (!jeeves_mongo_connect ()) {
-		if (!jeeves_roles_init ()) {
+	unsigned int errors = 0;
+	switch (STORAGE_BACKEND) {
+		case JEEVES_STORAGE_MEMORY:
+			errors |= jeeves_storage_memory_init ();
+			jeeves_storage = &jeeves_storage_memory;
+			break;
+
+		default:
+			errors |= jeeves_mongo_connect ();
+			jeeves_storage = &jeeves_storage_mongo;
+			break;
+	}
+
+	if (!errors) {
+		if (!jeeves_roles_init (ROLES_RELOAD_INTERVAL)) {
 			retval = 0;
 		}
 
@@ -368,14 +749,20 @@ unsigned int jeeves_init (void) {
 	if (!jeeves_init_env ()) {
 		unsigned int errors = 0;
 
-		errors |= jeeves_mongo_init ();
+		errors |= jeeves_storage_init ();
+
+		jeeves_db_limit_init (DB_INFLIGHT_LIMIT);
 
 		errors |= jeeves_service_init ();
 
 		errors |= jeeves_users_init ();
 
+		errors |= jeeves_auth_init (JWT_CACHE_TTL, JWT_CACHE_SIZE);
+
 		errors |= jeeves_jobs_init ();
 
+		errors |= jeeves_uploads_init ();
+
 		errors |= jeeves_worker_init ();
 
 		retval = errors;
@@ -399,6 +786,8 @@ static unsigned int jeeves_mongo_end (void) {
 		mongo_disconnect ();
 	}
 
+	jeeves_db_end ();
+
 	return 0;
 
 }
@@ -410,16 +799,22 @@ unsigned int jeeves_end (void) {
 
 	(void) jeeves_worker_end ();
 
-	errors |= jeeves_mongo_end ();
-
+	// the reload thread uses the storage
 	jeeves_roles_end ();
 
+	if (STORAGE_BACKEND == JEEVES_STORAGE_MEMORY) jeeves_storage_memory_end ();
+	else errors |= jeeves_mongo_end ();
+
+	jeeves_auth_end ();
+
 	jeeves_users_end ();
 
 	jeeves_service_end ();
 
 	jeeves_jobs_end ();
 
+	jeeves_uploads_end ();
+
 	return errors;
 
 }
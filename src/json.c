@@ -0,0 +1,333 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <bson/bson.h>
+
+#include "json.h"
+
+static pthread_key_t json_thread_key;
+static pthread_once_t json_thread_once = PTHREAD_ONCE_INIT;
+
+static void jeeves_json_thread_delete (void *json_ptr) {
+
+	jeeves_json_destroy ((JeevesJson *) json_ptr);
+	free (json_ptr);
+
+}
+
+static void jeeves_json_thread_key_create (void) {
+
+	(void) pthread_key_create (&json_thread_key, jeeves_json_thread_delete);
+
+}
+
+// gets the calling thread's reusable buffer
+// it is empty & is only valid until the next call
+JeevesJson *jeeves_json_thread (void) {
+
+	(void) pthread_once (&json_thread_once, jeeves_json_thread_key_create);
+
+	JeevesJson *json = (JeevesJson *) pthread_getspecific (json_thread_key);
+	if (!json) {
+		json = (JeevesJson *) calloc (1, sizeof (JeevesJson));
+		if (json) (void) pthread_setspecific (json_thread_key, json);
+	}
+
+	if (json) jeeves_json_reset (json);
+
+	return json;
+
+}
+
+void jeeves_json_reset (JeevesJson *json) {
+
+	// a single huge response should not be kept forever
+	if (json->size > JEEVES_JSON_KEEP_SIZE) {
+		jeeves_json_destroy (json);
+	}
+
+	json->len = 0;
+	json->error = false;
+
+	if (json->data) json->data[0] = '\0';
+
+}
+
+void jeeves_json_destroy (JeevesJson *json) {
+
+	free (json->data);
+	json->data = NULL;
+	json->len = 0;
+	json->size = 0;
+
+}
+
+// makes room for the extra bytes & the NUL
+static bool jeeves_json_reserve (JeevesJson *json, const size_t extra) {
+
+	bool retval = !json->error;
+
+	if (retval && ((json->len + extra + 1) > json->size)) {
+		size_t size = json->size ? json->size : JEEVES_JSON_INITIAL_SIZE;
+		while ((json->len + extra + 1) > size) size *= 2;
+
+		char *data = (char *) realloc (json->data, size);
+		if (data) {
+			json->data = data;
+			json->size = size;
+		}
+
+		else {
+			json->error = true;
+			retval = false;
+		}
+	}
+
+	return retval;
+
+}
+
+// appends raw bytes to the buffer
+void jeeves_json_write (
+	JeevesJson *json, const char *data, const size_t data_len
+) {
+
+	if (jeeves_json_reserve (json, data_len)) {
+		(void) memcpy (json->data + json->len, data, data_len);
+		json->len += data_len;
+		json->data[json->len] = '\0';
+	}
+
+}
+
+static inline void jeeves_json_write_char (JeevesJson *json, const char c) {
+
+	if (jeeves_json_reserve (json, 1)) {
+		json->data[json->len++] = c;
+		json->data[json->len] = '\0';
+	}
+
+}
+
+// writes the string's unescaped runs in a single copy
+static void jeeves_json_write_string (
+	JeevesJson *json, const char *str, const size_t len
+) {
+
+	static const char hex[] = "0123456789abcdef";
+
+	jeeves_json_write_char (json, '"');
+
+	size_t start = 0;
+	for (size_t i = 0; i < len; i++) {
+		const unsigned char c = (unsigned char) str[i];
+		if ((c < 0x20) || (c == '"') || (c == '\\')) {
+			jeeves_json_write (json, str + start, i - start);
+			start = i + 1;
+
+			switch (c) {
+				case '"': jeeves_json_write (json, "\\\"", 2); break;
+				case '\\': jeeves_json_write (json, "\\\\", 2); break;
+				case '\n': jeeves_json_write (json, "\\n", 2); break;
+				case '\r': jeeves_json_write (json, "\\r", 2); break;
+				case '\t': jeeves_json_write (json, "\\t", 2); break;
+
+				default: {
+					char escaped[6] = {
+						'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0f]
+					};
+
+					jeeves_json_write (json, escaped, 6);
+				} break;
+			}
+		}
+	}
+
+	jeeves_json_write (json, str + start, len - start);
+
+	jeeves_json_write_char (json, '"');
+
+}
+
+// "2024-01-31T12:00:00.000Z"
+static void jeeves_json_write_date (JeevesJson *json, const int64_t millis) {
+
+	int64_t seconds = millis / 1000;
+	int64_t ms = millis % 1000;
+	if (ms < 0) {
+		seconds -= 1;
+		ms += 1000;
+	}
+
+	const time_t t = (time_t) seconds;
+	struct tm tm = { 0 };
+
+	char date[40] = { 0 };
+	size_t date_len = 0;
+	if (gmtime_r (&t, &tm)) {
+		date_len = strftime (date, sizeof (date), "%Y-%m-%dT%H:%M:%S", &tm);
+		date_len += (size_t) snprintf (
+			date + date_len, sizeof (date) - date_len, ".%03dZ", (int) ms
+		);
+	}
+
+	jeeves_json_write_string (json, date, date_len);
+
+}
+
+static void jeeves_json_write_double (JeevesJson *json, const double value) {
+
+	char number[32] = { 0 };
+	int number_len = 0;
+
+	if (isfinite (value)) {
+		// shortest of the precisions that round trips
+		number_len = snprintf (number, sizeof (number), "%.15g", value);
+		const double parsed = strtod (number, NULL);
+		if (memcmp (&parsed, &value, sizeof (double))) {
+			number_len = snprintf (number, sizeof (number), "%.17g", value);
+		}
+
+		jeeves_json_write (json, number, (size_t) number_len);
+	}
+
+	else {
+		jeeves_json_write (json, "null", 4);
+	}
+
+}
+
+static void jeeves_json_write_document (
+	JeevesJson *json, bson_iter_t *iter,
+	const bool is_array, JeevesJsonEnum enum_name
+);
+
+static void jeeves_json_write_value (
+	JeevesJson *json, bson_iter_t *iter, JeevesJsonEnum enum_name
+) {
+
+	char number[32] = { 0 };
+	int number_len = 0;
+
+	bson_iter_t child = { 0 };
+
+	switch (bson_iter_type (iter)) {
+		case BSON_TYPE_UTF8: {
+			uint32_t len = 0;
+			const char *str = bson_iter_utf8 (iter, &len);
+			jeeves_json_write_string (json, str, len);
+		} break;
+
+		case BSON_TYPE_OID: {
+			char oid[25] = { 0 };
+			bson_oid_to_string (bson_iter_oid (iter), oid);
+			jeeves_json_write_string (json, oid, 24);
+		} break;
+
+		case BSON_TYPE_DATE_TIME:
+			jeeves_json_write_date (json, bson_iter_date_time (iter));
+			break;
+
+		case BSON_TYPE_INT32: {
+			const int32_t value = bson_iter_int32 (iter);
+			const char *name = enum_name ?
+				enum_name (bson_iter_key (iter), value) : NULL;
+
+			if (name) {
+				jeeves_json_write_string (json, name, strlen (name));
+			}
+
+			else {
+				number_len = snprintf (number, sizeof (number), "%" PRId32, value);
+				jeeves_json_write (json, number, (size_t) number_len);
+			}
+		} break;
+
+		case BSON_TYPE_INT64:
+			number_len = snprintf (
+				number, sizeof (number), "%" PRId64, bson_iter_int64 (iter)
+			);
+
+			jeeves_json_write (json, number, (size_t) number_len);
+			break;
+
+		case BSON_TYPE_DOUBLE:
+			jeeves_json_write_double (json, bson_iter_double (iter));
+			break;
+
+		case BSON_TYPE_BOOL:
+			if (bson_iter_bool (iter)) jeeves_json_write (json, "true", 4);
+			else jeeves_json_write (json, "false", 5);
+			break;
+
+		case BSON_TYPE_DOCUMENT:
+			if (bson_iter_recurse (iter, &child)) {
+				jeeves_json_write_document (json, &child, false, enum_name);
+			}
+			break;
+
+		case BSON_TYPE_ARRAY:
+			if (bson_iter_recurse (iter, &child)) {
+				jeeves_json_write_document (json, &child, true, enum_name);
+			}
+			break;
+
+		// the values that jeeves never stores
+		default:
+			jeeves_json_write (json, "null", 4);
+			break;
+	}
+
+}
+
+static void jeeves_json_write_document (
+	JeevesJson *json, bson_iter_t *iter,
+	const bool is_array, JeevesJsonEnum enum_name
+) {
+
+	jeeves_json_write_char (json, is_array ? '[' : '{');
+
+	bool first = true;
+	while (bson_iter_next (iter)) {
+		if (!first) jeeves_json_write_char (json, ',');
+		first = false;
+
+		if (!is_array) {
+			const char *key = bson_iter_key (iter);
+			jeeves_json_write_string (json, key, strlen (key));
+			jeeves_json_write_char (json, ':');
+		}
+
+		jeeves_json_write_value (json, iter, enum_name);
+	}
+
+	jeeves_json_write_char (json, is_array ? ']' : '}');
+
+}
+
+// appends the document in a single pass
+// oids are plain hex strings & dates are ISO 8601 strings
+// int32 values are written by their names if enum_name knows them
+// returns 0 on success, 1 on error
+unsigned int jeeves_json_write_bson (
+	JeevesJson *json, const bson_t *doc, JeevesJsonEnum enum_name
+) {
+
+	unsigned int retval = 1;
+
+	bson_iter_t iter = { 0 };
+	if (bson_iter_init (&iter, doc)) {
+		jeeves_json_write_document (json, &iter, false, enum_name);
+
+		retval = json->error ? 1 : 0;
+	}
+
+	return retval;
+
+}
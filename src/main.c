@@ -16,14 +16,23 @@
 #include <cerver/utils/log.h>
 #include <cerver/utils/utils.h>
 
+#include "allocs.h"
+#include "arena.h"
+#include "auth.h"
+#include "db.h"
+#include "dblimit.h"
 #include "files.h"
 #include "jeeves.h"
 #include "version.h"
 
+#include "models/job.h"
+
+#include "controllers/roles.h"
 #include "controllers/users.h"
 
 #include "routes/jobs.h"
 #include "routes/service.h"
+#include "routes/uploads.h"
 #include "routes/users.h"
 
 bool running = false;
@@ -39,6 +48,14 @@ static void end (int dummy) {
 		cerver_stats_print (jeeves_cerver, false, false);
 		cerver_log_msg ("\nHTTP Cerver stats:\n");
 		http_cerver_all_stats_print ((HttpCerver *) jeeves_cerver->cerver_data);
+		#ifdef JEEVES_DEBUG
+		jeeves_allocs_print ();
+		#endif
+		jeeves_arena_print ();
+		jeeves_auth_print ();
+		jobs_model_cache_print ();
+		jeeves_db_limit_print ();
+		jeeves_db_clients_print ();
 		cerver_log_line_break ();
 		cerver_teardown (jeeves_cerver);
 	}
@@ -65,16 +82,14 @@ static void jeeves_set_routes (HttpCerver *http_cerver) {
 
 	// GET /api/jeeves/auth
 	HttpRoute *jeeves_auth_route = http_route_create (REQUEST_METHOD_GET, "auth", jeeves_auth_handler);
-	http_route_set_auth (jeeves_auth_route, HTTP_ROUTE_AUTH_TYPE_BEARER);
-	http_route_set_decode_data (jeeves_auth_route, jeeves_user_parse_from_json, jeeves_user_delete);
+	jeeves_auth_route_set (jeeves_auth_route);
 	http_route_child_add (jeeves_route, jeeves_auth_route);
 
 	/*** jobs ***/
 
 	// GET /api/jeeves/jobs
 	HttpRoute *jeeves_jobs_route = http_route_create (REQUEST_METHOD_GET, "jobs", jeeves_get_jobs_handler);
-	http_route_set_auth (jeeves_jobs_route, HTTP_ROUTE_AUTH_TYPE_BEARER);
-	http_route_set_decode_data (jeeves_jobs_route, jeeves_user_parse_from_json, jeeves_user_delete);
+	jeeves_auth_route_set (jeeves_jobs_route);
 	http_route_child_add (jeeves_route, jeeves_jobs_route);
 
 	// POST /api/jeeves/jobs
@@ -86,37 +101,41 @@ static void jeeves_set_routes (HttpCerver *http_cerver) {
 
 	// GET /api/jeeves/jobs/:id/info
 	HttpRoute *jeeves_jobs_info_route = http_route_create (REQUEST_METHOD_GET, "jobs/:id/info", jeeves_job_info_handler);
-	http_route_set_auth (jeeves_jobs_info_route, HTTP_ROUTE_AUTH_TYPE_BEARER);
-	http_route_set_decode_data (jeeves_jobs_info_route, jeeves_user_parse_from_json, jeeves_user_delete);
+	jeeves_auth_route_set (jeeves_jobs_info_route);
 	http_route_child_add (jeeves_route, jeeves_jobs_info_route);
 
 	// POST /api/jeeves/jobs/:id/config
 	HttpRoute *jeeves_jobs_config_route = http_route_create (REQUEST_METHOD_POST, "jobs/:id/config", jeeves_job_config_handler);
-	http_route_set_auth (jeeves_jobs_config_route, HTTP_ROUTE_AUTH_TYPE_BEARER);
-	http_route_set_decode_data (jeeves_jobs_config_route, jeeves_user_parse_from_json, jeeves_user_delete);
+	jeeves_auth_route_set (jeeves_jobs_config_route);
 	http_route_child_add (jeeves_route, jeeves_jobs_config_route);
 
 	// POST /api/jeeves/jobs/:id/upload
 	HttpRoute *jeeves_jobs_upload_route = http_route_create (REQUEST_METHOD_POST, "jobs/:id/upload", jeeves_job_upload_handler);
 	http_route_set_modifier (jeeves_jobs_upload_route, HTTP_ROUTE_MODIFIER_MULTI_PART);
-	http_route_set_auth (jeeves_jobs_upload_route, HTTP_ROUTE_AUTH_TYPE_BEARER);
-	http_route_set_decode_data (jeeves_jobs_upload_route, jeeves_user_parse_from_json, jeeves_user_delete);
+	jeeves_auth_route_set (jeeves_jobs_upload_route);
 	http_route_child_add (jeeves_route, jeeves_jobs_upload_route);
 
 	// GET /api/jeeves/jobs/:id/start
 	HttpRoute *jeeves_jobs_start_route = http_route_create (REQUEST_METHOD_GET, "jobs/:id/start", jeeves_job_start_handler);
-	http_route_set_auth (jeeves_jobs_start_route, HTTP_ROUTE_AUTH_TYPE_BEARER);
-	http_route_set_decode_data (jeeves_jobs_start_route, jeeves_user_parse_from_json, jeeves_user_delete);
+	jeeves_auth_route_set (jeeves_jobs_start_route);
 	http_route_child_add (jeeves_route, jeeves_jobs_start_route);
 
 	// GET /api/jeeves/jobs/:id/stop
 	HttpRoute *jeeves_jobs_stop_route = http_route_create (REQUEST_METHOD_GET, "jobs/:id/stop", jeeves_job_stop_handler);
-	http_route_set_auth (jeeves_jobs_stop_route, HTTP_ROUTE_AUTH_TYPE_BEARER);
-	http_route_set_decode_data (jeeves_jobs_stop_route, jeeves_user_parse_from_json, jeeves_user_delete);
+	jeeves_auth_route_set (jeeves_jobs_stop_route);
 	http_route_child_add (jeeves_route, jeeves_jobs_stop_route);
 
 }
 
+static void jeeves_set_uploads_routes (HttpCerver *http_cerver) {
+
+	// GET /api/uploads/:user/:dirname/:filename
+	HttpRoute *uploads_route = http_route_create (REQUEST_METHOD_GET, "api/uploads/:id/:id/:id", jeeves_uploads_handler);
+	jeeves_auth_route_set (uploads_route);
+	http_cerver_route_register (http_cerver, uploads_route);
+
+}
+
 static void jeeves_set_users_routes (HttpCerver *http_cerver) {
 
 	/* register top level route */
@@ -155,7 +174,7 @@ static void start (void) {
 		/*** web cerver configuration ***/
 		http_cerver = (HttpCerver *) jeeves_cerver->cerver_data;
 
-		http_cerver_set_uploads_path (http_cerver, JEEVES_UPLOADS_TEMP_DIR);
+		http_cerver_set_uploads_path (http_cerver, UPLOADS_TEMP_DIR);
 		http_cerver_set_uploads_dirname_generator (http_cerver, jeeves_uploads_dirname_generator);
 
 		http_cerver_auth_set_jwt_algorithm (http_cerver, JWT_ALG_RS256);
@@ -167,6 +186,8 @@ static void start (void) {
 
 		jeeves_set_routes (http_cerver);
 
+		jeeves_set_uploads_routes (http_cerver);
+
 		if (ENABLE_USERS_ROUTES) {
 			jeeves_set_users_routes (http_cerver);
 		}
@@ -198,12 +219,19 @@ int main (int argc, const char **argv) {
 
 	srand ((unsigned int) time (NULL));
 
+	#ifdef JEEVES_DEBUG
+	// counts bson allocations only in development builds
+	jeeves_allocs_init ();
+	#endif
+
 	(void) signal (SIGINT, end);
 	(void) signal (SIGTERM, end);
 	(void) signal (SIGKILL, end);
 
 	(void) signal (SIGPIPE, SIG_IGN);
 
+	(void) signal (SIGHUP, jeeves_roles_reload_signal);
+
 	cerver_init ();
 
 	cerver_version_print_full ();
@@ -8,6 +8,7 @@
 #include <cmongo/crud.h>
 #include <cmongo/model.h>
 
+#include "models/fields.h"
 #include "models/action.h"
 
 #define ACTIONS_COLL_NAME  				"actions"
@@ -125,24 +126,32 @@ void action_doc_parse (
 			const char *key = bson_iter_key (&iter);
 			const bson_value_t *value = bson_iter_value (&iter);
 
-			if (!strcmp (key, "_id")) {
-				bson_oid_copy (&value->value.v_oid, &action->oid);
-			}
-
-			else if (!strcmp (key, "name") && value->value.v_utf8.str) {
-				(void) strncpy (
-					action->name,
-					value->value.v_utf8.str,
-					ACTION_NAME_SIZE - 1
-				);
-			}
-
-			else if (!strcmp (key, "description") && value->value.v_utf8.str) {
-				(void) strncpy (
-					action->description,
-					value->value.v_utf8.str,
-					ACTION_DESCRIPTION_SIZE - 1
-				);
+			switch (model_field_get (key)) {
+				case MODEL_FIELD_ID:
+					bson_oid_copy (&value->value.v_oid, &action->oid);
+					break;
+
+				case MODEL_FIELD_NAME:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							action->name,
+							value->value.v_utf8.str,
+							ACTION_NAME_SIZE - 1
+						);
+					}
+					break;
+
+				case MODEL_FIELD_DESCRIPTION:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							action->description,
+							value->value.v_utf8.str,
+							ACTION_DESCRIPTION_SIZE - 1
+						);
+					}
+					break;
+
+				default: break;
 			}
 		}
 	}
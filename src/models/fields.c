@@ -0,0 +1,111 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cerver/types/types.h>
+
+#include <cerver/utils/log.h>
+
+#include "models/fields.h"
+
+#define MODEL_FIELDS_MASK				(MODEL_FIELDS_TABLE_SIZE - 1)
+
+#define MODEL_FIELDS_MAX_SEED			1000000
+
+static const char *model_fields_names[] = {
+
+	NULL,
+
+	#define XX(num, name, string) #string,
+	MODEL_FIELD_MAP (XX)
+	#undef XX
+
+};
+
+#define MODEL_FIELDS_COUNT				\
+	(sizeof (model_fields_names) / sizeof (model_fields_names[0]))
+
+static u32 model_fields_seed = MODEL_FIELDS_SEED;
+
+static ModelField model_fields_table[MODEL_FIELDS_TABLE_SIZE] = { MODEL_FIELD_NONE };
+
+const char *model_field_to_string (const ModelField field) {
+
+	return ((unsigned int) field < MODEL_FIELDS_COUNT) && model_fields_names[field] ?
+		model_fields_names[field] : "None";
+
+}
+
+// fnv-1a with its offset basis mixed with the seed
+static inline u32 model_fields_hash (const u32 seed, const char *key) {
+
+	u32 hash = 2166136261u ^ seed;
+	for (const u8 *p = (const u8 *) key; *p; p++) {
+		hash ^= *p;
+		hash *= 16777619u;
+	}
+
+	return (hash ^ (hash >> 16)) & MODEL_FIELDS_MASK;
+
+}
+
+// fills the table if every field gets its own slot
+static bool model_fields_table_build (const u32 seed) {
+
+	(void) memset (model_fields_table, 0, sizeof (model_fields_table));
+
+	u32 idx = 0;
+	for (unsigned int field = 1; field < MODEL_FIELDS_COUNT; field++) {
+		idx = model_fields_hash (seed, model_fields_names[field]);
+		if (model_fields_table[idx] != MODEL_FIELD_NONE) return false;
+
+		model_fields_table[idx] = (ModelField) field;
+	}
+
+	return true;
+
+}
+
+// builds the fields perfect hash table
+unsigned int model_fields_init (void) {
+
+	unsigned int retval = 1;
+
+	if (model_fields_table_build (MODEL_FIELDS_SEED)) {
+		retval = 0;
+	}
+
+	else {
+		// the fields map has changed since the seed was generated
+		for (u32 seed = 1; seed < MODEL_FIELDS_MAX_SEED; seed++) {
+			if (model_fields_table_build (seed)) {
+				cerver_log_warning (
+					"MODEL_FIELDS_SEED is outdated - update it to %u", seed
+				);
+
+				model_fields_seed = seed;
+				retval = 0;
+				break;
+			}
+		}
+	}
+
+	if (retval) {
+		cerver_log_error ("Failed to build model fields table!");
+	}
+
+	return retval;
+
+}
+
+// gets the field that matches the document's key
+// with a single hash & a single string compare
+// returns MODEL_FIELD_NONE for unknown keys
+ModelField model_field_get (const char *key) {
+
+	ModelField field = model_fields_table[model_fields_hash (model_fields_seed, key)];
+
+	return (field && !strcmp (model_fields_names[field], key)) ?
+		field : MODEL_FIELD_NONE;
+
+}
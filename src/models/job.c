@@ -9,16 +9,53 @@
 #include <cmongo/crud.h>
 #include <cmongo/model.h>
 
+#include "cache.h"
+#include "db.h"
+
+#include "models/fields.h"
 #include "models/job.h"
 
 #define JOBS_COLL_NAME         				"jobs"
+#define JOB_IMAGES_COLL_NAME				"job_images"
 
 static CMongoModel *jobs_model = NULL;
 
+// set when images are kept in their own collection
+static CMongoModel *job_images_model = NULL;
+
+// image docs without the keys that are only used to query them
+static bson_t job_images_opts = BSON_INITIALIZER;
+
+// rendered GET /jobs/:id/info values by job
+static JeevesCache *jobs_info_cache = NULL;
+
+// rendered GET /jobs first page by user
+static JeevesCache *jobs_list_cache = NULL;
+
+// the indexes that the jobs queries rely on
+static const JeevesDbIndex jobs_indexes[] = {
+	// user's jobs pages
+	{ "user_1__id_1", { "user", "_id" }, false },
+	{ "user_1_status_1__id_1", { "user", "status", "_id" }, false },
+	{ "user_1_created_1", { "user", "created" }, false },
+
+	// image results updates
+	{ "_id_1_images._id_1", { "_id", "images._id" }, false }
+};
+
+static const JeevesDbIndex job_images_indexes[] = {
+	// a job's images pages & results updates
+	{ "job_1_image_1", { "job", "image" }, true }
+};
+
 static void jeeves_job_doc_parse (
 	void *job_ptr, const bson_t *job_doc
 );
 
+static void jeeves_job_image_doc_parse (
+	void *job_image_ptr, const bson_t *job_image_doc
+);
+
 unsigned int jobs_model_init (void) {
 
 	unsigned int retval = 1;
@@ -27,6 +64,46 @@ unsigned int jobs_model_init (void) {
 	if (jobs_model) {
 		cmongo_model_set_parser (jobs_model, jeeves_job_doc_parse);
 
+		(void) jeeves_db_create_indexes (
+			JOBS_COLL_NAME,
+			jobs_indexes, sizeof (jobs_indexes) / sizeof (JeevesDbIndex)
+		);
+
+		retval = 0;
+	}
+
+	return retval;
+
+}
+
+// keeps each image in its own document
+// instead of an array inside the job's document
+unsigned int jobs_model_images_collection_init (void) {
+
+	unsigned int retval = 1;
+
+	job_images_model = cmongo_model_create (JOB_IMAGES_COLL_NAME);
+	if (job_images_model) {
+		cmongo_model_set_parser (job_images_model, jeeves_job_image_doc_parse);
+
+		(void) jeeves_db_create_indexes (
+			JOB_IMAGES_COLL_NAME,
+			job_images_indexes,
+			sizeof (job_images_indexes) / sizeof (JeevesDbIndex)
+		);
+
+		bson_t projection_doc = BSON_INITIALIZER;
+		(void) bson_append_document_begin (&job_images_opts, "projection", -1, &projection_doc);
+		(void) bson_append_bool (&projection_doc, "_id", -1, false);
+		(void) bson_append_bool (&projection_doc, "job", -1, false);
+		(void) bson_append_bool (&projection_doc, "user", -1, false);
+		(void) bson_append_document_end (&job_images_opts, &projection_doc);
+
+		bson_t sort_doc = BSON_INITIALIZER;
+		(void) bson_append_document_begin (&job_images_opts, "sort", -1, &sort_doc);
+		(void) bson_append_int32 (&sort_doc, "image", -1, 1);
+		(void) bson_append_document_end (&job_images_opts, &sort_doc);
+
 		retval = 0;
 	}
 
@@ -38,6 +115,54 @@ void jobs_model_end (void) {
 
 	cmongo_model_delete (jobs_model);
 
+	cmongo_model_delete (job_images_model);
+	job_images_model = NULL;
+
+	bson_reinit (&job_images_opts);
+
+	jeeves_cache_delete (jobs_info_cache);
+	jobs_info_cache = NULL;
+
+	jeeves_cache_delete (jobs_list_cache);
+	jobs_list_cache = NULL;
+
+}
+
+// enables the jobs json caches with max bytes each
+unsigned int jobs_model_cache_init (const size_t max_bytes) {
+
+	unsigned int retval = 1;
+
+	jobs_info_cache = jeeves_cache_create ("Jobs info", max_bytes);
+	jobs_list_cache = jeeves_cache_create ("Jobs list", max_bytes);
+
+	if (jobs_info_cache && jobs_list_cache) retval = 0;
+
+	return retval;
+
+}
+
+void jobs_model_cache_print (void) {
+
+	jeeves_cache_print (jobs_info_cache);
+	jeeves_cache_print (jobs_list_cache);
+
+}
+
+// the job's info is always affected by a write
+// the user's list only if a listed value has changed
+static void jobs_model_cache_invalidate (
+	const bson_oid_t *job_oid, const bson_oid_t *user_oid
+) {
+
+	if (jobs_info_cache && job_oid) {
+		jeeves_cache_invalidate (jobs_info_cache, job_oid);
+	}
+
+	if (jobs_list_cache && user_oid) {
+		jeeves_cache_invalidate (jobs_list_cache, user_oid);
+	}
+
 }
 
 const char *job_status_to_string (const JobStatus status) {
@@ -79,6 +204,19 @@ JobType job_type_from_string (const char *type_string) {
 
 }
 
+// writes jobs status & type and images format by their names
+const char *job_json_enum (const char *key, const int32_t value) {
+
+	const char *name = NULL;
+
+	if (!strcmp (key, "status")) name = job_status_to_string ((JobStatus) value);
+	else if (!strcmp (key, "type")) name = job_type_to_string ((JobType) value);
+	else if (!strcmp (key, "format")) name = jeeves_image_format_to_string ((ImageFormat) value);
+
+	return name;
+
+}
+
 JobImage *job_image_new (void) {
 
 	JobImage *job_image = (JobImage *) malloc (sizeof (JobImage));
@@ -115,6 +253,38 @@ JobImage *job_image_create (
 
 }
 
+static void job_image_append_fields (bson_t *doc, const JobImage *job_image) {
+
+	(void) bson_append_utf8 (doc, "saved", -1, job_image->saved, -1);
+	(void) bson_append_utf8 (doc, "original", -1, job_image->original, -1);
+	(void) bson_append_utf8 (doc, "result", -1, job_image->result, -1);
+	(void) bson_append_utf8 (doc, "hash", -1, job_image->hash, -1);
+	(void) bson_append_int32 (doc, "format", -1, job_image->format);
+	(void) bson_append_int32 (doc, "width", -1, job_image->width);
+	(void) bson_append_int32 (doc, "height", -1, job_image->height);
+	(void) bson_append_int32 (doc, "channels", -1, job_image->channels);
+
+}
+
+void job_image_append_bson (bson_t *doc, const JobImage *job_image) {
+
+	(void) bson_append_int32 (doc, "_id", -1, job_image->id);
+	job_image_append_fields (doc, job_image);
+
+}
+
+// the image's document in the images collection
+static void job_image_doc_append_bson (
+	bson_t *doc, const JeevesJob *job, const JobImage *job_image
+) {
+
+	(void) bson_append_oid (doc, "job", -1, &job->oid);
+	(void) bson_append_oid (doc, "user", -1, &job->user_oid);
+	(void) bson_append_int32 (doc, "image", -1, job_image->id);
+	job_image_append_fields (doc, job_image);
+
+}
+
 bson_t *job_image_to_bson (JobImage *job_image) {
 
 	bson_t *doc = NULL;
@@ -122,9 +292,7 @@ bson_t *job_image_to_bson (JobImage *job_image) {
 	if (job_image) {
 		doc = bson_new ();
 		if (doc) {
-			(void) bson_append_int32 (doc, "_id", -1, job_image->id);
-			(void) bson_append_utf8 (doc, "original", -1, job_image->original, -1);
-			(void) bson_append_utf8 (doc, "result", -1, job_image->result, -1);
+			job_image_append_bson (doc, job_image);
 		}
 	}
 
@@ -137,8 +305,6 @@ void *jeeves_job_new (void) {
 	JeevesJob *job = (JeevesJob *) malloc (sizeof (JeevesJob));
 	if (job) {
 		(void) memset (job, 0, sizeof (JeevesJob));
-
-		job->images = dlist_init (job_image_delete, NULL);
 	}
 
 	return job;
@@ -150,7 +316,7 @@ void jeeves_job_delete (void *job_ptr) {
 	if (job_ptr) {
 		JeevesJob *job = (JeevesJob *) job_ptr;
 
-		dlist_delete (job->images);
+		free (job->images);
 		job->images = NULL;
 
 		free (job_ptr);
@@ -158,6 +324,65 @@ void jeeves_job_delete (void *job_ptr) {
 
 }
 
+// makes sure the job can hold n images without reallocating
+// returns 0 on success, 1 on error
+unsigned int jeeves_job_images_reserve (
+	JeevesJob *job, const size_t n
+) {
+
+	unsigned int retval = 0;
+
+	if (n > job->images_capacity) {
+		size_t capacity = job->images_capacity ?
+			job->images_capacity : JOB_IMAGES_INITIAL_CAPACITY;
+		while (capacity < n) capacity *= 2;
+
+		JobImage *images = (JobImage *) realloc (
+			job->images, capacity * sizeof (JobImage)
+		);
+
+		if (images) {
+			job->images = images;
+			job->images_capacity = capacity;
+		}
+
+		else {
+			retval = 1;
+		}
+	}
+
+	return retval;
+
+}
+
+// gets the next empty image in the job's buffer
+static JobImage *jeeves_job_images_next (JeevesJob *job) {
+
+	JobImage *job_image = NULL;
+
+	if (!jeeves_job_images_reserve (job, job->images_count + 1)) {
+		job_image = &job->images[job->images_count];
+		job->images_count += 1;
+	}
+
+	return job_image;
+
+}
+
+// appends a copy of the image into the job's images buffer
+JobImage *jeeves_job_images_add (
+	JeevesJob *job, const JobImage *job_image
+) {
+
+	JobImage *image = jeeves_job_images_next (job);
+	if (image) {
+		(void) memcpy (image, job_image, sizeof (JobImage));
+	}
+
+	return image;
+
+}
+
 void jeeves_job_print (const JeevesJob *job) {
 
 	if (job) {
@@ -179,63 +404,136 @@ void jeeves_job_print (const JeevesJob *job) {
 }
 
 
+// copies the string value without padding the rest of the field
+static inline void jeeves_job_doc_parse_string (
+	char *dst, const bson_value_t *value, const size_t size
+) {
+
+	if (value->value_type == BSON_TYPE_UTF8) {
+		size_t len = value->value.v_utf8.len < size ?
+			value->value.v_utf8.len : size - 1;
+
+		(void) memcpy (dst, value->value.v_utf8.str, len);
+		dst[len] = '\0';
+	}
+
+}
+
+static void jeeves_job_doc_parse_image (
+	JobImage *job_image, bson_iter_t *image_iter
+) {
+
+	job_image->id = 0;
+	job_image->saved[0] = '\0';
+	job_image->original[0] = '\0';
+	job_image->result[0] = '\0';
+	job_image->hash[0] = '\0';
+	job_image->format = IMAGE_FORMAT_NONE;
+	job_image->width = 0;
+	job_image->height = 0;
+	job_image->channels = 0;
+
+	while (bson_iter_next (image_iter)) {
+		const char *key = bson_iter_key (image_iter);
+		const bson_value_t *value = bson_iter_value (image_iter);
+
+		switch (model_field_get (key)) {
+			// embedded images are identified by their _id
+			case MODEL_FIELD_ID:
+				if (value->value_type == BSON_TYPE_INT32) {
+					job_image->id = value->value.v_int32;
+				}
+				break;
+
+			// documents in the images collection
+			case MODEL_FIELD_IMAGE:
+				job_image->id = value->value.v_int32;
+				break;
+
+			case MODEL_FIELD_SAVED:
+				jeeves_job_doc_parse_string (
+					job_image->saved, value, JOB_IMAGE_SAVED_SIZE
+				);
+				break;
+
+			case MODEL_FIELD_ORIGINAL:
+				jeeves_job_doc_parse_string (
+					job_image->original, value, JOB_IMAGE_ORIGINAL_SIZE
+				);
+				break;
+
+			case MODEL_FIELD_RESULT:
+				jeeves_job_doc_parse_string (
+					job_image->result, value, JOB_IMAGE_RESULT_SIZE
+				);
+				break;
+
+			case MODEL_FIELD_HASH:
+				jeeves_job_doc_parse_string (
+					job_image->hash, value, JOB_IMAGE_HASH_SIZE
+				);
+				break;
+
+			case MODEL_FIELD_FORMAT:
+				job_image->format = (ImageFormat) value->value.v_int32;
+				break;
+
+			case MODEL_FIELD_WIDTH:
+				job_image->width = value->value.v_int32;
+				break;
+
+			case MODEL_FIELD_HEIGHT:
+				job_image->height = value->value.v_int32;
+				break;
+
+			case MODEL_FIELD_CHANNELS:
+				job_image->channels = value->value.v_int32;
+				break;
+
+			default: break;
+		}
+	}
+
+}
+
+static void jeeves_job_image_doc_parse (
+	void *job_image_ptr, const bson_t *job_image_doc
+) {
+
+	bson_iter_t iter = { 0 };
+	if (bson_iter_init (&iter, job_image_doc)) {
+		jeeves_job_doc_parse_image ((JobImage *) job_image_ptr, &iter);
+	}
+
+}
+
+// walks the images array in place inside the job's document
+// and fills the job's images buffer
 static void jeeves_job_doc_parse_images (
 	JeevesJob *job, bson_iter_t *iter
 ) {
 
-	const u8 *data = NULL;
-	u32 len = 0;
-	bson_iter_array (iter, &len, &data);
-
-	bson_t *images_array = bson_new_from_data (data, len);
 	bson_iter_t array_iter = { 0 };
-	if (bson_iter_init (&array_iter, images_array)) {
-		while (bson_iter_next (&array_iter)) {
-			// const char *key = bson_iter_key (&array_iter);
-			const bson_value_t *value = bson_iter_value (&array_iter);
-
-			const u8 *data = value->value.v_doc.data;
-			u32 len = value->value.v_doc.data_len;
-
-			bson_t *image_doc = bson_new_from_data (data, len);
-			if (image_doc) {
-				bson_iter_t at_iter = { 0 };
-				if (bson_iter_init (&at_iter, image_doc)) {
-					JobImage *job_image = job_image_new ();
-					while (bson_iter_next (&at_iter)) {
-						const char *key = bson_iter_key (&at_iter);
-						const bson_value_t *value = bson_iter_value (&at_iter);
-
-						if (!strcmp (key, "_id")) {
-							// printf ("%d\n", value->value.v_int32);
-							job_image->id = value->value.v_int32;
-						}
-
-						else if (!strcmp (key, "original")) {
-							// printf ("%s\n", value->value.v_utf8.str);
-							(void) strncpy (
-								job_image->original,
-								value->value.v_utf8.str,
-								JOB_IMAGE_ORIGINAL_SIZE - 1
-							);
-						}
-
-						else if (!strcmp (key, "result")) {
-							// printf ("%s\n", value->value.v_utf8.str);
-							(void) strncpy (
-								job_image->result,
-								value->value.v_utf8.str,
-								JOB_IMAGE_RESULT_SIZE - 1
-							);
-						}
-					}
+	bson_iter_t image_iter = { 0 };
 
-					(void) dlist_insert_at_end_unsafe (
-						job->images, job_image
-					);
-				}
+	if (BSON_ITER_HOLDS_ARRAY (iter) && bson_iter_recurse (iter, &array_iter)) {
+		// imagesCount is stored before the images array
+		if (job->n_images > 0) {
+			(void) jeeves_job_images_reserve (
+				job, job->images_count + (size_t) job->n_images
+			);
+		}
 
-				bson_destroy (image_doc);
+		JobImage *job_image = NULL;
+		while (bson_iter_next (&array_iter)) {
+			if (
+				BSON_ITER_HOLDS_DOCUMENT (&array_iter)
+				&& bson_iter_recurse (&array_iter, &image_iter)
+			) {
+				job_image = jeeves_job_images_next (job);
+				if (!job_image) break;
+
+				jeeves_job_doc_parse_image (job_image, &image_iter);
 			}
 		}
 	}
@@ -256,78 +554,100 @@ static void jeeves_job_doc_parse (
 			key = (char *) bson_iter_key (&iter);
 			value = (bson_value_t *) bson_iter_value (&iter);
 
-			if (!strcmp (key, "_id")) {
-				bson_oid_copy (&value->value.v_oid, &job->oid);
-				bson_oid_to_string (&job->oid, job->id);
-			}
+			switch (model_field_get (key)) {
+				case MODEL_FIELD_ID:
+					bson_oid_copy (&value->value.v_oid, &job->oid);
+					bson_oid_to_string (&job->oid, job->id);
+					break;
+
+				case MODEL_FIELD_USER:
+					bson_oid_copy (&value->value.v_oid, &job->user_oid);
+					break;
+
+				case MODEL_FIELD_NAME:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							job->name,
+							value->value.v_utf8.str,
+							JOB_NAME_SIZE - 1
+						);
+					}
+					break;
+
+				case MODEL_FIELD_DESCRIPTION:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							job->description,
+							value->value.v_utf8.str,
+							JOB_DESCRIPTION_SIZE - 1
+						);
+					}
+					break;
 
-			else if (!strcmp (key, "user"))
-				bson_oid_copy (&value->value.v_oid, &job->user_oid);
+				case MODEL_FIELD_STATUS:
+					job->status = (JobStatus) value->value.v_int32;
+					break;
 
-			else if (!strcmp (key, "name") && value->value.v_utf8.str) {
-				(void) strncpy (
-					job->name,
-					value->value.v_utf8.str,
-					JOB_NAME_SIZE - 1
-				);
-			}
+				case MODEL_FIELD_TYPE:
+					job->type = (JobType) value->value.v_int32;
+					break;
 
-			else if (!strcmp (key, "description") && value->value.v_utf8.str) {
-				(void) strncpy (
-					job->description,
-					value->value.v_utf8.str,
-					JOB_DESCRIPTION_SIZE - 1
-				);
-			}
+				case MODEL_FIELD_AUTO_START:
+					job->autostart = value->value.v_bool;
+					break;
 
-			else if (!strcmp (key, "status"))
-				job->status = (JobStatus) value->value.v_int32;
+				case MODEL_FIELD_IMAGES_COUNT:
+					job->n_images = value->value.v_int32;
+					break;
 
-			else if (!strcmp (key, "type"))
-				job->type = (JobType) value->value.v_int32;
+				case MODEL_FIELD_PIXELS:
+					job->pixels = bson_iter_as_int64 (&iter);
+					break;
 
-			else if (!strcmp (key, "imagesCount"))
-				job->n_images = value->value.v_int32;
+				case MODEL_FIELD_IMAGES:
+					jeeves_job_doc_parse_images (job, &iter);
+					break;
 
-			else if (!strcmp (key, "images")) {
-				jeeves_job_doc_parse_images (job, &iter);
-			}
+				case MODEL_FIELD_CREATED:
+					job->created = (time_t) bson_iter_date_time (&iter) / 1000;
+					break;
+
+				case MODEL_FIELD_STARTED:
+					job->started = (time_t) bson_iter_date_time (&iter) / 1000;
+					break;
 
-			else if (!strcmp (key, "created"))
-				job->created = (time_t) bson_iter_date_time (&iter) / 1000;
+				case MODEL_FIELD_STOPPED:
+					job->stopped = (time_t) bson_iter_date_time (&iter) / 1000;
+					break;
 
-			else if (!strcmp (key, "started"))
-				job->started = (time_t) bson_iter_date_time (&iter) / 1000;
+				case MODEL_FIELD_ENDED:
+					job->ended = (time_t) bson_iter_date_time (&iter) / 1000;
+					break;
 
-			else if (!strcmp (key, "ended"))
-				job->ended = (time_t) bson_iter_date_time (&iter) / 1000;
+				default: break;
+			}
 		}
 	}
 
 }
 
-static bson_t *jeeves_job_query_oid (const bson_oid_t *oid) {
-
-	bson_t *query = bson_new ();
-	if (query) {
-		(void) bson_append_oid (query, "_id", -1, oid);
-	}
+static void jeeves_job_query_oid (
+	bson_t *query, const bson_oid_t *oid
+) {
 
-	return query;
+	bson_init (query);
+	(void) bson_append_oid (query, "_id", -1, oid);
 
 }
 
-static bson_t *jeeves_job_query_oid_and_user (
+static void jeeves_job_query_oid_and_user (
+	bson_t *job_query,
 	const bson_oid_t *oid, const bson_oid_t *user_oid
 ) {
 
-	bson_t *job_query = bson_new ();
-	if (job_query) {
-		(void) bson_append_oid (job_query, "_id", -1, oid);
-		(void) bson_append_oid (job_query, "user", -1, user_oid);
-	}
-
-	return job_query;
+	bson_init (job_query);
+	(void) bson_append_oid (job_query, "_id", -1, oid);
+	(void) bson_append_oid (job_query, "user", -1, user_oid);
 
 }
 
@@ -340,182 +660,560 @@ u8 jeeves_job_get_by_oid_and_user (
 	u8 retval = 1;
 
 	if (job) {
+		bson_t job_query;
+		jeeves_job_query_oid_and_user (&job_query, oid, user_oid);
+
+		JeevesDbTimer timer;
+		jeeves_db_timer_start (&timer, JOBS_COLL_NAME, "find", &job_query);
+
 		retval = mongo_find_one_with_opts (
 			jobs_model,
-			jeeves_job_query_oid_and_user (oid, user_oid), query_opts,
+			&job_query, query_opts,
 			job
 		);
+
+		jeeves_db_timer_end (&timer);
 	}
 
 	return retval;
 
 }
 
-u8 jeeves_job_get_by_oid_and_user_to_json (
-	const bson_oid_t *oid, const bson_oid_t *user_oid,
-	const bson_t *query_opts,
-	char **json, size_t *json_len
+static bool jeeves_job_get_images_each (
+	void *job_ptr, const bson_t *job_image_doc
 ) {
 
-	u8 retval = 1;
-
-	bson_t *job_query = jeeves_job_query_oid_and_user (
-		oid, user_oid
-	);
+	bool retval = false;
 
-	if (job_query) {
-		retval = mongo_find_one_with_opts_to_json (
-			jobs_model,
-			job_query, query_opts,
-			json, json_len
-		);
+	JobImage *job_image = jeeves_job_images_next ((JeevesJob *) job_ptr);
+	if (job_image) {
+		jeeves_job_image_doc_parse (job_image, job_image_doc);
+		retval = true;
 	}
 
 	return retval;
 
 }
 
-unsigned int jobs_get_all_by_user_to_json (
-	const bson_oid_t *user_oid, const bson_t *opts,
-	char **json, size_t *json_len
-) {
-
-	unsigned int retval = 1;
+// reads the job's images from the images collection
+// in the same order that they were uploaded
+static u8 jeeves_job_get_images_collection (JeevesJob *job) {
 
-	if (user_oid) {
-		bson_t *query = bson_new ();
-		if (query) {
-			(void) bson_append_oid (query, "user", -1, user_oid);
+	u8 retval = 1;
 
-			retval = mongo_find_all_to_json (
-				jobs_model,
-				query, opts,
-				"jobs",
-				json, json_len
-			);
-		}
+	// the job was fetched with its images count
+	if (job->n_images > 0) {
+		(void) jeeves_job_images_reserve (
+			job, job->images_count + (size_t) job->n_images
+		);
 	}
 
+	bson_t query;
+	bson_init (&query);
+	(void) bson_append_oid (&query, "job", -1, &job->oid);
+
+	retval = (u8) jeeves_db_find_each (
+		JOB_IMAGES_COLL_NAME,
+		&query, &job_images_opts,
+		jeeves_job_get_images_each, job
+	);
+
+	bson_destroy (&query);
+
 	return retval;
 
 }
 
-static bson_t *jeeves_job_to_bson (const JeevesJob *job) {
-
-	bson_t *doc = bson_new ();
-	if (doc) {
-		(void) bson_append_oid (doc, "_id", -1, &job->oid);
+// gets only the job's images using the job's oid
+u8 jeeves_job_get_images (
+	JeevesJob *job, const bson_t *query_opts
+) {
 
-		(void) bson_append_oid (doc, "user", -1, &job->user_oid);
+	u8 retval = 1;
 
-		(void) bson_append_utf8 (doc, "name", -1, job->name, -1);
-		(void) bson_append_utf8 (doc, "description", -1, job->description, -1);
+	if (job && job_images_model) {
+		retval = jeeves_job_get_images_collection (job);
+	}
 
-		(void) bson_append_int32 (doc, "status", -1, job->status);
+	else if (job) {
+		bson_t job_query;
+		jeeves_job_query_oid (&job_query, &job->oid);
 
-		(void) bson_append_int32 (doc, "type", -1, job->type);
+		JeevesDbTimer timer;
+		jeeves_db_timer_start (&timer, JOBS_COLL_NAME, "find", &job_query);
 
-		(void) bson_append_int32 (doc, "imagesCount", -1, job->n_images);
+		retval = mongo_find_one_with_opts (
+			jobs_model,
+			&job_query, query_opts,
+			job
+		);
 
-		(void) bson_append_date_time (doc, "created", -1, job->created * 1000);
-		(void) bson_append_date_time (doc, "started", -1, job->started * 1000);
-		(void) bson_append_date_time (doc, "ended", -1, job->ended * 1000);
+		jeeves_db_timer_end (&timer);
 	}
 
-	return doc;
+	return retval;
 
 }
 
-unsigned int jeeves_job_insert_one (
-	const JeevesJob *job
+typedef struct JobImagesPageIter {
+
+	bool (*each)(void *data, const JobImage *job_image);
+	void *data;
+
+} JobImagesPageIter;
+
+static bool jeeves_job_images_page_each (
+	void *iter_ptr, const bson_t *job_image_doc
 ) {
 
-	return mongo_insert_one (
-		jobs_model, jeeves_job_to_bson (job)
-	);
+	JobImagesPageIter *page_iter = (JobImagesPageIter *) iter_ptr;
+
+	JobImage job_image = { 0 };
+	jeeves_job_image_doc_parse (&job_image, job_image_doc);
+
+	return page_iter->each (page_iter->data, &job_image);
 
 }
 
-static bson_t *jeeves_job_update_bson (const JeevesJob *job) {
+// walks the sliced images array inside the job's document
+static bool jeeves_job_images_page_embedded_each (
+	void *iter_ptr, const bson_t *job_doc
+) {
 
-	bson_t *doc = bson_new ();
-	if (doc) {
-		bson_t set_doc = BSON_INITIALIZER;
-		(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
+	JobImagesPageIter *page_iter = (JobImagesPageIter *) iter_ptr;
 
-		(void) bson_append_utf8 (&set_doc, "name", -1, job->name, -1);
-		(void) bson_append_utf8 (&set_doc, "description", -1, job->description, -1);
+	bool more = true;
 
-		(void) bson_append_document_end (doc, &set_doc);
+	bson_iter_t iter = { 0 };
+	bson_iter_t array_iter = { 0 };
+	bson_iter_t image_iter = { 0 };
+	if (
+		bson_iter_init_find (&iter, job_doc, "images")
+		&& BSON_ITER_HOLDS_ARRAY (&iter)
+		&& bson_iter_recurse (&iter, &array_iter)
+	) {
+		JobImage job_image = { 0 };
+		while (more && bson_iter_next (&array_iter)) {
+			if (
+				BSON_ITER_HOLDS_DOCUMENT (&array_iter)
+				&& bson_iter_recurse (&array_iter, &image_iter)
+			) {
+				jeeves_job_doc_parse_image (&job_image, &image_iter);
+				more = page_iter->each (page_iter->data, &job_image);
+			}
+		}
 	}
 
-	return doc;
+	return more;
 
 }
 
-unsigned int jeeves_job_update_one (
-	const JeevesJob *job
+static void jeeves_job_images_page_query (
+	bson_t *query,
+	const bson_oid_t *job_oid, const bson_oid_t *user_oid,
+	const JobImagesPage *page
 ) {
 
-	return mongo_update_one (
-		jobs_model,
-		jeeves_job_query_oid (&job->oid),
-		jeeves_job_update_bson (job)
-	);
+	bson_init (query);
+	(void) bson_append_oid (query, "job", -1, job_oid);
+	(void) bson_append_oid (query, "user", -1, user_oid);
 
-}
+	bson_t image_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (query, "image", -1, &image_doc);
+	(void) bson_append_int32 (&image_doc, "$gt", -1, page->after);
+	(void) bson_append_document_end (query, &image_doc);
 
-static bson_t *jeeves_job_update_status_bson (const JobStatus status) {
+}
 
-	bson_t *doc = bson_new ();
-	if (doc) {
-		bson_t set_doc = BSON_INITIALIZER;
-		(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
-		(void) bson_append_int32 (&set_doc, "status", -1, status);
-		(void) bson_append_document_end (doc, &set_doc);
-	}
+static void jeeves_job_images_page_opts (
+	bson_t *page_opts, const JobImagesPage *page
+) {
 
-	return doc;
+	bson_init (page_opts);
+	(void) bson_concat (page_opts, &job_images_opts);
+	(void) bson_append_int64 (page_opts, "limit", -1, (int64_t) page->limit + 1);
 
 }
 
-unsigned int jeeves_job_update_status (
-	const bson_oid_t *job_oid, const JobStatus status
+// embedded images ids are their position in the array
+static void jeeves_job_images_page_embedded_opts (
+	bson_t *page_opts, const JobImagesPage *page
 ) {
 
-	return mongo_update_one (
-		jobs_model,
-		jeeves_job_query_oid (job_oid),
-		jeeves_job_update_status_bson (status)
-	);
+	bson_init (page_opts);
+
+	bson_t projection_doc = BSON_INITIALIZER;
+	bson_t images_doc = BSON_INITIALIZER;
+	bson_t slice_array = BSON_INITIALIZER;
+	(void) bson_append_document_begin (page_opts, "projection", -1, &projection_doc);
+	(void) bson_append_bool (&projection_doc, "imagesCount", -1, true);
+	(void) bson_append_document_begin (&projection_doc, "images", -1, &images_doc);
+	(void) bson_append_array_begin (&images_doc, "$slice", -1, &slice_array);
+	(void) bson_append_int32 (&slice_array, "0", -1, page->after + 1);
+	(void) bson_append_int32 (&slice_array, "1", -1, page->limit + 1);
+	(void) bson_append_array_end (&images_doc, &slice_array);
+	(void) bson_append_document_end (&projection_doc, &images_doc);
+	(void) bson_append_document_end (page_opts, &projection_doc);
+
+	(void) bson_append_int64 (page_opts, "limit", -1, 1);
 
 }
 
-static bson_t *jeeves_job_update_config_bson (const JeevesJob *job) {
+// iterates the page's images ordered by their id
+// one extra image is requested to know if there is a next page
+// returns 0 on success, 1 on error
+unsigned int jeeves_job_get_images_page (
+	const bson_oid_t *job_oid, const bson_oid_t *user_oid,
+	const JobImagesPage *page,
+	bool (*each)(void *data, const JobImage *job_image), void *data
+) {
 
-	bson_t *doc = bson_new ();
-	if (doc) {
-		bson_t set_doc = BSON_INITIALIZER;
-		(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
+	unsigned int retval = 1;
 
-		(void) bson_append_int32 (&set_doc, "type", -1, job->type);
+	if (job_oid && user_oid && page) {
+		JobImagesPageIter page_iter = { each, data };
 
-		(void) bson_append_document_end (doc, &set_doc);
+		bson_t query;
+		bson_t page_opts;
+
+		if (job_images_model) {
+			jeeves_job_images_page_query (&query, job_oid, user_oid, page);
+			jeeves_job_images_page_opts (&page_opts, page);
+
+			retval = jeeves_db_find_each (
+				JOB_IMAGES_COLL_NAME,
+				&query, &page_opts,
+				jeeves_job_images_page_each, &page_iter
+			);
+		}
+
+		else {
+			jeeves_job_query_oid_and_user (&query, job_oid, user_oid);
+			jeeves_job_images_page_embedded_opts (&page_opts, page);
+
+			retval = jeeves_db_find_each (
+				JOBS_COLL_NAME,
+				&query, &page_opts,
+				jeeves_job_images_page_embedded_each, &page_iter
+			);
+		}
+
+		bson_destroy (&query);
+		bson_destroy (&page_opts);
 	}
 
-	return doc;
+	return retval;
 
 }
 
-unsigned int jeeves_job_update_config (const JeevesJob *job) {
+// iterates the job's document as it comes from the cursor
+// returns 0 on success, 1 on error
+unsigned int jeeves_job_get_by_oid_and_user_each (
+	const bson_oid_t *oid, const bson_oid_t *user_oid,
+	const bson_t *query_opts,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
+) {
+
+	bson_t job_query;
+	jeeves_job_query_oid_and_user (&job_query, oid, user_oid);
 
-	return mongo_update_one (
-		jobs_model,
-		jeeves_job_query_oid (&job->oid),
-		jeeves_job_update_config_bson (job)
+	bson_t job_opts;
+	if (query_opts) bson_copy_to (query_opts, &job_opts);
+	else bson_init (&job_opts);
+	(void) bson_append_int64 (&job_opts, "limit", -1, 1);
+
+	unsigned int retval = jeeves_db_find_each (
+		JOBS_COLL_NAME,
+		&job_query, &job_opts,
+		each, data
 	);
 
-}
+	bson_destroy (&job_query);
+	bson_destroy (&job_opts);
+
+	return retval;
+
+}
+
+// writes the job's document straight from the cursor
+static bool jeeves_job_to_json_each (void *data, const bson_t *job_doc) {
+
+	JeevesJson *json = (JeevesJson *) data;
+
+	(void) jeeves_json_write_bson (json, job_doc, job_json_enum);
+
+	return false;
+
+}
+
+// writes the job's json into the buffer
+u8 jeeves_job_get_by_oid_and_user_to_json (
+	const bson_oid_t *oid, const bson_oid_t *user_oid,
+	const bson_t *query_opts,
+	JeevesJson *json
+) {
+
+	u8 retval = 1;
+
+	uint64_t generation = 0;
+	if (
+		!jobs_info_cache
+		|| jeeves_cache_get (
+			jobs_info_cache, oid, user_oid,
+			json, &generation
+		)
+	) {
+		if (
+			!jeeves_job_get_by_oid_and_user_each (
+				oid, user_oid, query_opts,
+				jeeves_job_to_json_each, json
+			)
+			&& json->len && !json->error
+		) {
+			if (jobs_info_cache) {
+				jeeves_cache_put (
+					jobs_info_cache, oid, user_oid,
+					json->data, json->len, generation
+				);
+			}
+
+			retval = 0;
+		}
+	}
+
+	else {
+		retval = 0;
+	}
+
+	return retval;
+
+}
+
+static void jobs_page_query (
+	bson_t *query,
+	const bson_oid_t *user_oid, const JobsPage *page
+) {
+
+	bson_init (query);
+	(void) bson_append_oid (query, "user", -1, user_oid);
+
+	if (page->has_after) {
+		bson_t id_doc = BSON_INITIALIZER;
+		(void) bson_append_document_begin (query, "_id", -1, &id_doc);
+		(void) bson_append_oid (&id_doc, "$lt", -1, &page->after);
+		(void) bson_append_document_end (query, &id_doc);
+	}
+
+	if (page->status != JOB_STATUS_NONE) {
+		(void) bson_append_int32 (query, "status", -1, page->status);
+	}
+
+}
+
+// adds the page's order & limit to the select opts
+static void jobs_page_opts (
+	bson_t *page_opts,
+	const bson_t *opts, const JobsPage *page
+) {
+
+	bson_init (page_opts);
+	if (opts) (void) bson_concat (page_opts, opts);
+
+	bson_t sort_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (page_opts, "sort", -1, &sort_doc);
+	(void) bson_append_int32 (&sort_doc, "_id", -1, -1);
+	(void) bson_append_document_end (page_opts, &sort_doc);
+
+	(void) bson_append_int64 (page_opts, "limit", -1, (int64_t) page->limit + 1);
+
+}
+
+// iterates the page's jobs as they come from the cursor
+// one extra job is requested to know if there is a next page
+// returns 0 on success, 1 on error
+unsigned int jobs_get_page_by_user (
+	const bson_oid_t *user_oid, const bson_t *opts,
+	const JobsPage *page,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
+) {
+
+	unsigned int retval = 1;
+
+	if (user_oid && page) {
+		bson_t query;
+		jobs_page_query (&query, user_oid, page);
+
+		bson_t page_opts;
+		jobs_page_opts (&page_opts, opts, page);
+
+		retval = jeeves_db_find_each (
+			JOBS_COLL_NAME,
+			&query, &page_opts,
+			each, data
+		);
+
+		bson_destroy (&query);
+		bson_destroy (&page_opts);
+	}
+
+	return retval;
+
+}
+
+// gets the user's cached first page
+// returns 0 on hit, 1 on miss with the generation to be used with put
+unsigned int jobs_model_list_cache_get (
+	const bson_oid_t *user_oid,
+	JeevesJson *json,
+	uint64_t *generation
+) {
+
+	unsigned int retval = 1;
+
+	if (jobs_list_cache) {
+		retval = jeeves_cache_get (
+			jobs_list_cache, user_oid, NULL,
+			json, generation
+		);
+	}
+
+	return retval;
+
+}
+
+void jobs_model_list_cache_put (
+	const bson_oid_t *user_oid,
+	const char *json, const size_t json_len,
+	const uint64_t generation
+) {
+
+	if (jobs_list_cache) {
+		jeeves_cache_put (
+			jobs_list_cache, user_oid, NULL,
+			json, json_len, generation
+		);
+	}
+
+}
+
+static void jeeves_job_to_bson (
+	bson_t *doc, const JeevesJob *job
+) {
+
+	bson_init (doc);
+
+	(void) bson_append_oid (doc, "_id", -1, &job->oid);
+
+	(void) bson_append_oid (doc, "user", -1, &job->user_oid);
+
+	(void) bson_append_utf8 (doc, "name", -1, job->name, -1);
+	(void) bson_append_utf8 (doc, "description", -1, job->description, -1);
+
+	(void) bson_append_int32 (doc, "status", -1, job->status);
+
+	(void) bson_append_int32 (doc, "type", -1, job->type);
+
+	(void) bson_append_bool (doc, "autoStart", -1, job->autostart);
+
+	(void) bson_append_int32 (doc, "imagesCount", -1, job->n_images);
+
+	(void) bson_append_int64 (doc, "pixels", -1, job->pixels);
+
+	(void) bson_append_date_time (doc, "created", -1, job->created * 1000);
+	(void) bson_append_date_time (doc, "started", -1, job->started * 1000);
+	(void) bson_append_date_time (doc, "ended", -1, job->ended * 1000);
+
+}
+
+unsigned int jeeves_job_insert_one (
+	const JeevesJob *job
+) {
+
+	bson_t doc;
+	jeeves_job_to_bson (&doc, job);
+
+	unsigned int retval = mongo_insert_one (jobs_model, &doc);
+
+	jobs_model_cache_invalidate (NULL, &job->user_oid);
+
+	return retval;
+
+}
+
+static void jeeves_job_update_bson (
+	bson_t *doc, const JeevesJob *job
+) {
+
+	bson_init (doc);
+
+	bson_t set_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
+
+	(void) bson_append_utf8 (&set_doc, "name", -1, job->name, -1);
+	(void) bson_append_utf8 (&set_doc, "description", -1, job->description, -1);
+
+	(void) bson_append_document_end (doc, &set_doc);
+
+}
+
+unsigned int jeeves_job_update_one (
+	const JeevesJob *job
+) {
+
+	bson_t query;
+	jeeves_job_query_oid (&query, &job->oid);
+
+	bson_t update;
+	jeeves_job_update_bson (&update, job);
+
+	JeevesDbTimer timer;
+	jeeves_db_timer_start (&timer, JOBS_COLL_NAME, "update", &query);
+
+	unsigned int retval = mongo_update_one (jobs_model, &query, &update);
+
+	jeeves_db_timer_end (&timer);
+
+	jobs_model_cache_invalidate (&job->oid, &job->user_oid);
+
+	return retval;
+
+}
+
+static void jeeves_job_update_status_bson (
+	bson_t *doc, const JobStatus status
+) {
+
+	bson_init (doc);
+
+	bson_t set_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
+	(void) bson_append_int32 (&set_doc, "status", -1, status);
+	(void) bson_append_document_end (doc, &set_doc);
+
+}
+
+unsigned int jeeves_job_update_status (
+	const JeevesJob *job, const JobStatus status
+) {
+
+	bson_t query;
+	jeeves_job_query_oid (&query, &job->oid);
+
+	bson_t update;
+	jeeves_job_update_status_bson (&update, status);
+
+	JeevesDbTimer timer;
+	jeeves_db_timer_start (&timer, JOBS_COLL_NAME, "update", &query);
+
+	unsigned int retval = mongo_update_one (jobs_model, &query, &update);
+
+	jeeves_db_timer_end (&timer);
+
+	jobs_model_cache_invalidate (&job->oid, &job->user_oid);
+
+	return retval;
+
+}
 
 bson_t *jeeves_job_type_update_bson (JobType type) {
 
@@ -532,131 +1230,203 @@ bson_t *jeeves_job_type_update_bson (JobType type) {
 }
 
 static void jeeves_job_images_add_update_count_bson (
-	bson_t *doc, int images_size
+	bson_t *doc, DoubleList *images
 ) {
 
-	bson_t *inc_doc = bson_new ();
-	if (inc_doc) {
-		(void) bson_append_int32 (inc_doc, "imagesCount", -1, images_size);
-
-		(void) bson_append_document (doc, "$inc", -1, inc_doc);
-
-		bson_destroy (inc_doc);
+	int64_t pixels = 0;
+	const JobImage *job_image = NULL;
+	for (ListElement *le = dlist_start (images); le; le = le->next) {
+		job_image = (const JobImage *) le->data;
+		pixels += (int64_t) job_image->width * (int64_t) job_image->height;
 	}
 
+	bson_t inc_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (doc, "$inc", -1, &inc_doc);
+	(void) bson_append_int32 (&inc_doc, "imagesCount", -1, (int) images->size);
+	(void) bson_append_int64 (&inc_doc, "pixels", -1, pixels);
+	(void) bson_append_document_end (doc, &inc_doc);
+
 }
 
 static void jeeves_job_images_add_push_images_bson (
 	bson_t *doc, DoubleList *images
 ) {
 
-	bson_t *push_doc = bson_new ();
-	if (push_doc) {
-		bson_t *images_doc = bson_new ();
-		if (images_doc) {
-			bson_t *each_array = bson_new ();
-			if (each_array) {
-				(void) bson_append_array_begin (images_doc, "$each", -1, each_array);
-
-				char buf[16] = { 0 };
-				const char *key = NULL;
-				size_t keylen = 0;
-				unsigned int i = 0;
-				bson_t *job_image_bson = NULL;
-				for (ListElement *le = dlist_start (images); le; le = le->next) {
-					keylen = bson_uint32_to_string (i, &key, buf, sizeof (buf));
-
-					job_image_bson = job_image_to_bson ((JobImage *) le->data);
-					if (job_image_bson) {
-						(void) bson_append_document (each_array, key, (int) keylen, job_image_bson);
-						bson_destroy (job_image_bson);
-					}
+	// every level is written directly into the parent's buffer
+	bson_t push_doc = BSON_INITIALIZER;
+	bson_t images_doc = BSON_INITIALIZER;
+	bson_t each_array = BSON_INITIALIZER;
+	bson_t job_image_doc = BSON_INITIALIZER;
 
-					i++;
-				}
+	(void) bson_append_document_begin (doc, "$push", -1, &push_doc);
+	(void) bson_append_document_begin (&push_doc, "images", -1, &images_doc);
+	(void) bson_append_array_begin (&images_doc, "$each", -1, &each_array);
 
-				(void) bson_append_array_end (images_doc, each_array);
+	char buf[16] = { 0 };
+	const char *key = NULL;
+	size_t keylen = 0;
+	unsigned int i = 0;
+	for (ListElement *le = dlist_start (images); le; le = le->next) {
+		keylen = bson_uint32_to_string (i, &key, buf, sizeof (buf));
 
-				bson_destroy (each_array);
-			}
+		(void) bson_append_document_begin (&each_array, key, (int) keylen, &job_image_doc);
+		job_image_append_bson (&job_image_doc, (const JobImage *) le->data);
+		(void) bson_append_document_end (&each_array, &job_image_doc);
 
-			(void) bson_append_document (push_doc, "images", -1, images_doc);
+		i++;
+	}
 
-			bson_destroy (images_doc);
-		}
+	(void) bson_append_array_end (&images_doc, &each_array);
+	(void) bson_append_document_end (&push_doc, &images_doc);
+	(void) bson_append_document_end (doc, &push_doc);
 
-		(void) bson_append_document (doc, "$push", -1, push_doc);
+}
+
+static void jeeves_job_update_images_bson (
+	bson_t *doc, DoubleList *images
+) {
+
+	bson_init (doc);
+
+	jeeves_job_images_add_update_count_bson (
+		doc, images
+	);
 
-		bson_destroy (push_doc);
+	// the images collection only needs the job's counters
+	if (!job_images_model) {
+		jeeves_job_images_add_push_images_bson (
+			doc, images
+		);
 	}
 
 }
 
-static bson_t *jeeves_job_update_images_bson (
-	DoubleList *images
+// inserts a document for each image with a single command
+static unsigned int jeeves_job_insert_images (
+	const JeevesJob *job, DoubleList *images
 ) {
 
-	bson_t *doc = NULL;
+	unsigned int retval = 1;
 
-	if (images) {
-		doc = bson_new ();
-		if (doc) {
-			jeeves_job_images_add_update_count_bson (
-				doc, (int) images->size
-			);
+	bson_t *docs = (bson_t *) calloc (images->size, sizeof (bson_t));
+	const bson_t **docs_ptrs = (const bson_t **) calloc (
+		images->size, sizeof (bson_t *)
+	);
 
-			jeeves_job_images_add_push_images_bson (
-				doc, images
+	if (docs && docs_ptrs) {
+		size_t n_docs = 0;
+		for (ListElement *le = dlist_start (images); le; le = le->next) {
+			bson_init (&docs[n_docs]);
+			job_image_doc_append_bson (
+				&docs[n_docs], job, (const JobImage *) le->data
 			);
+
+			docs_ptrs[n_docs] = &docs[n_docs];
+			n_docs++;
 		}
+
+		retval = jeeves_db_insert_many (
+			JOB_IMAGES_COLL_NAME, docs_ptrs, n_docs
+		);
+
+		for (size_t i = 0; i < n_docs; i++) bson_destroy (&docs[i]);
 	}
 
-	return doc;
+	free (docs_ptrs);
+	free (docs);
+
+	return retval;
 
 }
 
+// with the images collection the images are inserted first
+// so the job's count never includes images that do not exist
 unsigned int jeeves_job_update_images (
-	const bson_oid_t *job_oid, DoubleList *images
+	const JeevesJob *job, DoubleList *images
 ) {
 
-	return mongo_update_one (
-		jobs_model,
-		jeeves_job_query_oid (job_oid),
-		jeeves_job_update_images_bson (images)
-	);
+	unsigned int retval = 1;
+
+	if (
+		images
+		&& (
+			!job_images_model || !images->size
+			|| !jeeves_job_insert_images (job, images)
+		)
+	) {
+		bson_t query;
+		jeeves_job_query_oid (&query, &job->oid);
+
+		bson_t update;
+		jeeves_job_update_images_bson (&update, images);
+
+		JeevesDbTimer timer;
+		jeeves_db_timer_start (&timer, JOBS_COLL_NAME, "update", &query);
+
+		retval = mongo_update_one (jobs_model, &query, &update);
+
+		jeeves_db_timer_end (&timer);
+
+		jobs_model_cache_invalidate (&job->oid, &job->user_oid);
+	}
+
+	return retval;
 
 }
 
-static bson_t *jeeves_job_image_query (
+static void jeeves_job_image_query (
+	bson_t *doc,
 	const bson_oid_t *oid, const int image_id
 ) {
 
-	bson_t *doc = bson_new ();
-	if (doc) {
-		(void) bson_append_oid (doc, "_id", -1, oid);
-		(void) bson_append_int32 (doc, "images._id", -1, image_id);
-	}
+	bson_init (doc);
+	(void) bson_append_oid (doc, "_id", -1, oid);
+	(void) bson_append_int32 (doc, "images._id", -1, image_id);
 
-	return doc;
+}
+
+static void jeeves_job_image_result_update (
+	bson_t *doc, const char *result
+) {
+
+	bson_init (doc);
+
+	bson_t set_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
+
+	(void) bson_append_utf8 (&set_doc, "images.$.result", -1, result, -1);
+
+	(void) bson_append_document_end (doc, &set_doc);
 
 }
 
-static bson_t *jeeves_job_image_result_update (
+// only the image's own document is updated
+static unsigned int jeeves_job_update_image_result_collection (
+	const bson_oid_t *job_oid, const int image_id,
 	const char *result
 ) {
 
-	bson_t *doc = bson_new ();
+	bson_t query;
+	bson_init (&query);
+	(void) bson_append_oid (&query, "job", -1, job_oid);
+	(void) bson_append_int32 (&query, "image", -1, image_id);
 
-	if (doc) {
-		bson_t set_doc = BSON_INITIALIZER;
-		(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
+	bson_t update;
+	bson_init (&update);
 
-		(void) bson_append_utf8 (&set_doc, "images.$.result", -1, result, -1);
+	bson_t set_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (&update, "$set", -1, &set_doc);
+	(void) bson_append_utf8 (&set_doc, "result", -1, result, -1);
+	(void) bson_append_document_end (&update, &set_doc);
 
-		(void) bson_append_document_end (doc, &set_doc);
-	}
+	JeevesDbTimer timer;
+	jeeves_db_timer_start (&timer, JOB_IMAGES_COLL_NAME, "update", &query);
 
-	return doc;
+	unsigned int retval = mongo_update_one (job_images_model, &query, &update);
+
+	jeeves_db_timer_end (&timer);
+
+	return retval;
 
 }
 
@@ -665,91 +1435,211 @@ unsigned int jeeves_job_update_image_result (
 	const char *result
 ) {
 
-	return mongo_update_one (
-		jobs_model,
-		jeeves_job_image_query (job_oid, image_id),
-		jeeves_job_image_result_update (result)
-	);
+	unsigned int retval = 1;
+
+	if (job_images_model) {
+		retval = jeeves_job_update_image_result_collection (
+			job_oid, image_id, result
+		);
+	}
+
+	else {
+		bson_t query;
+		jeeves_job_image_query (&query, job_oid, image_id);
+
+		bson_t update;
+		jeeves_job_image_result_update (&update, result);
+
+		JeevesDbTimer timer;
+		jeeves_db_timer_start (&timer, JOBS_COLL_NAME, "update", &query);
+
+		retval = mongo_update_one (jobs_model, &query, &update);
+
+		jeeves_db_timer_end (&timer);
+	}
+
+	// images are not part of the user's list
+	jobs_model_cache_invalidate (job_oid, NULL);
+
+	return retval;
 
 }
 
-static bson_t *jeeves_job_update_start_bson (void) {
+// sets the job's status & the time of the transition
+static void jeeves_job_update_status_time_bson (
+	bson_t *doc, const JobStatus status, const char *time_field
+) {
+
+	bson_init (doc);
 
-	bson_t *doc = bson_new ();
-	if (doc) {
-		bson_t set_doc = BSON_INITIALIZER;
-		(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
-		(void) bson_append_int32 (&set_doc, "status", -1, JOB_STATUS_RUNNING);
-		(void) bson_append_date_time (&set_doc, "started", -1, time (NULL));
-		(void) bson_append_document_end (doc, &set_doc);
+	bson_t set_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
+	(void) bson_append_int32 (&set_doc, "status", -1, status);
+	(void) bson_append_date_time (&set_doc, time_field, -1, (int64_t) time (NULL) * 1000);
+	(void) bson_append_document_end (doc, &set_doc);
+
+}
+
+// the transition is only applied if the job is in the expected status
+// or in any status except the excluded one
+static void jeeves_job_transition_query (
+	bson_t *query,
+	const bson_oid_t *oid, const bson_oid_t *user_oid,
+	const JobStatus status, const JobStatus not_status
+) {
+
+	bson_init (query);
+	(void) bson_append_oid (query, "_id", -1, oid);
+	if (user_oid) (void) bson_append_oid (query, "user", -1, user_oid);
+
+	if (status != JOB_STATUS_NONE) {
+		(void) bson_append_int32 (query, "status", -1, status);
 	}
 
-	return doc;
+	else {
+		bson_t status_doc = BSON_INITIALIZER;
+		(void) bson_append_document_begin (query, "status", -1, &status_doc);
+		(void) bson_append_int32 (&status_doc, "$ne", -1, not_status);
+		(void) bson_append_document_end (query, &status_doc);
+	}
 
 }
 
-unsigned int jeeves_job_update_start (
-	const bson_oid_t *job_oid
+// applies the update in a single round trip
+// and parses the job's updated values using the query opts
+// returns 0 if the job was updated, 1 if it was not in the expected status
+static unsigned int jeeves_job_transition (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	bson_t *query, bson_t *update,
+	const bson_t *query_opts
 ) {
 
-	return mongo_update_one (
-		jobs_model,
-		jeeves_job_query_oid (job_oid),
-		jeeves_job_update_start_bson ()
+	unsigned int retval = jeeves_db_find_and_modify (
+		JOBS_COLL_NAME,
+		query, update, query_opts,
+		jeeves_job_doc_parse, job
 	);
 
+	// the user is returned with the job's updated values
+	if (!retval) {
+		jobs_model_cache_invalidate (
+			&job->oid, user_oid ? user_oid : &job->user_oid
+		);
+	}
+
+	bson_destroy (query);
+	bson_destroy (update);
+
+	return retval;
+
 }
 
-static bson_t *jeeves_job_update_stop_bson (void) {
+// READY -> RUNNING
+unsigned int jeeves_job_transition_start (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bson_t *query_opts
+) {
 
-	bson_t *doc = bson_new ();
-	if (doc) {
-		bson_t set_doc = BSON_INITIALIZER;
-		(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
-		(void) bson_append_int32 (&set_doc, "status", -1, JOB_STATUS_STOPPED);
-		(void) bson_append_date_time (&set_doc, "stopped", -1, time (NULL));
-		(void) bson_append_document_end (doc, &set_doc);
-	}
+	bson_t query;
+	jeeves_job_transition_query (
+		&query, &job->oid, user_oid,
+		JOB_STATUS_READY, JOB_STATUS_NONE
+	);
 
-	return doc;
+	bson_t update;
+	jeeves_job_update_status_time_bson (
+		&update, JOB_STATUS_RUNNING, "started"
+	);
+
+	return jeeves_job_transition (job, user_oid, &query, &update, query_opts);
 
 }
 
-unsigned int jeeves_job_update_stop (
-	const bson_oid_t *job_oid
+// RUNNING -> STOPPED
+unsigned int jeeves_job_transition_stop (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bson_t *query_opts
 ) {
 
-	return mongo_update_one (
-		jobs_model,
-		jeeves_job_query_oid (job_oid),
-		jeeves_job_update_stop_bson ()
+	bson_t query;
+	jeeves_job_transition_query (
+		&query, &job->oid, user_oid,
+		JOB_STATUS_RUNNING, JOB_STATUS_NONE
+	);
+
+	bson_t update;
+	jeeves_job_update_status_time_bson (
+		&update, JOB_STATUS_STOPPED, "stopped"
 	);
 
+	return jeeves_job_transition (job, user_oid, &query, &update, query_opts);
+
 }
 
-static bson_t *jeeves_job_end_update_bson (void) {
+// RUNNING -> DONE
+// fails if the job was stopped while it was running
+unsigned int jeeves_job_transition_end (
+	JeevesJob *job, const bson_t *query_opts
+) {
 
-	bson_t *doc = bson_new ();
-	if (doc) {
-		bson_t set_doc = BSON_INITIALIZER;
-		(void) bson_append_document_begin (doc, "$set", -1, &set_doc);
-		(void) bson_append_int32 (&set_doc, "status", -1, JOB_STATUS_DONE);
-		(void) bson_append_date_time (&set_doc, "ended", -1, time (NULL));
-		(void) bson_append_document_end (doc, &set_doc);
-	}
+	bson_t query;
+	jeeves_job_transition_query (
+		&query, &job->oid, NULL,
+		JOB_STATUS_RUNNING, JOB_STATUS_NONE
+	);
 
-	return doc;
+	bson_t update;
+	jeeves_job_update_status_time_bson (
+		&update, JOB_STATUS_DONE, "ended"
+	);
+
+	return jeeves_job_transition (job, NULL, &query, &update, query_opts);
 
 }
 
-unsigned int jeeves_job_update_end (
-	const bson_oid_t *job_oid
+// any status except RUNNING -> READY
+unsigned int jeeves_job_transition_ready (
+	JeevesJob *job, const bson_t *query_opts
 ) {
 
-	return mongo_update_one (
-		jobs_model,
-		jeeves_job_query_oid (job_oid),
-		jeeves_job_end_update_bson ()
+	bson_t query;
+	jeeves_job_transition_query (
+		&query, &job->oid, NULL,
+		JOB_STATUS_NONE, JOB_STATUS_RUNNING
 	);
 
+	bson_t update;
+	jeeves_job_update_status_bson (&update, JOB_STATUS_READY);
+
+	return jeeves_job_transition (job, NULL, &query, &update, query_opts);
+
+}
+
+// sets the job's type & autostart if it is not running
+// only the values present in the job are updated
+unsigned int jeeves_job_transition_config (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bool set_autostart,
+	const bson_t *query_opts
+) {
+
+	bson_t query;
+	jeeves_job_transition_query (
+		&query, &job->oid, user_oid,
+		JOB_STATUS_NONE, JOB_STATUS_RUNNING
+	);
+
+	bson_t update;
+	bson_init (&update);
+
+	bson_t set_doc = BSON_INITIALIZER;
+	(void) bson_append_document_begin (&update, "$set", -1, &set_doc);
+	(void) bson_append_int32 (&set_doc, "type", -1, job->type);
+	if (set_autostart) {
+		(void) bson_append_bool (&set_doc, "autoStart", -1, job->autostart);
+	}
+	(void) bson_append_document_end (&update, &set_doc);
+
+	return jeeves_job_transition (job, user_oid, &query, &update, query_opts);
+
 }
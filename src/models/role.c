@@ -9,12 +9,20 @@
 #include <cmongo/model.h>
 #include <cmongo/select.h>
 
+#include "db.h"
+
+#include "models/fields.h"
 #include "models/role.h"
 
 #define ROLES_COLL_NAME  				"roles"
 
 static CMongoModel *roles_model = NULL;
 
+// the indexes that the roles queries rely on
+static const JeevesDbIndex roles_indexes[] = {
+	{ "name_1", { "name" }, false }
+};
+
 void role_doc_parse (
 	void *role_ptr, const bson_t *role_doc
 );
@@ -27,6 +35,11 @@ unsigned int roles_model_init (void) {
 	if (roles_model) {
 		cmongo_model_set_parser (roles_model, role_doc_parse);
 
+		(void) jeeves_db_create_indexes (
+			ROLES_COLL_NAME,
+			roles_indexes, sizeof (roles_indexes) / sizeof (JeevesDbIndex)
+		);
+
 		retval = 0;
 	}
 
@@ -136,17 +149,20 @@ static void role_doc_parse_actions (
 	if (actions_array) {
 		bson_iter_t array_iter = { 0 };
 		if (bson_iter_init (&array_iter, actions_array)) {
-			while (bson_iter_next (&array_iter)) {
+			while (
+				(role->n_actions < ROLE_ACTIONS_SIZE)
+				&& bson_iter_next (&array_iter)
+			) {
 				// const char *key = bson_iter_key (&array_iter);
-				const bson_value_t *value = bson_iter_value (&array_iter);
-
-				(void) strncpy (
-					role->actions[role->n_actions],
-					value->value.v_utf8.str,
-					ROLE_ACTION_SIZE - 1
-				);
+				if (BSON_ITER_HOLDS_UTF8 (&array_iter)) {
+					(void) strncpy (
+						role->actions[role->n_actions],
+						bson_iter_utf8 (&array_iter, NULL),
+						ROLE_ACTION_SIZE - 1
+					);
 
-				role->n_actions += 1;
+					role->n_actions += 1;
+				}
 			}
 		}
 
@@ -167,17 +183,24 @@ void role_doc_parse (
 			const char *key = bson_iter_key (&iter);
 			const bson_value_t *value = bson_iter_value (&iter);
 
-			if (!strcmp (key, "_id")) {
-				bson_oid_copy (&value->value.v_oid, &role->oid);
-			}
+			switch (model_field_get (key)) {
+				case MODEL_FIELD_ID:
+					bson_oid_copy (&value->value.v_oid, &role->oid);
+					break;
+
+				case MODEL_FIELD_NAME:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							role->name, value->value.v_utf8.str, ROLE_NAME_SIZE - 1
+						);
+					}
+					break;
 
-			else if (!strcmp (key, "name") && value->value.v_utf8.str)
-				(void) strncpy (
-					role->name, value->value.v_utf8.str, ROLE_NAME_SIZE - 1
-				);
+				case MODEL_FIELD_ACTIONS:
+					role_doc_parse_actions (role, &iter);
+					break;
 
-			else if (!strcmp (key, "actions")) {
-				role_doc_parse_actions (role, &iter);
+				default: break;
 			}
 		}
 	}
@@ -304,3 +327,40 @@ mongoc_cursor_t *role_find_all (
 	);
 
 }
+
+// parses every role with its name only
+// the callback returns false to stop the iteration
+// returns 0 on success, 1 on error
+unsigned int role_get_all (
+	bool (*each)(void *data, const Role *role), void *data
+) {
+
+	unsigned int retval = 1;
+
+	CMongoSelect *select = cmongo_select_new ();
+	(void) cmongo_select_insert_field (select, "name");
+	(void) cmongo_select_insert_field (select, "actions");
+
+	uint64_t n_docs = 0;
+	mongoc_cursor_t *roles_cursor = role_find_all (select, &n_docs);
+	if (roles_cursor) {
+		Role role = { 0 };
+		const bson_t *role_doc = NULL;
+		bool more = true;
+		while (more && mongoc_cursor_next (roles_cursor, &role_doc)) {
+			(void) memset (&role, 0, sizeof (Role));
+			role_doc_parse (&role, role_doc);
+
+			more = each (data, &role);
+		}
+
+		mongoc_cursor_destroy (roles_cursor);
+
+		retval = 0;
+	}
+
+	cmongo_select_delete (select);
+
+	return retval;
+
+}
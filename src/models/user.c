@@ -10,12 +10,21 @@
 #include <cmongo/crud.h>
 #include <cmongo/model.h>
 
+#include "db.h"
+
+#include "models/fields.h"
 #include "models/user.h"
 
 #define USERS_COLL_NAME         				"users"
 
 static CMongoModel *users_model = NULL;
 
+// the indexes that the users queries rely on
+static const JeevesDbIndex users_indexes[] = {
+	{ "email_1", { "email" }, true },
+	{ "username_1", { "username" }, false }
+};
+
 static void user_doc_parse (
 	void *user_ptr, const bson_t *user_doc
 );
@@ -28,6 +37,11 @@ unsigned int users_model_init (void) {
 	if (users_model) {
 		cmongo_model_set_parser (users_model, user_doc_parse);
 
+		(void) jeeves_db_create_indexes (
+			USERS_COLL_NAME,
+			users_indexes, sizeof (users_indexes) / sizeof (JeevesDbIndex)
+		);
+
 		retval = 0;
 	}
 
@@ -58,7 +72,7 @@ void user_delete (void *user_ptr) {
 
 }
 
-void user_print (User *user) {
+void user_print (const User *user) {
 
 	if (user) {
 		(void) printf ("email: %s\n", user->email);
@@ -86,45 +100,57 @@ static void user_doc_parse (
 			key = (char *) bson_iter_key (&iter);
 			value = (bson_value_t *) bson_iter_value (&iter);
 
-			if (!strcmp (key, "_id")) {
-				bson_oid_copy (&value->value.v_oid, &user->oid);
-				bson_oid_to_string (&user->oid, user->id);
-			}
-
-			else if (!strcmp (key, "role")) {
-				bson_oid_copy (&value->value.v_oid, &user->role_oid);
-			}
-
-			else if (!strcmp (key, "name") && value->value.v_utf8.str) {
-				(void) strncpy (
-					user->name,
-					value->value.v_utf8.str,
-					USER_NAME_SIZE - 1
-				);
-			}
-
-			else if (!strcmp (key, "email") && value->value.v_utf8.str) {
-				(void) strncpy (
-					user->email,
-					value->value.v_utf8.str,
-					USER_EMAIL_SIZE - 1
-				);
-			}
-
-			else if (!strcmp (key, "username") && value->value.v_utf8.str) {
-				(void) strncpy (
-					user->username,
-					value->value.v_utf8.str,
-					USER_USERNAME_SIZE - 1
-				);
-			}
-
-			else if (!strcmp (key, "password") && value->value.v_utf8.str) {
-				(void) strncpy (
-					user->password,
-					value->value.v_utf8.str,
-					USER_PASSWORD_SIZE - 1
-				);
+			switch (model_field_get (key)) {
+				case MODEL_FIELD_ID:
+					bson_oid_copy (&value->value.v_oid, &user->oid);
+					bson_oid_to_string (&user->oid, user->id);
+					break;
+
+				case MODEL_FIELD_ROLE:
+					bson_oid_copy (&value->value.v_oid, &user->role_oid);
+					break;
+
+				case MODEL_FIELD_NAME:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							user->name,
+							value->value.v_utf8.str,
+							USER_NAME_SIZE - 1
+						);
+					}
+					break;
+
+				case MODEL_FIELD_EMAIL:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							user->email,
+							value->value.v_utf8.str,
+							USER_EMAIL_SIZE - 1
+						);
+					}
+					break;
+
+				case MODEL_FIELD_USERNAME:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							user->username,
+							value->value.v_utf8.str,
+							USER_USERNAME_SIZE - 1
+						);
+					}
+					break;
+
+				case MODEL_FIELD_PASSWORD:
+					if (value->value.v_utf8.str) {
+						(void) strncpy (
+							user->password,
+							value->value.v_utf8.str,
+							USER_PASSWORD_SIZE - 1
+						);
+					}
+					break;
+
+				default: break;
 			}
 		}
 	}
@@ -165,7 +191,22 @@ bson_t *user_query_email (const char *email) {
 
 u8 user_check_by_email (const char *email) {
 
-	return mongo_check (users_model, user_query_email (email));
+	u8 retval = 1;
+
+	if (email) {
+		bson_t query;
+		bson_init (&query);
+		(void) bson_append_utf8 (&query, "email", -1, email, -1);
+
+		JeevesDbTimer timer;
+		jeeves_db_timer_start (&timer, USERS_COLL_NAME, "find", &query);
+
+		retval = mongo_check (users_model, &query);
+
+		jeeves_db_timer_end (&timer);
+	}
+
+	return retval;
 
 }
 
@@ -179,15 +220,21 @@ u8 user_get_by_id (
 		bson_oid_t oid = { 0 };
 		bson_oid_init_from_string (&oid, id);
 
-		bson_t *user_query = bson_new ();
-		if (user_query) {
-			(void) bson_append_oid (user_query, "_id", -1, &oid);
-			retval = mongo_find_one_with_opts (
-				users_model,
-				user_query, query_opts,
-				user
-			);
-		}
+		// stack query, cmongo's bson_destroy () does not free it
+		bson_t user_query;
+		bson_init (&user_query);
+		(void) bson_append_oid (&user_query, "_id", -1, &oid);
+
+		JeevesDbTimer timer;
+		jeeves_db_timer_start (&timer, USERS_COLL_NAME, "find", &user_query);
+
+		retval = mongo_find_one_with_opts (
+			users_model,
+			&user_query, query_opts,
+			user
+		);
+
+		jeeves_db_timer_end (&timer);
 	}
 
 	return retval;
@@ -202,15 +249,20 @@ u8 user_get_by_email (
 	u8 retval = 1;
 
 	if (user && email) {
-		bson_t *user_query = bson_new ();
-		if (user_query) {
-			(void) bson_append_utf8 (user_query, "email", -1, email, -1);
-			retval = mongo_find_one_with_opts (
-				users_model,
-				user_query, query_opts,
-				user
-			);
-		}
+		bson_t user_query;
+		bson_init (&user_query);
+		(void) bson_append_utf8 (&user_query, "email", -1, email, -1);
+
+		JeevesDbTimer timer;
+		jeeves_db_timer_start (&timer, USERS_COLL_NAME, "find", &user_query);
+
+		retval = mongo_find_one_with_opts (
+			users_model,
+			&user_query, query_opts,
+			user
+		);
+
+		jeeves_db_timer_end (&timer);
 	}
 
 	return retval;
@@ -225,15 +277,20 @@ u8 user_get_by_username (
 	u8 retval = 1;
 
 	if (user && username) {
-		bson_t *user_query = bson_new ();
-		if (user_query) {
-			(void) bson_append_utf8 (user_query, "username", -1, username->str, username->len);
-			retval = mongo_find_one_with_opts (
-				users_model,
-				user_query, query_opts,
-				user
-			);
-		}
+		bson_t user_query;
+		bson_init (&user_query);
+		(void) bson_append_utf8 (&user_query, "username", -1, username->str, username->len);
+
+		JeevesDbTimer timer;
+		jeeves_db_timer_start (&timer, USERS_COLL_NAME, "find", &user_query);
+
+		retval = mongo_find_one_with_opts (
+			users_model,
+			&user_query, query_opts,
+			user
+		);
+
+		jeeves_db_timer_end (&timer);
 	}
 
 	return retval;
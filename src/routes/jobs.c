@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
 
 #include <cerver/types/types.h>
 #include <cerver/types/string.h>
@@ -13,47 +14,599 @@
 #include <cerver/utils/log.h>
 #include <cerver/utils/utils.h>
 
+#include "arena.h"
+#include "dblimit.h"
 #include "errors.h"
+#include "formats.h"
 #include "jeeves.h"
+#include "stream.h"
 
 #include "models/job.h"
 #include "models/user.h"
 
 #include "controllers/jobs.h"
 
+// streams a json page of values as they come from the db
+// bson & msgpack pages are sent at once with their length
+typedef struct JobsPageWriter {
+
+	const HttpReceive *http_receive;
+	JeevesFormat format;
+
+	JeevesStreamChunked chunked;
+
+	bson_t page;
+	bson_t items;
+	bool items_ended;
+
+	JeevesJson body;
+	size_t items_offset;
+
+	// the page's values key
+	const char *key;
+	bool started;
+
+	int limit;
+	int count;
+	bool has_next;
+
+	// the last item's cursor
+	bson_value_t last;
+
+	// keeps a copy of the page to be cached
+	bool capture;
+	char *json;
+	size_t json_len;
+	size_t json_size;
+
+} JobsPageWriter;
+
+static void jobs_page_writer_capture (
+	JobsPageWriter *writer, const char *data, const size_t data_len
+) {
+
+	if ((writer->json_len + data_len + 1) > writer->json_size) {
+		size_t size = writer->json_size ? writer->json_size : 4096;
+		while (size < (writer->json_len + data_len + 1)) size *= 2;
+
+		char *json = (char *) realloc (writer->json, size);
+		if (json) {
+			writer->json = json;
+			writer->json_size = size;
+		}
+
+		else {
+			free (writer->json);
+			writer->json = NULL;
+			writer->capture = false;
+		}
+	}
+
+	if (writer->capture) {
+		(void) memcpy (writer->json + writer->json_len, data, data_len);
+		writer->json_len += data_len;
+		writer->json[writer->json_len] = '\0';
+	}
+
+}
+
+static unsigned int jobs_page_writer_write (
+	JobsPageWriter *writer, const char *data, const size_t data_len
+) {
+
+	if (writer->capture) jobs_page_writer_capture (writer, data, data_len);
+
+	return jeeves_stream_chunked_write (&writer->chunked, data, data_len);
+
+}
+
+static void jobs_page_writer_init (
+	JobsPageWriter *writer,
+	const HttpReceive *http_receive, const JeevesFormat format,
+	const char *key, const int limit
+) {
+
+	writer->http_receive = http_receive;
+	writer->format = format;
+
+	writer->key = key;
+	writer->limit = limit;
+
+	writer->last.value_type = BSON_TYPE_NULL;
+
+	switch (format) {
+		case JEEVES_FORMAT_JSON:
+			jeeves_stream_chunked_init (
+				&writer->chunked, http_receive,
+				"200 OK", "application/json"
+			);
+			break;
+
+		case JEEVES_FORMAT_BSON:
+			bson_init (&writer->page);
+			break;
+
+		case JEEVES_FORMAT_MSGPACK:
+			break;
+	}
+
+}
+
+static void jobs_page_writer_destroy (JobsPageWriter *writer) {
+
+	if (writer->format == JEEVES_FORMAT_BSON) {
+		if (writer->started && !writer->items_ended) {
+			(void) bson_append_array_end (&writer->page, &writer->items);
+		}
+
+		bson_destroy (&writer->page);
+	}
+
+	jeeves_json_destroy (&writer->body);
+
+}
+
+// starts the json page after the values of the head object
+static void jobs_page_writer_start_json (
+	JobsPageWriter *writer, const char *head, const size_t head_len
+) {
+
+	char start[64] = { 0 };
+	int start_len = 0;
+
+	// the head's closing brace is replaced by the items
+	if (head && (head_len > 2)) {
+		(void) jobs_page_writer_write (writer, head, head_len - 1);
+		start_len = snprintf (start, 64, ", \"%s\": [", writer->key);
+	}
+
+	else {
+		start_len = snprintf (start, 64, "{\"%s\": [", writer->key);
+	}
+
+	(void) jobs_page_writer_write (writer, start, (size_t) start_len);
+
+	writer->started = true;
+
+}
+
+// starts the page with the values of the head document
+// the items are written after them using the writer's key
+static void jobs_page_writer_start (
+	JobsPageWriter *writer, const bson_t *head
+) {
+
+	switch (writer->format) {
+		case JEEVES_FORMAT_JSON: {
+			JeevesJson *json = head ? jeeves_json_thread () : NULL;
+			if (json && !jeeves_json_write_bson (json, head, job_json_enum)) {
+				jobs_page_writer_start_json (writer, json->data, json->len);
+			}
+
+			else {
+				jobs_page_writer_start_json (writer, NULL, 0);
+			}
+		} break;
+
+		case JEEVES_FORMAT_BSON:
+			if (head) (void) bson_concat (&writer->page, head);
+
+			(void) bson_append_array_begin (
+				&writer->page, writer->key, -1, &writer->items
+			);
+			break;
+
+		case JEEVES_FORMAT_MSGPACK: {
+			bson_iter_t iter = { 0 };
+			const bool has_head = head && bson_iter_init (&iter, head);
+
+			jeeves_msgpack_write_map (
+				&writer->body, (has_head ? bson_count_keys (head) : 0) + 2
+			);
+
+			while (has_head && bson_iter_next (&iter)) {
+				const char *key = bson_iter_key (&iter);
+				jeeves_msgpack_write_str (&writer->body, key, strlen (key));
+				jeeves_msgpack_write_value (
+					&writer->body, bson_iter_value (&iter), key, job_json_enum
+				);
+			}
+
+			jeeves_msgpack_write_str (&writer->body, writer->key, strlen (writer->key));
+			writer->items_offset = jeeves_msgpack_write_array_begin (&writer->body);
+		} break;
+	}
+
+	writer->started = true;
+
+}
+
+// writes the item's json into the chunks
+// returns true if the item was written
+static bool jobs_page_writer_item_json (
+	JobsPageWriter *writer, const bson_t *doc
+) {
+
+	bool retval = false;
+
+	JeevesJson *json = jeeves_json_thread ();
+	if (json && !jeeves_json_write_bson (json, doc, job_json_enum)) {
+		if (writer->count) {
+			(void) jobs_page_writer_write (writer, ",", 1);
+		}
+
+		(void) jobs_page_writer_write (writer, json->data, json->len);
+
+		// stop reading from the cursor if the client is gone
+		retval = !writer->chunked.error;
+	}
+
+	return retval;
+
+}
+
+// adds the item into the page
+// returns false if the page is full or the client is gone
+static bool jobs_page_writer_item (
+	JobsPageWriter *writer, const bson_t *doc
+) {
+
+	// the extra item only means that there is a next page
+	if (writer->count == writer->limit) {
+		writer->has_next = true;
+		return false;
+	}
+
+	bool retval = false;
+
+	if (!writer->started) jobs_page_writer_start (writer, NULL);
+
+	switch (writer->format) {
+		case JEEVES_FORMAT_JSON:
+			retval = jobs_page_writer_item_json (writer, doc);
+			break;
+
+		case JEEVES_FORMAT_BSON: {
+			char buf[16] = { 0 };
+			const char *key = NULL;
+			(void) bson_uint32_to_string ((uint32_t) writer->count, &key, buf, sizeof (buf));
+
+			retval = bson_append_document (&writer->items, key, -1, doc);
+		} break;
+
+		case JEEVES_FORMAT_MSGPACK:
+			retval = !jeeves_format_write_bson (
+				&writer->body, JEEVES_FORMAT_MSGPACK, doc, job_json_enum
+			);
+			break;
+	}
+
+	// only written items are counted
+	if (retval) writer->count += 1;
+
+	return retval;
+
+}
+
+// writes each job as soon as it comes from the cursor
+static bool jobs_page_writer_each (void *data, const bson_t *job_doc) {
+
+	JobsPageWriter *writer = (JobsPageWriter *) data;
+
+	const int count = writer->count;
+	bool retval = jobs_page_writer_item (writer, job_doc);
+
+	// the cursor only moves with the written jobs
+	if (writer->count > count) {
+		bson_iter_t iter = { 0 };
+		if (bson_iter_init_find (&iter, job_doc, "_id") && BSON_ITER_HOLDS_OID (&iter)) {
+			writer->last.value_type = BSON_TYPE_OID;
+			bson_oid_copy (bson_iter_oid (&iter), &writer->last.value.v_oid);
+		}
+	}
+
+	return retval;
+
+}
+
+// starts the page with the job's values as they come from the db
+static bool jobs_page_writer_each_head (void *data, const bson_t *job_doc) {
+
+	jobs_page_writer_start ((JobsPageWriter *) data, job_doc);
+
+	return false;
+
+}
+
+// writes each image with the same values as the embedded images
+static bool jobs_page_writer_each_image (void *data, const JobImage *job_image) {
+
+	JobsPageWriter *writer = (JobsPageWriter *) data;
+
+	bson_t doc;
+	bson_init (&doc);
+	job_image_append_bson (&doc, job_image);
+
+	const int count = writer->count;
+	bool retval = jobs_page_writer_item (writer, &doc);
+
+	// the cursor only moves with the written images
+	if (writer->count > count) {
+		writer->last.value_type = BSON_TYPE_INT32;
+		writer->last.value.v_int32 = job_image->id;
+	}
+
+	bson_destroy (&doc);
+
+	return retval;
+
+}
+
+// ends the json list with the cursor to the next page
+static void jobs_page_writer_end_json (JobsPageWriter *writer) {
+
+	char next[JOB_ID_SIZE + 2] = { 0 };
+	if (!writer->has_next) {
+		(void) snprintf (next, sizeof (next), "null");
+	}
+
+	else if (writer->last.value_type == BSON_TYPE_OID) {
+		char job_id[JOB_ID_SIZE] = { 0 };
+		bson_oid_to_string (&writer->last.value.v_oid, job_id);
+		(void) snprintf (next, sizeof (next), "\"%s\"", job_id);
+	}
+
+	else {
+		(void) snprintf (next, sizeof (next), "%d", writer->last.value.v_int32);
+	}
+
+	char end[64] = { 0 };
+	int end_len = snprintf (end, 64, "], \"next\": %s}", next);
+
+	(void) jobs_page_writer_write (writer, end, (size_t) end_len);
+
+	(void) jeeves_stream_chunked_end (&writer->chunked);
+
+}
+
+// ends the page with the cursor to the next page
+static void jobs_page_writer_end (JobsPageWriter *writer) {
+
+	bson_value_t null_value = { .value_type = BSON_TYPE_NULL };
+	const bson_value_t *next = writer->has_next ? &writer->last : &null_value;
+
+	// pages without items still have their values key
+	if (!writer->started) jobs_page_writer_start (writer, NULL);
+
+	switch (writer->format) {
+		case JEEVES_FORMAT_JSON:
+			jobs_page_writer_end_json (writer);
+			break;
+
+		case JEEVES_FORMAT_BSON:
+			(void) bson_append_array_end (&writer->page, &writer->items);
+			writer->items_ended = true;
+
+			(void) bson_append_value (&writer->page, "next", -1, next);
+
+			(void) jeeves_stream_send_response (
+				writer->http_receive, "200 OK",
+				jeeves_format_content_type (writer->format),
+				bson_get_data (&writer->page), writer->page.len
+			);
+			break;
+
+		case JEEVES_FORMAT_MSGPACK:
+			jeeves_msgpack_write_array_end (
+				&writer->body, writer->items_offset, (uint32_t) writer->count
+			);
+
+			jeeves_msgpack_write_str (&writer->body, "next", 4);
+			jeeves_msgpack_write_value (&writer->body, next, NULL, NULL);
+
+			if (!writer->body.error) {
+				(void) jeeves_stream_send_response (
+					writer->http_receive, "200 OK",
+					jeeves_format_content_type (writer->format),
+					writer->body.data, writer->body.len
+				);
+			}
+
+			else {
+				(void) http_response_send (server_error, writer->http_receive);
+			}
+			break;
+	}
+
+}
+
+// json is used if the client has not asked for another format
+static JeevesFormat jobs_request_format (const HttpRequest *request) {
+
+	const String *accept = http_request_get_header (
+		request, HTTP_HEADER_ACCEPT
+	);
+
+	return jeeves_format_from_accept (accept ? accept->str : NULL);
+
+}
+
+// parses the whole query value as a number between min & max
+// returns 0 on success, 1 on a bad value
+static unsigned int jobs_query_int (
+	const String *value, const long min, const long max, int *result
+) {
+
+	unsigned int retval = 1;
+
+	if (value->len) {
+		char *end = NULL;
+		errno = 0;
+		long number = strtol (value->str, &end, 10);
+		if (
+			!errno && (end == (value->str + value->len))
+			&& (number >= min) && (number <= max)
+		) {
+			*result = (int) number;
+			retval = 0;
+		}
+	}
+
+	return retval;
+
+}
+
+// parses ?limit=&after=&status= into the page
+// returns 0 on success, 1 on bad values
+static unsigned int jobs_page_parse (
+	const HttpRequest *request, JobsPage *page
+) {
+
+	unsigned int retval = 0;
+
+	page->limit = JOBS_PAGE_DEFAULT_LIMIT;
+	page->has_after = false;
+	page->status = JOB_STATUS_NONE;
+
+	const String *limit = request->query_params ?
+		http_request_get_query_value (request->query_params, "limit") : NULL;
+
+	if (limit) {
+		retval |= jobs_query_int (limit, 1, JOBS_PAGE_MAX_LIMIT, &page->limit);
+	}
+
+	const String *after = request->query_params ?
+		http_request_get_query_value (request->query_params, "after") : NULL;
+
+	if (after) {
+		if (bson_oid_is_valid (after->str, after->len)) {
+			bson_oid_init_from_string (&page->after, after->str);
+			page->has_after = true;
+		}
+
+		else {
+			retval = 1;
+		}
+	}
+
+	const String *status = request->query_params ?
+		http_request_get_query_value (request->query_params, "status") : NULL;
+
+	if (status) {
+		int value = 0;
+		if (!jobs_query_int (status, JOB_STATUS_NONE + 1, JOB_STATUS_DONE, &value)) {
+			page->status = (JobStatus) value;
+		}
+
+		else {
+			retval = 1;
+		}
+	}
+
+	return retval;
+
+}
+
+// the page is only cached if nothing has changed since the generation
+static void jeeves_get_jobs_page (
+	const HttpReceive *http_receive, const JeevesFormat format,
+	const User *user, const JobsPage *page,
+	const uint64_t generation
+) {
+
+	JobsPageWriter *writer = (JobsPageWriter *) jeeves_arena_calloc (sizeof (JobsPageWriter));
+	if (writer) {
+		jobs_page_writer_init (
+			writer, http_receive, format,
+			"jobs", page->limit
+		);
+
+		// only the json pages are cached
+		writer->capture = (format == JEEVES_FORMAT_JSON)
+			&& jobs_page_is_cacheable (page);
+
+		unsigned int errors = jeeves_jobs_get_page_by_user (
+			&user->oid, page,
+			jobs_page_writer_each, writer
+		);
+
+		// nothing has been sent yet
+		if (!writer->count) {
+			if (errors) (void) http_response_send (server_error, http_receive);
+			else (void) http_response_send (no_user_jobs, http_receive);
+		}
+
+		else {
+			jobs_page_writer_end (writer);
+
+			if (
+				!errors && !writer->chunked.error
+				&& writer->capture && writer->json
+			) {
+				jobs_model_list_cache_put (
+					&user->oid,
+					writer->json, writer->json_len,
+					generation
+				);
+			}
+		}
+
+		jobs_page_writer_destroy (writer);
+
+		free (writer->json);
+	}
+
+	else {
+		(void) http_response_send (server_error, http_receive);
+	}
+
+}
+
 // GET /api/jeeves/jobs
-// Returns all of the authenticated user's jobs
+// Returns a page of the authenticated user's jobs
+// from the newest to the oldest as they come from the db
 void jeeves_get_jobs_handler (
 	const HttpReceive *http_receive,
 	const HttpRequest *request
 ) {
 
-	User *user = (User *) request->decoded_data;
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, jeeves_get_jobs_handler)) return;
+
+	const User *user = (const User *) request->decoded_data;
 	if (user) {
-		size_t json_len = 0;
-		char *json = NULL;
-
-		if (!jeeves_jobs_get_all_by_user_to_json (
-			&user->oid,
-			&json, &json_len
-		)) {
-			if (json) {
-				(void) http_response_json_custom_reference_send (
-					http_receive,
-					HTTP_STATUS_OK,
-					json, json_len
+		JobsPage page = { 0 };
+		if (!jobs_page_parse (request, &page)) {
+			const JeevesFormat format = jobs_request_format (request);
+			JeevesJson *json = jeeves_json_thread ();
+
+			// the first json page is served from memory
+			uint64_t generation = 0;
+			if (
+				json && (format == JEEVES_FORMAT_JSON)
+				&& jobs_page_is_cacheable (&page)
+				&& !jobs_model_list_cache_get (
+					&user->oid, json, &generation
+				)
+			) {
+				// with the same vary header as the other formats
+				(void) jeeves_stream_send_response (
+					http_receive, "200 OK",
+					jeeves_format_content_type (format),
+					json->data, json->len
 				);
-
-				free (json);
 			}
 
 			else {
-				(void) http_response_send (no_user_jobs, http_receive);
+				jeeves_get_jobs_page (
+					http_receive, format,
+					user, &page, generation
+				);
 			}
 		}
 
 		else {
-			(void) http_response_send (no_user_jobs, http_receive);
+			jeeves_error_send_response (JEEVES_ERROR_BAD_REQUEST, http_receive);
 		}
 	}
 
@@ -70,7 +623,10 @@ void jeeves_create_job_handler (
 	const HttpRequest *request
 ) {
 
-	User *user = (User *) request->decoded_data;
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, jeeves_create_job_handler)) return;
+
+	const User *user = (const User *) request->decoded_data;
 	if (user) {
 		JeevesError error = jeeves_job_create (
 			user, request->body
@@ -107,42 +663,129 @@ void jeeves_jobs_test_handler (
 
 }
 
-// GET /api/jeeves/jobs/:id/info
-void jeeves_job_info_handler (
-	const HttpReceive *http_receive,
-	const HttpRequest *request
+// parses ?limit=&after= into the page
+// returns 0 on success, 1 on bad values
+static unsigned int job_images_page_parse (
+	const HttpRequest *request, JobImagesPage *page
 ) {
 
-	const String *job_id = request->params[0];
+	unsigned int retval = 0;
 
-	User *user = (User *) request->decoded_data;
-	if (user) {
-		if (job_id) {
-			size_t json_len = 0;
-			char *json = NULL;
+	page->limit = JOB_IMAGES_PAGE_DEFAULT_LIMIT;
+	page->after = -1;
+
+	const String *limit = request->query_params ?
+		http_request_get_query_value (request->query_params, "limit") : NULL;
 
-			if (!jeeves_job_get_by_id_and_user_to_json (
+	if (limit) {
+		retval |= jobs_query_int (limit, 1, JOB_IMAGES_PAGE_MAX_LIMIT, &page->limit);
+	}
+
+	const String *after = request->query_params ?
+		http_request_get_query_value (request->query_params, "after") : NULL;
+
+	if (after) {
+		retval |= jobs_query_int (after, 0, INT32_MAX, &page->after);
+	}
+
+	return retval;
+
+}
+
+// writes the job's values followed by a page of its images
+static void jeeves_get_job_info (
+	const HttpReceive *http_receive, const JeevesFormat format,
+	const User *user, const String *job_id,
+	const JobImagesPage *page
+) {
+
+	JobsPageWriter *writer = (JobsPageWriter *) jeeves_arena_calloc (sizeof (JobsPageWriter));
+	if (writer) {
+		jobs_page_writer_init (
+			writer, http_receive, format,
+			"images", page->limit
+		);
+
+		// the job's json values are served from memory
+		if (format == JEEVES_FORMAT_JSON) {
+			JeevesJson *json = jeeves_json_thread ();
+			if (json && !jeeves_job_get_by_id_and_user_to_json (
 				job_id->str, &user->oid,
-				NULL,
-				&json, &json_len
+				job_no_user_query_opts,
+				json
 			)) {
-				if (json) {
-					(void) http_response_json_custom_reference_send (
-						http_receive, HTTP_STATUS_OK, json, json_len
-					);
+				jobs_page_writer_start_json (writer, json->data, json->len);
+			}
+		}
+
+		else {
+			(void) jeeves_job_get_by_id_and_user_each (
+				job_id, &user->oid,
+				job_no_user_query_opts,
+				jobs_page_writer_each_head, writer
+			);
+		}
 
-					free (json);
-				}
+		if (writer->started) {
+			unsigned int errors = jeeves_job_get_images_page_by_id (
+				job_id, &user->oid,
+				page,
+				jobs_page_writer_each_image, writer
+			);
 
-				else {
-					(void) http_response_send (server_error, http_receive);
-				}
+			// nothing has been sent yet
+			if (errors && !writer->count && !writer->chunked.started) {
+				(void) http_response_send (server_error, http_receive);
 			}
 
 			else {
-				(void) http_response_send (no_user_job, http_receive);
+				jobs_page_writer_end (writer);
 			}
 		}
+
+		else {
+			(void) http_response_send (no_user_job, http_receive);
+		}
+
+		jobs_page_writer_destroy (writer);
+	}
+
+	else {
+		(void) http_response_send (server_error, http_receive);
+	}
+
+}
+
+// GET /api/jeeves/jobs/:id/info
+// Returns the job's values with a page of its images
+// ordered by their id, each page costs the same for any job size
+void jeeves_job_info_handler (
+	const HttpReceive *http_receive,
+	const HttpRequest *request
+) {
+
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, jeeves_job_info_handler)) return;
+
+	const String *job_id = request->params[0];
+
+	const User *user = (const User *) request->decoded_data;
+	if (user) {
+		JobImagesPage page = { 0 };
+		if (!job_id || !bson_oid_is_valid (job_id->str, job_id->len)) {
+			(void) http_response_send (no_user_job, http_receive);
+		}
+
+		else if (!job_images_page_parse (request, &page)) {
+			jeeves_get_job_info (
+				http_receive, jobs_request_format (request),
+				user, job_id, &page
+			);
+		}
+
+		else {
+			jeeves_error_send_response (JEEVES_ERROR_BAD_REQUEST, http_receive);
+		}
 	}
 
 	else {
@@ -157,9 +800,12 @@ void jeeves_job_config_handler (
 	const HttpRequest *request
 ) {
 
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, jeeves_job_config_handler)) return;
+
 	const String *job_id = request->params[0];
 
-	User *user = (User *) request->decoded_data;
+	const User *user = (const User *) request->decoded_data;
 	if (user) {
 		JeevesError error = jeeves_job_config (
 			user, job_id,
@@ -190,12 +836,15 @@ void jeeves_job_upload_handler (
 	const HttpRequest *request
 ) {
 
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, jeeves_job_upload_handler)) return;
+
 	const String *job_id = request->params[0];
 
 	// get images that will be added to the job
 	DoubleList *filenames = http_request_multi_parts_get_all_saved_filenames (request);
 
-	User *user = (User *) request->decoded_data;
+	const User *user = (const User *) request->decoded_data;
 	if (user) {
 		if (filenames) {
 			JeevesError error = jeeves_job_upload (
@@ -208,6 +857,12 @@ void jeeves_job_upload_handler (
 					(void) http_response_send (oki_doki, http_receive);
 				} break;
 
+				case JEEVES_ERROR_BAD_IMAGE: {
+					// the files never leave the temp location
+					http_request_multi_part_discard_files (request);
+					jeeves_error_send_response (error, http_receive);
+				} break;
+
 				default:
 					jeeves_error_send_response (error, http_receive);
 					break;
@@ -238,9 +893,12 @@ void jeeves_job_start_handler (
 	const HttpRequest *request
 ) {
 
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, jeeves_job_start_handler)) return;
+
 	const String *job_id = request->params[0];
 
-	User *user = (User *) request->decoded_data;
+	const User *user = (const User *) request->decoded_data;
 	if (user) {
 		JeevesError error = jeeves_job_start (user, job_id);
 
@@ -267,9 +925,12 @@ void jeeves_job_stop_handler (
 	const HttpRequest *request
 ) {
 
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, jeeves_job_stop_handler)) return;
+
 	const String *job_id = request->params[0];
 
-	User *user = (User *) request->decoded_data;
+	const User *user = (const User *) request->decoded_data;
 	if (user) {
 		JeevesError error = jeeves_job_stop (user, job_id);
 
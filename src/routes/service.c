@@ -41,7 +41,7 @@ void jeeves_auth_handler (
 	const HttpRequest *request
 ) {
 
-	User *user = (User *) request->decoded_data;
+	const User *user = (const User *) request->decoded_data;
 
 	if (user) {
 		#ifdef JEEVES_DEBUG
@@ -0,0 +1,255 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <sys/types.h>
+
+#include <cerver/types/types.h>
+#include <cerver/types/string.h>
+
+#include <cerver/http/http.h>
+#include <cerver/http/request.h>
+#include <cerver/http/response.h>
+
+#include <cerver/utils/log.h>
+#include <cerver/utils/utils.h>
+
+#include "jeeves.h"
+#include "stream.h"
+
+#include "models/user.h"
+
+#include "controllers/uploads.h"
+
+#define UPLOADS_HEADERS_SIZE			1024
+
+// checks that the path segment can not escape the user's directory
+static bool jeeves_uploads_param_is_valid (const String *param) {
+
+	return param
+		&& param->len
+		&& (param->str[0] != '.')
+		&& !strchr (param->str, '/');
+
+}
+
+// parses a single "bytes=start-end" range
+// returns 0 on success, 1 if the range can not be satisfied
+static unsigned int jeeves_uploads_parse_range (
+	const char *range, const off_t size,
+	off_t *start, off_t *end
+) {
+
+	unsigned int retval = 1;
+
+	if (!strncmp (range, "bytes=", 6) && size) {
+		const char *value = range + 6;
+		char *ptr = NULL;
+
+		// suffix range - the last N bytes
+		if (value[0] == '-') {
+			long long suffix = strtoll (value + 1, &ptr, 10);
+			if ((ptr != value + 1) && (suffix > 0)) {
+				*start = (suffix < size) ? (size - (off_t) suffix) : 0;
+				*end = size - 1;
+				retval = 0;
+			}
+		}
+
+		else {
+			long long first = strtoll (value, &ptr, 10);
+			if ((ptr != value) && (*ptr == '-') && (first < size)) {
+				*start = (off_t) first;
+				*end = size - 1;
+
+				const char *last_str = ptr + 1;
+				if (*last_str) {
+					long long last = strtoll (last_str, &ptr, 10);
+					if ((ptr != last_str) && (last >= first)) {
+						if (last < size) *end = (off_t) last;
+						retval = 0;
+					}
+				}
+
+				else {
+					retval = 0;
+				}
+			}
+		}
+	}
+
+	return retval;
+
+}
+
+static void jeeves_uploads_send_not_modified (
+	const HttpReceive *http_receive, const UploadFile *file
+) {
+
+	char headers[UPLOADS_HEADERS_SIZE] = { 0 };
+	int headers_len = snprintf (
+		headers, UPLOADS_HEADERS_SIZE,
+		"HTTP/1.1 304 Not Modified\r\n"
+		"ETag: %s\r\n"
+		"\r\n",
+		file->etag
+	);
+
+	(void) jeeves_stream_send (http_receive, headers, (size_t) headers_len);
+
+}
+
+static void jeeves_uploads_send_range_not_satisfiable (
+	const HttpReceive *http_receive, const UploadFile *file
+) {
+
+	char headers[UPLOADS_HEADERS_SIZE] = { 0 };
+	int headers_len = snprintf (
+		headers, UPLOADS_HEADERS_SIZE,
+		"HTTP/1.1 416 Range Not Satisfiable\r\n"
+		"Content-Range: bytes */%ld\r\n"
+		"Content-Length: 0\r\n"
+		"\r\n",
+		(long) file->st.st_size
+	);
+
+	(void) jeeves_stream_send (http_receive, headers, (size_t) headers_len);
+
+}
+
+// sends the file's contents directly from the page cache
+static void jeeves_uploads_send_file (
+	const HttpReceive *http_receive, const UploadFile *file,
+	const bool partial, const off_t start, const off_t end
+) {
+
+	size_t len = (size_t) (end - start + 1);
+
+	char content_range[128] = { 0 };
+	if (partial) {
+		(void) snprintf (
+			content_range, 128,
+			"Content-Range: bytes %ld-%ld/%ld\r\n",
+			(long) start, (long) end, (long) file->st.st_size
+		);
+	}
+
+	char headers[UPLOADS_HEADERS_SIZE] = { 0 };
+	int headers_len = snprintf (
+		headers, UPLOADS_HEADERS_SIZE,
+		"HTTP/1.1 %s\r\n"
+		"Content-Type: %s\r\n"
+		"Content-Length: %lu\r\n"
+		"Accept-Ranges: bytes\r\n"
+		"Cache-Control: private, no-cache\r\n"
+		"ETag: %s\r\n"
+		"%s"
+		"\r\n",
+		partial ? "206 Partial Content" : "200 OK",
+		file->content_type,
+		(unsigned long) len,
+		file->etag,
+		content_range
+	);
+
+	if (!jeeves_stream_send (http_receive, headers, (size_t) headers_len)) {
+		if (len) {
+			(void) jeeves_stream_sendfile (
+				http_receive, file->fd, start, len
+			);
+		}
+	}
+
+}
+
+static void jeeves_uploads_send (
+	const HttpReceive *http_receive, const HttpRequest *request,
+	const UploadFile *file
+) {
+
+	const String *if_none_match = http_request_get_header (
+		request, HTTP_HEADER_IF_NONE_MATCH
+	);
+
+	const String *range = http_request_get_header (
+		request, HTTP_HEADER_RANGE
+	);
+
+	if (if_none_match && strstr (if_none_match->str, file->etag)) {
+		jeeves_uploads_send_not_modified (http_receive, file);
+	}
+
+	// multiple ranges are not supported, so we send the whole file
+	else if (range && !strchr (range->str, ',')) {
+		off_t start = 0;
+		off_t end = 0;
+		if (!jeeves_uploads_parse_range (
+			range->str, file->st.st_size, &start, &end
+		)) {
+			jeeves_uploads_send_file (
+				http_receive, file, true, start, end
+			);
+		}
+
+		else {
+			jeeves_uploads_send_range_not_satisfiable (http_receive, file);
+		}
+	}
+
+	else {
+		jeeves_uploads_send_file (
+			http_receive, file, false, 0, file->st.st_size - 1
+		);
+	}
+
+}
+
+// GET /api/uploads/:user/:dirname/:filename
+// Returns one of the user's original or result images
+void jeeves_uploads_handler (
+	const HttpReceive *http_receive,
+	const HttpRequest *request
+) {
+
+	const String *user_id = request->params[0];
+	const String *dirname = request->params[1];
+	const String *filename = request->params[2];
+
+	const User *user = (const User *) request->decoded_data;
+	if (user) {
+		if (
+			jeeves_uploads_param_is_valid (user_id)
+			&& jeeves_uploads_param_is_valid (dirname)
+			&& jeeves_uploads_param_is_valid (filename)
+			&& !strcmp (user->id, user_id->str)
+		) {
+			char path[JEEVES_UPLOADS_FILE_PATH_SIZE] = { 0 };
+			(void) snprintf (
+				path, JEEVES_UPLOADS_FILE_PATH_SIZE,
+				"%s/%s/%s/%s",
+				JEEVES_UPLOADS_DIR,
+				user_id->str, dirname->str, filename->str
+			);
+
+			const UploadFile *file = jeeves_uploads_file_open (path);
+			if (file) {
+				jeeves_uploads_send (http_receive, request, file);
+
+				jeeves_uploads_file_close (file);
+			}
+
+			else {
+				(void) http_response_send (upload_not_found, http_receive);
+			}
+		}
+
+		else {
+			(void) http_response_send (upload_not_found, http_receive);
+		}
+	}
+
+	else {
+		(void) http_response_send (bad_user_error, http_receive);
+	}
+
+}
@@ -14,6 +14,7 @@
 #include <cerver/utils/utils.h>
 #include <cerver/utils/log.h>
 
+#include "dblimit.h"
 #include "jeeves.h"
 
 #include "controllers/roles.h"
@@ -92,6 +93,9 @@ void users_register_handler (
 	const HttpRequest *request
 ) {
 
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, users_register_handler)) return;
+
 	JeevesUserError error = JEEVES_USER_ERROR_NONE;
 	JeevesUserInput input = JEEVES_USER_INPUT_NONE;
 
@@ -148,6 +152,9 @@ void users_login_handler (
 	const HttpRequest *request
 ) {
 
+	// runs the handler again in its request scope
+	if (jeeves_db_limit_handle (http_receive, request, users_login_handler)) return;
+
 	JeevesUserError error = JEEVES_USER_ERROR_NONE;
 	JeevesUserInput input = JEEVES_USER_INPUT_NONE;
 
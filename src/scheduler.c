@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <time.h>
+
+#include "jeeves.h"
+#include "scheduler.h"
+
+#include "models/job.h"
+
+const char *jeeves_scheduler_to_string (
+	const JobsScheduler scheduler
+) {
+
+	switch (scheduler) {
+		#define XX(num, name, string) case JOBS_SCHEDULER_##name: return #string;
+		JEEVES_SCHEDULER_MAP(XX)
+		#undef XX
+	}
+
+	return jeeves_scheduler_to_string (JOBS_SCHEDULER_NONE);
+
+}
+
+JobsScheduler jeeves_scheduler_from_string (
+	const char *string
+) {
+
+	if (string) {
+		if (!strcasecmp ("FIFO", string)) return JOBS_SCHEDULER_FIFO;
+		if (!strcasecmp ("SJF", string)) return JOBS_SCHEDULER_SJF;
+	}
+
+	return JOBS_SCHEDULER_NONE;
+
+}
+
+// relative cost of processing one megapixel
+static double jeeves_scheduler_job_type_factor (
+	const JobType type
+) {
+
+	double factor = 1.0;
+
+	switch (type) {
+		case JOB_TYPE_GRAYSCALE: factor = 1.0; break;
+		case JOB_TYPE_SHIFT: factor = 1.5; break;
+		case JOB_TYPE_CLAMP: factor = 1.0; break;
+		case JOB_TYPE_RGB_TO_HUE: factor = 2.5; break;
+
+		default: break;
+	}
+
+	return factor;
+
+}
+
+// estimates the job's cost as the sum of its images megapixels
+// multiplied by the cost factor of the job's type
+double jeeves_scheduler_job_cost (
+	const struct JeevesJob *job
+) {
+
+	double cost = 0;
+
+	if (job) {
+		// uses the job's pixels aggregate
+		// so the images don't need to be loaded
+		double megapixels = (job->pixels > 0) ?
+			(double) job->pixels / 1e6 :
+			(double) job->n_images * JEEVES_SCHEDULER_DEFAULT_IMAGE_MP;
+
+		cost = megapixels * jeeves_scheduler_job_type_factor (job->type)
+			+ (double) job->n_images * JEEVES_SCHEDULER_IMAGE_OVERHEAD;
+	}
+
+	return cost;
+
+}
+
+// the job with the lowest score is the next one to run
+// with SJF, every second a job waits its cost is reduced
+// by JOBS_SCHEDULER_AGING to prevent big jobs from starving
+double jeeves_scheduler_job_score (
+	const double cost, const time_t queued, const time_t now
+) {
+
+	double score = (double) queued;
+
+	if (JOBS_SCHEDULER == JOBS_SCHEDULER_SJF) {
+		score = cost - JOBS_SCHEDULER_AGING * difftime (now, queued);
+	}
+
+	return score;
+
+}
@@ -0,0 +1,36 @@
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "storage.h"
+
+#include "storage/mongo.h"
+
+const JeevesStorage *jeeves_storage = &jeeves_storage_mongo;
+
+const char *jeeves_storage_type_to_string (
+	const JeevesStorageType type
+) {
+
+	switch (type) {
+		#define XX(num, name, string) case JEEVES_STORAGE_##name: return #string;
+		JEEVES_STORAGE_MAP(XX)
+		#undef XX
+	}
+
+	return jeeves_storage_type_to_string (JEEVES_STORAGE_NONE);
+
+}
+
+JeevesStorageType jeeves_storage_type_from_string (
+	const char *string
+) {
+
+	if (string) {
+		if (!strcasecmp ("MONGO", string)) return JEEVES_STORAGE_MONGO;
+		if (!strcasecmp ("MEMORY", string)) return JEEVES_STORAGE_MEMORY;
+	}
+
+	return JEEVES_STORAGE_NONE;
+
+}
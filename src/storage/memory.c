@@ -0,0 +1,904 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <time.h>
+
+#include <pthread.h>
+
+#include <bson/bson.h>
+
+#include <cerver/utils/log.h>
+
+#include "storage.h"
+
+#include "models/job.h"
+#include "models/role.h"
+#include "models/user.h"
+
+#include "storage/memory.h"
+
+typedef struct MemoryUser {
+
+	User user;
+
+	// buckets chains
+	struct MemoryUser *next_oid;
+	struct MemoryUser *next_email;
+
+} MemoryUser;
+
+typedef struct MemoryJob {
+
+	// the job's images buffer is owned by the store
+	JeevesJob job;
+
+	struct MemoryJob *next;
+
+} MemoryJob;
+
+// the user's jobs ordered by their oid
+typedef struct MemoryUserJobs {
+
+	bson_oid_t user_oid;
+
+	MemoryJob **jobs;
+	size_t count;
+	size_t capacity;
+
+	struct MemoryUserJobs *next;
+
+} MemoryUserJobs;
+
+// every table is protected by the same lock
+static struct {
+
+	pthread_rwlock_t lock;
+
+	// roles never change after init
+	Role roles[JEEVES_STORAGE_MEMORY_ROLES];
+	size_t n_roles;
+
+	MemoryUser *users_by_oid[JEEVES_STORAGE_MEMORY_BUCKETS];
+	MemoryUser *users_by_email[JEEVES_STORAGE_MEMORY_BUCKETS];
+
+	MemoryJob *jobs[JEEVES_STORAGE_MEMORY_BUCKETS];
+	MemoryUserJobs *users_jobs[JEEVES_STORAGE_MEMORY_BUCKETS];
+
+} memory = { .lock = PTHREAD_RWLOCK_INITIALIZER };
+
+static const char *memory_default_roles[] = { "admin", "common" };
+
+static inline size_t memory_oid_bucket (const bson_oid_t *oid) {
+
+	return (size_t) bson_oid_hash (oid) % JEEVES_STORAGE_MEMORY_BUCKETS;
+
+}
+
+// FNV-1a
+static inline size_t memory_string_bucket (const char *string) {
+
+	uint32_t hash = 2166136261u;
+	for (const unsigned char *c = (const unsigned char *) string; *c; c++) {
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+
+	return (size_t) hash % JEEVES_STORAGE_MEMORY_BUCKETS;
+
+}
+
+unsigned int jeeves_storage_memory_init (void) {
+
+	size_t n_roles = sizeof (memory_default_roles) / sizeof (char *);
+	for (size_t i = 0; i < n_roles; i++) {
+		Role *role = &memory.roles[i];
+		(void) memset (role, 0, sizeof (Role));
+		bson_oid_init (&role->oid, NULL);
+		(void) strncpy (role->name, memory_default_roles[i], ROLE_NAME_SIZE - 1);
+	}
+
+	memory.n_roles = n_roles;
+
+	cerver_log_success ("Using memory storage!");
+
+	return 0;
+
+}
+
+void jeeves_storage_memory_end (void) {
+
+	(void) pthread_rwlock_wrlock (&memory.lock);
+
+	// users are chained by both tables
+	for (size_t i = 0; i < JEEVES_STORAGE_MEMORY_BUCKETS; i++) {
+		MemoryUser *user = memory.users_by_oid[i];
+		while (user) {
+			MemoryUser *next = user->next_oid;
+			free (user);
+			user = next;
+		}
+
+		memory.users_by_oid[i] = NULL;
+		memory.users_by_email[i] = NULL;
+
+		MemoryJob *job = memory.jobs[i];
+		while (job) {
+			MemoryJob *next = job->next;
+			free (job->job.images);
+			free (job);
+			job = next;
+		}
+
+		memory.jobs[i] = NULL;
+
+		MemoryUserJobs *user_jobs = memory.users_jobs[i];
+		while (user_jobs) {
+			MemoryUserJobs *next = user_jobs->next;
+			free (user_jobs->jobs);
+			free (user_jobs);
+			user_jobs = next;
+		}
+
+		memory.users_jobs[i] = NULL;
+	}
+
+	(void) pthread_rwlock_unlock (&memory.lock);
+
+}
+
+#pragma region roles
+
+static unsigned int memory_roles_get_all (
+	bool (*each)(void *data, const Role *role), void *data
+) {
+
+	for (size_t i = 0; i < memory.n_roles; i++) {
+		if (!each (data, &memory.roles[i])) break;
+	}
+
+	return 0;
+
+}
+
+#pragma endregion
+
+#pragma region users
+
+static MemoryUser *memory_user_find_by_email (const char *email) {
+
+	MemoryUser *user = memory.users_by_email[memory_string_bucket (email)];
+	while (user && strcmp (user->user.email, email)) {
+		user = user->next_email;
+	}
+
+	return user;
+
+}
+
+static u8 memory_user_check_by_email (const char *email) {
+
+	u8 retval = 1;
+
+	if (email) {
+		(void) pthread_rwlock_rdlock (&memory.lock);
+
+		if (memory_user_find_by_email (email)) retval = 0;
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+	}
+
+	return retval;
+
+}
+
+static u8 memory_user_get_by_email (
+	User *user, const char *email, const bson_t *query_opts
+) {
+
+	u8 retval = 1;
+
+	if (user && email) {
+		(void) pthread_rwlock_rdlock (&memory.lock);
+
+		MemoryUser *found = memory_user_find_by_email (email);
+		if (found) {
+			(void) memcpy (user, &found->user, sizeof (User));
+			retval = 0;
+		}
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+	}
+
+	return retval;
+
+}
+
+// fails if the email is already taken like the unique index
+static unsigned int memory_user_insert_one (const User *user) {
+
+	unsigned int retval = 1;
+
+	if (user) {
+		(void) pthread_rwlock_wrlock (&memory.lock);
+
+		if (!memory_user_find_by_email (user->email)) {
+			MemoryUser *memory_user = (MemoryUser *) calloc (1, sizeof (MemoryUser));
+			if (memory_user) {
+				(void) memcpy (&memory_user->user, user, sizeof (User));
+
+				size_t oid_bucket = memory_oid_bucket (&user->oid);
+				memory_user->next_oid = memory.users_by_oid[oid_bucket];
+				memory.users_by_oid[oid_bucket] = memory_user;
+
+				size_t email_bucket = memory_string_bucket (user->email);
+				memory_user->next_email = memory.users_by_email[email_bucket];
+				memory.users_by_email[email_bucket] = memory_user;
+
+				retval = 0;
+			}
+		}
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+	}
+
+	return retval;
+
+}
+
+#pragma endregion
+
+#pragma region jobs
+
+static MemoryJob *memory_job_find (
+	const bson_oid_t *oid, const bson_oid_t *user_oid
+) {
+
+	MemoryJob *job = memory.jobs[memory_oid_bucket (oid)];
+	while (job && bson_oid_compare (&job->job.oid, oid)) {
+		job = job->next;
+	}
+
+	if (job && user_oid && bson_oid_compare (&job->job.user_oid, user_oid)) {
+		job = NULL;
+	}
+
+	return job;
+
+}
+
+static MemoryUserJobs *memory_user_jobs_find (const bson_oid_t *user_oid) {
+
+	MemoryUserJobs *user_jobs = memory.users_jobs[memory_oid_bucket (user_oid)];
+	while (user_jobs && bson_oid_compare (&user_jobs->user_oid, user_oid)) {
+		user_jobs = user_jobs->next;
+	}
+
+	return user_jobs;
+
+}
+
+// copies the job's values without touching the output's images buffer
+static void memory_job_copy_values (
+	JeevesJob *job, const JeevesJob *memory_job
+) {
+
+	JobImage *images = job->images;
+	size_t images_count = job->images_count;
+	size_t images_capacity = job->images_capacity;
+
+	(void) memcpy (job, memory_job, sizeof (JeevesJob));
+
+	job->images = images;
+	job->images_count = images_count;
+	job->images_capacity = images_capacity;
+
+}
+
+// the job's document as it would be returned by the db
+static void memory_job_append_bson (
+	bson_t *doc, const JeevesJob *job, const bool full
+) {
+
+	(void) bson_append_oid (doc, "_id", -1, &job->oid);
+
+	if (full) (void) bson_append_oid (doc, "user", -1, &job->user_oid);
+
+	(void) bson_append_utf8 (doc, "name", -1, job->name, -1);
+	(void) bson_append_utf8 (doc, "description", -1, job->description, -1);
+
+	(void) bson_append_int32 (doc, "status", -1, job->status);
+	(void) bson_append_int32 (doc, "type", -1, job->type);
+	(void) bson_append_bool (doc, "autoStart", -1, job->autostart);
+
+	(void) bson_append_int32 (doc, "imagesCount", -1, job->n_images);
+
+	if (full) {
+		(void) bson_append_int64 (doc, "pixels", -1, job->pixels);
+
+		char buf[16] = { 0 };
+		const char *key = NULL;
+		size_t keylen = 0;
+
+		bson_t images_array = BSON_INITIALIZER;
+		bson_t image_doc = BSON_INITIALIZER;
+		(void) bson_append_array_begin (doc, "images", -1, &images_array);
+		for (size_t i = 0; i < job->images_count; i++) {
+			keylen = bson_uint32_to_string ((uint32_t) i, &key, buf, sizeof (buf));
+			(void) bson_append_document_begin (&images_array, key, (int) keylen, &image_doc);
+			job_image_append_bson (&image_doc, &job->images[i]);
+			(void) bson_append_document_end (&images_array, &image_doc);
+		}
+		(void) bson_append_array_end (doc, &images_array);
+	}
+
+	(void) bson_append_date_time (doc, "created", -1, job->created * 1000);
+	(void) bson_append_date_time (doc, "started", -1, job->started * 1000);
+	if (full) (void) bson_append_date_time (doc, "stopped", -1, job->stopped * 1000);
+	(void) bson_append_date_time (doc, "ended", -1, job->ended * 1000);
+
+}
+
+static u8 memory_job_get_by_oid_and_user (
+	JeevesJob *job,
+	const bson_oid_t *oid, const bson_oid_t *user_oid,
+	const bson_t *query_opts
+) {
+
+	u8 retval = 1;
+
+	if (job) {
+		(void) pthread_rwlock_rdlock (&memory.lock);
+
+		MemoryJob *memory_job = memory_job_find (oid, user_oid);
+		if (memory_job) {
+			memory_job_copy_values (job, &memory_job->job);
+			retval = 0;
+		}
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+	}
+
+	return retval;
+
+}
+
+static u8 memory_job_get_images (
+	JeevesJob *job, const bson_t *query_opts
+) {
+
+	u8 retval = 1;
+
+	if (job) {
+		(void) pthread_rwlock_rdlock (&memory.lock);
+
+		MemoryJob *memory_job = memory_job_find (&job->oid, NULL);
+		if (
+			memory_job
+			&& !jeeves_job_images_reserve (
+				job, job->images_count + memory_job->job.images_count
+			)
+		) {
+			for (size_t i = 0; i < memory_job->job.images_count; i++) {
+				(void) jeeves_job_images_add (job, &memory_job->job.images[i]);
+			}
+
+			retval = 0;
+		}
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+	}
+
+	return retval;
+
+}
+
+// the job's document is built before the callback runs
+// returns 0 on success, 1 on error
+static unsigned int memory_job_get_by_oid_and_user_each (
+	const bson_oid_t *oid, const bson_oid_t *user_oid,
+	const bson_t *query_opts,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
+) {
+
+	bool found = false;
+
+	bson_t doc;
+	bson_init (&doc);
+
+	(void) pthread_rwlock_rdlock (&memory.lock);
+
+	// projections only ever select the jobs list values
+	MemoryJob *memory_job = memory_job_find (oid, user_oid);
+	if (memory_job) {
+		memory_job_append_bson (&doc, &memory_job->job, !query_opts);
+		found = true;
+	}
+
+	(void) pthread_rwlock_unlock (&memory.lock);
+
+	if (found) (void) each (data, &doc);
+
+	bson_destroy (&doc);
+
+	return 0;
+
+}
+
+static bool memory_job_to_json_each (void *data, const bson_t *job_doc) {
+
+	(void) jeeves_json_write_bson ((JeevesJson *) data, job_doc, job_json_enum);
+
+	return false;
+
+}
+
+static u8 memory_job_get_by_oid_and_user_to_json (
+	const bson_oid_t *oid, const bson_oid_t *user_oid,
+	const bson_t *query_opts,
+	JeevesJson *json
+) {
+
+	(void) memory_job_get_by_oid_and_user_each (
+		oid, user_oid, query_opts,
+		memory_job_to_json_each, json
+	);
+
+	return (json->len && !json->error) ? 0 : 1;
+
+}
+
+// gets the index of the first job that is not older than the oid
+static size_t memory_user_jobs_lower_bound (
+	const MemoryUserJobs *user_jobs, const bson_oid_t *oid
+) {
+
+	size_t low = 0;
+	size_t high = user_jobs->count;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (bson_oid_compare (&user_jobs->jobs[middle]->job.oid, oid) < 0) {
+			low = middle + 1;
+		}
+
+		else {
+			high = middle;
+		}
+	}
+
+	return low;
+
+}
+
+// the page is copied so the callback is not called holding the lock
+static unsigned int memory_jobs_get_page_by_user (
+	const bson_oid_t *user_oid, const bson_t *opts,
+	const JobsPage *page,
+	bool (*each)(void *data, const bson_t *job_doc), void *data
+) {
+
+	unsigned int retval = 1;
+
+	if (user_oid && page) {
+		bson_t page_docs;
+		bson_init (&page_docs);
+
+		(void) pthread_rwlock_rdlock (&memory.lock);
+
+		MemoryUserJobs *user_jobs = memory_user_jobs_find (user_oid);
+		if (user_jobs) {
+			size_t end = page->has_after ?
+				memory_user_jobs_lower_bound (user_jobs, &page->after) :
+				user_jobs->count;
+
+			char buf[16] = { 0 };
+			const char *key = NULL;
+			size_t keylen = 0;
+			bson_t job_doc = BSON_INITIALIZER;
+
+			// one extra job to know if there is a next page
+			int count = 0;
+			for (size_t i = end; (i > 0) && (count <= page->limit); i--) {
+				const JeevesJob *job = &user_jobs->jobs[i - 1]->job;
+				if ((page->status == JOB_STATUS_NONE) || (job->status == page->status)) {
+					keylen = bson_uint32_to_string ((uint32_t) count, &key, buf, sizeof (buf));
+					(void) bson_append_document_begin (&page_docs, key, (int) keylen, &job_doc);
+					memory_job_append_bson (&job_doc, job, false);
+					(void) bson_append_document_end (&page_docs, &job_doc);
+
+					count += 1;
+				}
+			}
+		}
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+
+		bson_iter_t iter = { 0 };
+		if (bson_iter_init (&iter, &page_docs)) {
+			const uint8_t *doc_data = NULL;
+			uint32_t doc_len = 0;
+			bson_t doc = { 0 };
+			bool more = true;
+			while (more && bson_iter_next (&iter)) {
+				bson_iter_document (&iter, &doc_len, &doc_data);
+				if (bson_init_static (&doc, doc_data, doc_len)) {
+					more = each (data, &doc);
+				}
+			}
+		}
+
+		bson_destroy (&page_docs);
+
+		retval = 0;
+	}
+
+	return retval;
+
+}
+
+static unsigned int memory_job_get_images_page (
+	const bson_oid_t *job_oid, const bson_oid_t *user_oid,
+	const JobImagesPage *page,
+	bool (*each)(void *data, const JobImage *job_image), void *data
+) {
+
+	unsigned int retval = 1;
+
+	if (job_oid && user_oid && page) {
+		JobImage *images = NULL;
+		size_t n_images = 0;
+
+		(void) pthread_rwlock_rdlock (&memory.lock);
+
+		MemoryJob *memory_job = memory_job_find (job_oid, user_oid);
+		if (memory_job) {
+			const JeevesJob *job = &memory_job->job;
+
+			// one extra image to know if there is a next page
+			images = (JobImage *) malloc (
+				((size_t) page->limit + 1) * sizeof (JobImage)
+			);
+
+			if (images) {
+				for (
+					size_t i = 0;
+					(i < job->images_count) && (n_images <= (size_t) page->limit);
+					i++
+				) {
+					if (job->images[i].id > page->after) {
+						(void) memcpy (&images[n_images], &job->images[i], sizeof (JobImage));
+						n_images += 1;
+					}
+				}
+
+				retval = 0;
+			}
+		}
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+
+		for (size_t i = 0; i < n_images; i++) {
+			if (!each (data, &images[i])) break;
+		}
+
+		free (images);
+	}
+
+	return retval;
+
+}
+
+// keeps the user's jobs ordered by their oid
+static unsigned int memory_user_jobs_insert (MemoryJob *memory_job) {
+
+	unsigned int retval = 1;
+
+	const bson_oid_t *user_oid = &memory_job->job.user_oid;
+
+	MemoryUserJobs *user_jobs = memory_user_jobs_find (user_oid);
+	if (!user_jobs) {
+		user_jobs = (MemoryUserJobs *) calloc (1, sizeof (MemoryUserJobs));
+		if (user_jobs) {
+			bson_oid_copy (user_oid, &user_jobs->user_oid);
+
+			size_t bucket = memory_oid_bucket (user_oid);
+			user_jobs->next = memory.users_jobs[bucket];
+			memory.users_jobs[bucket] = user_jobs;
+		}
+	}
+
+	if (user_jobs) {
+		if (user_jobs->count == user_jobs->capacity) {
+			size_t capacity = user_jobs->capacity ? user_jobs->capacity * 2 : 16;
+			MemoryJob **jobs = (MemoryJob **) realloc (
+				user_jobs->jobs, capacity * sizeof (MemoryJob *)
+			);
+
+			if (jobs) {
+				user_jobs->jobs = jobs;
+				user_jobs->capacity = capacity;
+			}
+		}
+
+		if (user_jobs->count < user_jobs->capacity) {
+			// new oids are almost always the greatest ones
+			size_t position = memory_user_jobs_lower_bound (
+				user_jobs, &memory_job->job.oid
+			);
+
+			(void) memmove (
+				&user_jobs->jobs[position + 1], &user_jobs->jobs[position],
+				(user_jobs->count - position) * sizeof (MemoryJob *)
+			);
+
+			user_jobs->jobs[position] = memory_job;
+			user_jobs->count += 1;
+
+			retval = 0;
+		}
+	}
+
+	return retval;
+
+}
+
+static unsigned int memory_job_insert_one (const JeevesJob *job) {
+
+	unsigned int retval = 1;
+
+	MemoryJob *memory_job = (MemoryJob *) calloc (1, sizeof (MemoryJob));
+	if (memory_job) {
+		memory_job_copy_values (&memory_job->job, job);
+
+		(void) pthread_rwlock_wrlock (&memory.lock);
+
+		if (!memory_job_find (&job->oid, NULL) && !memory_user_jobs_insert (memory_job)) {
+			size_t bucket = memory_oid_bucket (&job->oid);
+			memory_job->next = memory.jobs[bucket];
+			memory.jobs[bucket] = memory_job;
+
+			retval = 0;
+		}
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+
+		if (retval) free (memory_job);
+	}
+
+	return retval;
+
+}
+
+static unsigned int memory_job_update_status (
+	const JeevesJob *job, const JobStatus status
+) {
+
+	unsigned int retval = 1;
+
+	(void) pthread_rwlock_wrlock (&memory.lock);
+
+	MemoryJob *memory_job = memory_job_find (&job->oid, NULL);
+	if (memory_job) {
+		memory_job->job.status = status;
+		retval = 0;
+	}
+
+	(void) pthread_rwlock_unlock (&memory.lock);
+
+	return retval;
+
+}
+
+static unsigned int memory_job_update_images (
+	const JeevesJob *job, DoubleList *images
+) {
+
+	unsigned int retval = 1;
+
+	if (images) {
+		(void) pthread_rwlock_wrlock (&memory.lock);
+
+		MemoryJob *memory_job = memory_job_find (&job->oid, NULL);
+		if (
+			memory_job
+			&& !jeeves_job_images_reserve (
+				&memory_job->job, memory_job->job.images_count + images->size
+			)
+		) {
+			const JobImage *job_image = NULL;
+			for (ListElement *le = dlist_start (images); le; le = le->next) {
+				job_image = (const JobImage *) le->data;
+				(void) jeeves_job_images_add (&memory_job->job, job_image);
+
+				memory_job->job.pixels +=
+					(int64_t) job_image->width * (int64_t) job_image->height;
+			}
+
+			memory_job->job.n_images += (int) images->size;
+
+			retval = 0;
+		}
+
+		(void) pthread_rwlock_unlock (&memory.lock);
+	}
+
+	return retval;
+
+}
+
+static unsigned int memory_job_update_image_result (
+	const bson_oid_t *job_oid, const int image_id,
+	const char *result
+) {
+
+	unsigned int retval = 1;
+
+	(void) pthread_rwlock_wrlock (&memory.lock);
+
+	MemoryJob *memory_job = memory_job_find (job_oid, NULL);
+	if (memory_job) {
+		for (size_t i = 0; i < memory_job->job.images_count; i++) {
+			JobImage *job_image = &memory_job->job.images[i];
+			if (job_image->id == image_id) {
+				(void) strncpy (job_image->result, result, JOB_IMAGE_RESULT_SIZE - 1);
+				retval = 0;
+				break;
+			}
+		}
+	}
+
+	(void) pthread_rwlock_unlock (&memory.lock);
+
+	return retval;
+
+}
+
+// applies the transition if the job is in the expected status
+// or in any status except the excluded one
+// and returns the job's updated values
+static unsigned int memory_job_transition (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const JobStatus from_status, const JobStatus not_status,
+	const JobStatus to_status, time_t *(*time_field)(JeevesJob *job)
+) {
+
+	unsigned int retval = 1;
+
+	(void) pthread_rwlock_wrlock (&memory.lock);
+
+	MemoryJob *memory_job = memory_job_find (&job->oid, user_oid);
+	if (
+		memory_job
+		&& (
+			(from_status != JOB_STATUS_NONE) ?
+				(memory_job->job.status == from_status) :
+				(memory_job->job.status != not_status)
+		)
+	) {
+		memory_job->job.status = to_status;
+		if (time_field) *time_field (&memory_job->job) = time (NULL);
+
+		memory_job_copy_values (job, &memory_job->job);
+
+		retval = 0;
+	}
+
+	(void) pthread_rwlock_unlock (&memory.lock);
+
+	return retval;
+
+}
+
+static time_t *memory_job_started (JeevesJob *job) { return &job->started; }
+
+static time_t *memory_job_stopped (JeevesJob *job) { return &job->stopped; }
+
+static time_t *memory_job_ended (JeevesJob *job) { return &job->ended; }
+
+static unsigned int memory_job_transition_start (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bson_t *query_opts
+) {
+
+	return memory_job_transition (
+		job, user_oid,
+		JOB_STATUS_READY, JOB_STATUS_NONE,
+		JOB_STATUS_RUNNING, memory_job_started
+	);
+
+}
+
+static unsigned int memory_job_transition_stop (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bson_t *query_opts
+) {
+
+	return memory_job_transition (
+		job, user_oid,
+		JOB_STATUS_RUNNING, JOB_STATUS_NONE,
+		JOB_STATUS_STOPPED, memory_job_stopped
+	);
+
+}
+
+static unsigned int memory_job_transition_end (
+	JeevesJob *job, const bson_t *query_opts
+) {
+
+	return memory_job_transition (
+		job, NULL,
+		JOB_STATUS_RUNNING, JOB_STATUS_NONE,
+		JOB_STATUS_DONE, memory_job_ended
+	);
+
+}
+
+static unsigned int memory_job_transition_ready (
+	JeevesJob *job, const bson_t *query_opts
+) {
+
+	return memory_job_transition (
+		job, NULL,
+		JOB_STATUS_NONE, JOB_STATUS_RUNNING,
+		JOB_STATUS_READY, NULL
+	);
+
+}
+
+static unsigned int memory_job_transition_config (
+	JeevesJob *job, const bson_oid_t *user_oid,
+	const bool set_autostart,
+	const bson_t *query_opts
+) {
+
+	unsigned int retval = 1;
+
+	(void) pthread_rwlock_wrlock (&memory.lock);
+
+	MemoryJob *memory_job = memory_job_find (&job->oid, user_oid);
+	if (memory_job && (memory_job->job.status != JOB_STATUS_RUNNING)) {
+		memory_job->job.type = job->type;
+		if (set_autostart) memory_job->job.autostart = job->autostart;
+
+		memory_job_copy_values (job, &memory_job->job);
+
+		retval = 0;
+	}
+
+	(void) pthread_rwlock_unlock (&memory.lock);
+
+	return retval;
+
+}
+
+#pragma endregion
+
+const JeevesStorage jeeves_storage_memory = {
+
+	.type = JEEVES_STORAGE_MEMORY,
+
+	.roles_get_all = memory_roles_get_all,
+
+	.user_check_by_email = memory_user_check_by_email,
+	.user_get_by_email = memory_user_get_by_email,
+	.user_insert_one = memory_user_insert_one,
+
+	.job_get_by_oid_and_user = memory_job_get_by_oid_and_user,
+	.job_get_images = memory_job_get_images,
+	.job_get_by_oid_and_user_each = memory_job_get_by_oid_and_user_each,
+	.job_get_by_oid_and_user_to_json = memory_job_get_by_oid_and_user_to_json,
+	.jobs_get_page_by_user = memory_jobs_get_page_by_user,
+	.job_get_images_page = memory_job_get_images_page,
+
+	.job_insert_one = memory_job_insert_one,
+	.job_update_status = memory_job_update_status,
+	.job_update_images = memory_job_update_images,
+	.job_update_image_result = memory_job_update_image_result,
+
+	.job_transition_start = memory_job_transition_start,
+	.job_transition_stop = memory_job_transition_stop,
+	.job_transition_end = memory_job_transition_end,
+	.job_transition_ready = memory_job_transition_ready,
+	.job_transition_config = memory_job_transition_config
+
+};
@@ -0,0 +1,37 @@
+#include "storage.h"
+
+#include "models/job.h"
+#include "models/role.h"
+#include "models/user.h"
+
+#include "storage/mongo.h"
+
+const JeevesStorage jeeves_storage_mongo = {
+
+	.type = JEEVES_STORAGE_MONGO,
+
+	.roles_get_all = role_get_all,
+
+	.user_check_by_email = user_check_by_email,
+	.user_get_by_email = user_get_by_email,
+	.user_insert_one = user_insert_one,
+
+	.job_get_by_oid_and_user = jeeves_job_get_by_oid_and_user,
+	.job_get_images = jeeves_job_get_images,
+	.job_get_by_oid_and_user_each = jeeves_job_get_by_oid_and_user_each,
+	.job_get_by_oid_and_user_to_json = jeeves_job_get_by_oid_and_user_to_json,
+	.jobs_get_page_by_user = jobs_get_page_by_user,
+	.job_get_images_page = jeeves_job_get_images_page,
+
+	.job_insert_one = jeeves_job_insert_one,
+	.job_update_status = jeeves_job_update_status,
+	.job_update_images = jeeves_job_update_images,
+	.job_update_image_result = jeeves_job_update_image_result,
+
+	.job_transition_start = jeeves_job_transition_start,
+	.job_transition_stop = jeeves_job_transition_stop,
+	.job_transition_end = jeeves_job_transition_end,
+	.job_transition_ready = jeeves_job_transition_ready,
+	.job_transition_config = jeeves_job_transition_config
+
+};
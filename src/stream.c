@@ -0,0 +1,253 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/sendfile.h>
+
+#include <cerver/handler.h>
+
+#include <cerver/http/http.h>
+
+#include "stream.h"
+
+// max time to wait for a slow client to read from its socket
+#define JEEVES_STREAM_TIMEOUT			30000
+
+static inline int jeeves_stream_get_sock_fd (
+	const HttpReceive *http_receive
+) {
+
+	return http_receive->cr->connection->socket->sock_fd;
+
+}
+
+// waits until the socket can be written again
+// returns 0 on success, 1 on timeout or error
+static unsigned int jeeves_stream_wait (const int sock_fd) {
+
+	struct pollfd pfd = { .fd = sock_fd, .events = POLLOUT, .revents = 0 };
+
+	return (poll (&pfd, 1, JEEVES_STREAM_TIMEOUT) > 0) ? 0 : 1;
+
+}
+
+// writes the data directly into the connection's socket
+unsigned int jeeves_stream_send (
+	const HttpReceive *http_receive,
+	const void *data, const size_t data_len
+) {
+
+	unsigned int retval = 0;
+
+	int sock_fd = jeeves_stream_get_sock_fd (http_receive);
+
+	const char *end = (const char *) data;
+	size_t left = data_len;
+	ssize_t sent = 0;
+	while (left) {
+		sent = send (sock_fd, end, left, MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EINTR) continue;
+
+			if ((errno == EAGAIN) && !jeeves_stream_wait (sock_fd)) continue;
+
+			retval = 1;
+			break;
+		}
+
+		end += sent;
+		left -= (size_t) sent;
+	}
+
+	return retval;
+
+}
+
+// writes a range of the file into the connection's socket
+// without copying its contents through userspace
+unsigned int jeeves_stream_sendfile (
+	const HttpReceive *http_receive,
+	const int fd, const off_t offset, const size_t len
+) {
+
+	unsigned int retval = 0;
+
+	int sock_fd = jeeves_stream_get_sock_fd (http_receive);
+
+	off_t actual_offset = offset;
+	size_t left = len;
+	ssize_t sent = 0;
+	while (left) {
+		sent = sendfile (sock_fd, fd, &actual_offset, left);
+		if (sent <= 0) {
+			if ((sent < 0) && (errno == EINTR)) continue;
+
+			if (
+				(sent < 0) && (errno == EAGAIN)
+				&& !jeeves_stream_wait (sock_fd)
+			) continue;
+
+			retval = 1;
+			break;
+		}
+
+		left -= (size_t) sent;
+	}
+
+	return retval;
+
+}
+
+// sends the response with its content length
+// & Vary: Accept as its body's format was negotiated
+unsigned int jeeves_stream_send_response (
+	const HttpReceive *http_receive,
+	const char *status, const char *content_type,
+	const void *data, const size_t data_len
+) {
+
+	char headers[256] = { 0 };
+	int headers_len = snprintf (
+		headers, 256,
+		"HTTP/1.1 %s\r\n"
+		"Content-Type: %s\r\n"
+		"Content-Length: %zu\r\n"
+		"Vary: Accept\r\n"
+		"\r\n",
+		status, content_type, data_len
+	);
+
+	unsigned int retval = jeeves_stream_send (
+		http_receive, headers, (size_t) headers_len
+	);
+
+	if (!retval) {
+		retval = jeeves_stream_send (http_receive, data, data_len);
+	}
+
+	return retval;
+
+}
+
+void jeeves_stream_chunked_init (
+	JeevesStreamChunked *chunked,
+	const HttpReceive *http_receive,
+	const char *status, const char *content_type
+) {
+
+	chunked->http_receive = http_receive;
+
+	chunked->status = status;
+	chunked->content_type = content_type;
+	chunked->started = false;
+
+	chunked->error = 0;
+
+	chunked->len = 0;
+
+}
+
+static unsigned int jeeves_stream_chunked_headers (
+	JeevesStreamChunked *chunked
+) {
+
+	char headers[256] = { 0 };
+	int headers_len = snprintf (
+		headers, 256,
+		"HTTP/1.1 %s\r\n"
+		"Content-Type: %s\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"Vary: Accept\r\n"
+		"\r\n",
+		chunked->status, chunked->content_type
+	);
+
+	chunked->started = true;
+
+	return jeeves_stream_send (
+		chunked->http_receive, headers, (size_t) headers_len
+	);
+
+}
+
+// sends the buffered data as a single chunk
+static unsigned int jeeves_stream_chunked_flush (
+	JeevesStreamChunked *chunked
+) {
+
+	if (!chunked->error && !chunked->started) {
+		chunked->error = jeeves_stream_chunked_headers (chunked);
+	}
+
+	if (!chunked->error && chunked->len) {
+		char size[32] = { 0 };
+		int size_len = snprintf (size, 32, "%zx\r\n", chunked->len);
+
+		chunked->error |= jeeves_stream_send (
+			chunked->http_receive, size, (size_t) size_len
+		);
+
+		if (!chunked->error) {
+			(void) memcpy (chunked->buffer + chunked->len, "\r\n", 2);
+			chunked->error |= jeeves_stream_send (
+				chunked->http_receive, chunked->buffer, chunked->len + 2
+			);
+		}
+	}
+
+	chunked->len = 0;
+
+	return chunked->error;
+
+}
+
+// returns 0 on success, 1 if the client is gone
+unsigned int jeeves_stream_chunked_write (
+	JeevesStreamChunked *chunked,
+	const void *data, const size_t data_len
+) {
+
+	// keep room for the chunk's trailing CRLF
+	const size_t capacity = JEEVES_STREAM_CHUNK_SIZE - 2;
+
+	const char *ptr = (const char *) data;
+	size_t left = data_len;
+	size_t n = 0;
+	while (left && !chunked->error) {
+		n = capacity - chunked->len;
+		if (n > left) n = left;
+
+		(void) memcpy (chunked->buffer + chunked->len, ptr, n);
+		chunked->len += n;
+		ptr += n;
+		left -= n;
+
+		if (chunked->len == capacity) {
+			(void) jeeves_stream_chunked_flush (chunked);
+		}
+	}
+
+	return chunked->error;
+
+}
+
+// sends any buffered data & the last chunk
+unsigned int jeeves_stream_chunked_end (
+	JeevesStreamChunked *chunked
+) {
+
+	if (!jeeves_stream_chunked_flush (chunked)) {
+		chunked->error = jeeves_stream_send (
+			chunked->http_receive, "0\r\n\r\n", 5
+		);
+	}
+
+	return chunked->error;
+
+}
@@ -1,7 +1,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <time.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 #include <bson/bson.h>
 
@@ -21,15 +24,26 @@
 
 #include <osiris/image.h>
 
+#include "blobs.h"
+#include "db.h"
+#include "files.h"
 #include "jeeves.h"
+#include "scheduler.h"
+#include "storage.h"
 #include "worker.h"
 
 #include "controllers/jobs.h"
 
 #include "models/job.h"
 
+// queued & running jobs
 static DoubleList *active_jobs = NULL;
 
+static pthread_mutex_t jobs_worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobs_worker_cond = PTHREAD_COND_INITIALIZER;
+static bool jobs_worker_stop = false;
+static unsigned int jobs_worker_busy = 0;
+
 static JobQueue *jeeves_uploads_worker_job_queue = NULL;
 
 static void *jeeves_uploads_worker_thread (void *null_ptr);
@@ -38,17 +52,31 @@ static void *jeeves_uploads_worker_thread (void *null_ptr);
 
 typedef struct WorkerJob {
 
-	pthread_t thread_id;
 	JeevesJob *job;
 
+	// estimated when the job was queued
+	double cost;
+	time_t queued;
+
+	bool running;
+
+	// set when the job has been stopped while running
+	atomic_bool stop;
+
 } WorkerJob;
 
 static WorkerJob *worker_job_new (void) {
 
 	WorkerJob *job = (WorkerJob *) malloc (sizeof (WorkerJob));
 	if (job) {
-		job->thread_id = 0;
 		job->job = NULL;
+
+		job->cost = 0;
+		job->queued = 0;
+
+		job->running = false;
+
+		atomic_init (&job->stop, false);
 	}
 
 	return job;
@@ -67,12 +95,37 @@ static void worker_job_delete (void *worker_job_ptr) {
 
 }
 
+static void *jeeves_jobs_worker_thread (void *null_ptr);
+
 static unsigned int jeeves_jobs_worker_init (void) {
 
 	unsigned int retval = 1;
 
 	active_jobs = dlist_init (worker_job_delete, NULL);
-	if (active_jobs) retval = 0;
+	if (active_jobs) {
+		pthread_t thread_id = 0;
+		unsigned int created = 0;
+		for (unsigned int i = 0; i < JOBS_WORKER_THREADS; i++) {
+			if (!thread_create_detachable (
+				&thread_id, jeeves_jobs_worker_thread, NULL
+			)) {
+				created += 1;
+			}
+		}
+
+		if (created) {
+			cerver_log_success (
+				"Created %u jobs worker threads - %s scheduler",
+				created, jeeves_scheduler_to_string (JOBS_SCHEDULER)
+			);
+
+			retval = 0;
+		}
+
+		else {
+			cerver_log_error ("Failed to create jobs worker threads!");
+		}
+	}
 
 	return retval;
 
@@ -80,18 +133,45 @@ static unsigned int jeeves_jobs_worker_init (void) {
 
 static unsigned int jeeves_jobs_worker_end (void) {
 
-	// TODO: stop any active job
+	(void) pthread_mutex_lock (&jobs_worker_mutex);
+
+	jobs_worker_stop = true;
+	(void) pthread_cond_broadcast (&jobs_worker_cond);
 
-	dlist_delete (active_jobs);
+	// queued jobs are still READY in the db so they are just released
+	// running jobs still reference the list until they are done
+	ListElement *le = dlist_start (active_jobs);
+	while (le) {
+		ListElement *next = le->next;
+
+		WorkerJob *worker_job = (WorkerJob *) le->data;
+		if (worker_job->running) {
+			atomic_store (&worker_job->stop, true);
+		}
+
+		else {
+			worker_job_delete (dlist_remove_element (active_jobs, le));
+		}
+
+		le = next;
+	}
+
+	// the last busy worker deletes the list
+	if (!jobs_worker_busy) {
+		dlist_delete (active_jobs);
+		active_jobs = NULL;
+	}
+
+	(void) pthread_mutex_unlock (&jobs_worker_mutex);
 
 	return 0;
 
 }
 
-// returns TRUE if the job is currently being running
-bool jeeves_jobs_worker_check (const bson_oid_t *job_oid) {
+// must be called with the jobs worker mutex locked
+static WorkerJob *jeeves_jobs_worker_find (const bson_oid_t *job_oid) {
 
-	bool retval = false;
+	WorkerJob *worker_job = NULL;
 
 	ListElement *le = NULL;
 	dlist_for_each (active_jobs, le) {
@@ -99,15 +179,123 @@ bool jeeves_jobs_worker_check (const bson_oid_t *job_oid) {
 			&((WorkerJob *) le->data)->job->oid,
 			job_oid
 		)) {
-			retval = true;
+			worker_job = (WorkerJob *) le->data;
 			break;
 		}
 	}
 
+	return worker_job;
+
+}
+
+// returns TRUE if the job is currently queued or running
+bool jeeves_jobs_worker_check (const bson_oid_t *job_oid) {
+
+	(void) pthread_mutex_lock (&jobs_worker_mutex);
+
+	bool retval = (jeeves_jobs_worker_find (job_oid) != NULL);
+
+	(void) pthread_mutex_unlock (&jobs_worker_mutex);
+
 	return retval;
 
 }
 
+// removes the user's job if it has not been picked by a worker
+// returns 0 if the job was removed, 1 if not
+unsigned int jeeves_jobs_worker_dequeue (
+	const bson_oid_t *job_oid, const bson_oid_t *user_oid
+) {
+
+	unsigned int retval = 1;
+
+	WorkerJob *removed = NULL;
+
+	(void) pthread_mutex_lock (&jobs_worker_mutex);
+
+	WorkerJob *worker_job = NULL;
+	ListElement *le = NULL;
+	dlist_for_each (active_jobs, le) {
+		worker_job = (WorkerJob *) le->data;
+		if (!bson_oid_compare (&worker_job->job->oid, job_oid)) {
+			if (
+				!worker_job->running
+				&& !bson_oid_compare (&worker_job->job->user_oid, user_oid)
+			) {
+				removed = (WorkerJob *) dlist_remove_element (active_jobs, le);
+				retval = 0;
+			}
+
+			break;
+		}
+	}
+
+	(void) pthread_mutex_unlock (&jobs_worker_mutex);
+
+	worker_job_delete (removed);
+
+	return retval;
+
+}
+
+// signals the worker to stop processing the job
+// returns 0 if the job is running, 1 if not
+unsigned int jeeves_jobs_worker_stop (const bson_oid_t *job_oid) {
+
+	unsigned int retval = 1;
+
+	(void) pthread_mutex_lock (&jobs_worker_mutex);
+
+	WorkerJob *worker_job = NULL;
+	ListElement *le = NULL;
+	dlist_for_each (active_jobs, le) {
+		worker_job = (WorkerJob *) le->data;
+		if (!bson_oid_compare (&worker_job->job->oid, job_oid)) {
+			if (worker_job->running) {
+				atomic_store (&worker_job->stop, true);
+				retval = 0;
+			}
+
+			break;
+		}
+	}
+
+	(void) pthread_mutex_unlock (&jobs_worker_mutex);
+
+	return retval;
+
+}
+
+// gets the queued job with the lowest score
+// must be called with the jobs worker mutex locked
+static WorkerJob *jeeves_jobs_worker_next (void) {
+
+	WorkerJob *next = NULL;
+
+	const time_t now = time (NULL);
+	double score = 0;
+	double best_score = 0;
+
+	WorkerJob *worker_job = NULL;
+	ListElement *le = NULL;
+	dlist_for_each (active_jobs, le) {
+		worker_job = (WorkerJob *) le->data;
+		if (!worker_job->running) {
+			score = jeeves_scheduler_job_score (
+				worker_job->cost, worker_job->queued, now
+			);
+
+			if (!next || (score < best_score)) {
+				next = worker_job;
+				best_score = score;
+			}
+		}
+	}
+
+	return next;
+
+}
+
 static char *jeeves_jobs_worker_thread_get_file_extension (
 	const char *filename, size_t *ext_len
 ) {
@@ -122,6 +310,43 @@ static char *jeeves_jobs_worker_thread_get_file_extension (
 
 }
 
+// loads the job's image from persistent storage or from its
+// temporary location if the upload has not been moved yet
+static Image *jeeves_jobs_worker_image_load (
+	const JobImage *job_image, const char *filename
+) {
+
+	Image *image = image_load_color (filename, 0, 0);
+	if (!image && job_image->saved[0]) {
+		image = image_load_color (job_image->saved, 0, 0);
+
+		// the upload might have been moved in between
+		if (!image) image = image_load_color (filename, 0, 0);
+	}
+
+	return image;
+
+}
+
+// creates the result's directory if the uploads worker
+// has not moved the original images into it yet
+static void jeeves_jobs_worker_thread_create_result_dir (
+	const char *result
+) {
+
+	char dirname[JOB_IMAGE_RESULT_SIZE] = { 0 };
+	(void) strncpy (dirname, result, JOB_IMAGE_RESULT_SIZE - 1);
+
+	// create every level after the uploads dir
+	char *ptr = dirname + strlen (JEEVES_UPLOADS_DIR) + 1;
+	while ((ptr = strchr (ptr, '/'))) {
+		*ptr = '\0';
+		(void) files_create_dir (dirname, 0777);
+		*ptr++ = '/';
+	}
+
+}
+
 static void jeeves_jobs_worker_thread_gray (
 	JeevesJob *job,
 	JobImage *job_image,
@@ -130,7 +355,7 @@ static void jeeves_jobs_worker_thread_gray (
 
 	cerver_log_debug ("%s...", job_type_to_string (job->type));
 
-	Image *input = image_load_color (filename, 0, 0);
+	Image *input = jeeves_jobs_worker_image_load (job_image, filename);
 	if (input) {
 		Image *gray = image_grayscale (input);
 		if (gray) {
@@ -154,7 +379,7 @@ static void jeeves_jobs_worker_thread_shift (
 
 	cerver_log_debug ("%s...", job_type_to_string (job->type));
 
-	Image *input = image_load_color (filename, 0, 0);
+	Image *input = jeeves_jobs_worker_image_load (job_image, filename);
 	if (input) {
 		image_shift (input, 0, .4);
 		image_shift (input, 1, .4);
@@ -177,7 +402,7 @@ static void jeeves_jobs_worker_thread_clamp (
 
 	cerver_log_debug ("%s...", job_type_to_string (job->type));
 
-	Image *input = image_load_color (filename, 0, 0);
+	Image *input = jeeves_jobs_worker_image_load (job_image, filename);
 	if (input) {
 		image_clamp (input);
 
@@ -198,7 +423,7 @@ static void jeeves_jobs_worker_thread_rgb_to_hue (
 
 	cerver_log_debug ("%s...", job_type_to_string (job->type));
 
-	Image *input = image_load_color (filename, 0, 0);
+	Image *input = jeeves_jobs_worker_image_load (job_image, filename);
 	if (input) {
 		image_rgb_to_hsv (input);
 
@@ -211,148 +436,318 @@ static void jeeves_jobs_worker_thread_rgb_to_hue (
 
 }
 
-void *jeeves_jobs_worker_thread (void *worker_job_ptr) {
+// searches for an image with the same contents
+// that has already been processed in this job
+static const JobImage *jeeves_jobs_worker_thread_get_duplicate (
+	const JeevesJob *job, const size_t current
+) {
 
-	if (worker_job_ptr) {
-		WorkerJob *worker_job = (WorkerJob *) worker_job_ptr;
+	const JobImage *duplicate = NULL;
 
-		cerver_log_success (
-			"Job %s worker thread has started!",
-			worker_job->job->id
+	const JobImage *job_image = &job->images[current];
+	if (job_image->hash[0]) {
+		for (size_t i = 0; i < current; i++) {
+			if (!strcmp (job->images[i].hash, job_image->hash)) {
+				duplicate = &job->images[i];
+				break;
+			}
+		}
+	}
+
+	return duplicate;
+
+}
+
+// generates the image's location in persistent storage
+static char *jeeves_jobs_worker_thread_get_filename (
+	const JobImage *job_image, char *filename
+) {
+
+	char *end = strstr (job_image->original, JEEVES_UPLOADS_PATH);
+	if (end) {
+		// printf ("end: %s\n", end);
+
+		(void) snprintf (
+			filename, 1024,
+			"%s%s",
+			JEEVES_UPLOADS_DIR,
+			end + strlen (JEEVES_UPLOADS_PATH)
 		);
+	}
+
+	return end;
 
-		// process images
-		char filename[1024] = { 0 };
-		char *end = NULL;
-		// char *ext = NULL;
-		size_t name_len = 0;
-		size_t ext_len = 0;
+}
+
+// starts reading the image's input in the background
+// so it is already in memory when the worker gets to it
+static void jeeves_jobs_worker_thread_prefetch (
+	const JobImage *job_image
+) {
 
-		// Image *input = NULL;
+	char filename[1024] = { 0 };
+	(void) jeeves_jobs_worker_thread_get_filename (job_image, filename);
 
-		ListElement *le = NULL;
-		JobImage *job_image = NULL;
-		dlist_for_each (worker_job->job->images, le) {
-			job_image = (JobImage *) le->data;
+	if (jeeves_files_prefetch (filename) && job_image->saved[0]) {
+		(void) jeeves_files_prefetch (job_image->saved);
+	}
 
-			(void) memset (filename, 0, 1024);
-			ext_len = 0;
+}
 
-			cerver_log_debug ("Next to process: %s", job_image->original);
+// processes the image with the job's configuration
+// and saves the output in the image's result location
+static void jeeves_jobs_worker_thread_process (
+	JeevesJob *job, JobImage *job_image
+) {
 
-			// generate actual image path
-			end = strstr (job_image->original, JEEVES_UPLOADS_PATH);
-			if (end) {
-				// printf ("end: %s\n", end);
+	char filename[1024] = { 0 };
+	char *end = NULL;
+	size_t name_len = 0;
+	size_t ext_len = 0;
 
-				(void) snprintf (
-					filename, 1024,
-					"%s%s",
-					JEEVES_UPLOADS_DIR,
-					end + strlen (JEEVES_UPLOADS_PATH)
-				);
-			}
+	// generate actual image path
+	end = jeeves_jobs_worker_thread_get_filename (job_image, filename);
 
-			// printf ("filename: %s\n", filename);
+	// printf ("filename: %s\n", filename);
 
-			// generate output image filename
-			(void) jeeves_jobs_worker_thread_get_file_extension (
-				job_image->original, &ext_len
+	// generate output image filename
+	(void) jeeves_jobs_worker_thread_get_file_extension (
+		job_image->original, &ext_len
+	);
+
+	name_len = strlen (end) - strlen (JEEVES_UPLOADS_PATH) - ext_len;
+
+	(void) snprintf (
+		job_image->result, JOB_IMAGE_RESULT_SIZE,
+		"%s%.*s-out.jpg",
+		JEEVES_UPLOADS_DIR,
+		(int) name_len, end + strlen (JEEVES_UPLOADS_PATH)
+	);
+
+	// printf ("out: %s\n", job_image->result);
+
+	jeeves_jobs_worker_thread_create_result_dir (job_image->result);
+
+	switch (job->type) {
+		case JOB_TYPE_GRAYSCALE: {
+			jeeves_jobs_worker_thread_gray (
+				job,
+				job_image,
+				filename
 			);
+		} break;
 
-			name_len = strlen (end) - strlen (JEEVES_UPLOADS_PATH) - ext_len;
+		case JOB_TYPE_SHIFT: {
+			jeeves_jobs_worker_thread_shift (
+				job,
+				job_image,
+				filename
+			);
+		} break;
 
-			(void) snprintf (
-				job_image->result, JOB_IMAGE_RESULT_SIZE,
-				"%s%.*s-out.jpg",
-				JEEVES_UPLOADS_DIR,
-				(int) name_len, end + strlen (JEEVES_UPLOADS_PATH)
+		case JOB_TYPE_CLAMP: {
+			jeeves_jobs_worker_thread_clamp (
+				job,
+				job_image,
+				filename
 			);
+		} break;
 
-			// printf ("out: %s\n", job_image->result);
-
-			switch (worker_job->job->type) {
-				case JOB_TYPE_GRAYSCALE: {
-					jeeves_jobs_worker_thread_gray (
-						worker_job->job,
-						job_image,
-						filename
-					);
-				} break;
-
-				case JOB_TYPE_SHIFT: {
-					jeeves_jobs_worker_thread_shift (
-						worker_job->job,
-						job_image,
-						filename
-					);
-				} break;
-
-				case JOB_TYPE_CLAMP: {
-					jeeves_jobs_worker_thread_clamp (
-						worker_job->job,
-						job_image,
-						filename
-					);
-				} break;
-
-				case JOB_TYPE_RGB_TO_HUE: {
-					jeeves_jobs_worker_thread_rgb_to_hue (
-						worker_job->job,
-						job_image,
-						filename
-					);
-				} break;
-
-				default: break;
-			}
+		case JOB_TYPE_RGB_TO_HUE: {
+			jeeves_jobs_worker_thread_rgb_to_hue (
+				job,
+				job_image,
+				filename
+			);
+		} break;
 
-			(void) sleep (4);
+		default: break;
+	}
 
-			// generate new save image
-			(void) memset (filename, 0, 1024);
-			end = strstr (job_image->result, JEEVES_UPLOADS_DIR);
-			if (end) {
-				// printf ("end: %s\n", end);
+	(void) sleep (4);
 
-				(void) snprintf (
-					filename, 1024,
-					"%s%s",
-					JEEVES_UPLOADS_PATH,
-					end + strlen (JEEVES_UPLOADS_DIR)
-				);
-			}
+}
 
-			// update image in the db!
-			jeeves_job_update_image_result (
-				&worker_job->job->oid, job_image->id,
-				filename
+// processes every image of the job & updates its results
+static void jeeves_jobs_worker_process (WorkerJob *worker_job) {
+
+	JeevesJob *job = worker_job->job;
+
+	// the job stays READY while it is queued
+	// it might have been configured again in between
+	if (jeeves_storage->job_transition_start (job, NULL, job_state_query_opts)) {
+		cerver_log_warning (
+			"Job %s is no longer READY - skipping it!", job->id
+		);
+
+		return;
+	}
+
+	cerver_log_success (
+		"Job %s worker has started - cost %.2f - waited %.0fs",
+		job->id, worker_job->cost,
+		difftime (time (NULL), worker_job->queued)
+	);
+
+	// the job was fetched without its images
+	if (jeeves_storage->job_get_images (job, job_images_query_opts)) {
+		cerver_log_error (
+			"Failed to get job %s images!", job->id
+		);
+
+		(void) jeeves_storage->job_update_status (
+			job, JOB_STATUS_INCOMPLETED
+		);
+
+		return;
+	}
+
+	// process images
+	char filename[1024] = { 0 };
+	char *end = NULL;
+
+	// keep reads in flight ahead of the current image
+	size_t prefetch = 0;
+	while (
+		(prefetch < job->images_count)
+		&& (prefetch < JEEVES_JOBS_WORKER_PREFETCH)
+	) {
+		jeeves_jobs_worker_thread_prefetch (&job->images[prefetch]);
+		prefetch++;
+	}
+
+	JobImage *job_image = NULL;
+	const JobImage *duplicate = NULL;
+	for (size_t idx = 0; idx < job->images_count; idx++) {
+		if (atomic_load (&worker_job->stop)) break;
+
+		job_image = &job->images[idx];
+
+		if (prefetch < job->images_count) {
+			jeeves_jobs_worker_thread_prefetch (&job->images[prefetch]);
+			prefetch++;
+		}
+
+		cerver_log_debug ("Next to process: %s", job_image->original);
+
+		// reuse the result of an image with the same contents
+		duplicate = jeeves_jobs_worker_thread_get_duplicate (
+			job, idx
+		);
+
+		if (duplicate) {
+			cerver_log_debug (
+				"%s is a duplicate of %s",
+				job_image->original, duplicate->original
+			);
+
+			(void) strncpy (
+				job_image->result, duplicate->result,
+				JOB_IMAGE_RESULT_SIZE - 1
 			);
+		}
 
-			cerver_log_success ("Done with: %s", job_image->original);
+		else {
+			jeeves_jobs_worker_thread_process (
+				worker_job->job, job_image
+			);
 		}
 
-		// we are done! - update job's status in the db
-		(void) jeeves_job_update_end (
-			&worker_job->job->oid
+		// generate new save image
+		(void) memset (filename, 0, 1024);
+		end = strstr (job_image->result, JEEVES_UPLOADS_DIR);
+		if (end) {
+			// printf ("end: %s\n", end);
+
+			(void) snprintf (
+				filename, 1024,
+				"%s%s",
+				JEEVES_UPLOADS_PATH,
+				end + strlen (JEEVES_UPLOADS_DIR)
+			);
+		}
+
+		// update image in the db!
+		jeeves_storage->job_update_image_result (
+			&worker_job->job->oid, job_image->id,
+			filename
 		);
 
-		// free allocated resources
-		(void) dlist_remove (active_jobs, worker_job, NULL);
-		worker_job_delete (worker_job);
+		cerver_log_success ("Done with: %s", job_image->original);
+	}
 
+	// we are done! - update job's status in the db
+	// only if the job has not been stopped in between
+	if (!jeeves_storage->job_transition_end (job, job_status_query_opts)) {
 		cerver_log_success (
-			"Job %s worker thread has ended!",
+			"Job %s worker has ended!",
+			worker_job->job->id
+		);
+	}
+
+	else {
+		cerver_log_warning (
+			"Job %s worker has been stopped!",
 			worker_job->job->id
 		);
 	}
 
+}
+
+// waits for queued jobs & processes them one at a time
+// the next job is selected by the configured scheduler
+static void *jeeves_jobs_worker_thread (void *null_ptr) {
+
+	(void) thread_set_name ("jeeves-jobs-worker");
+
+	jeeves_db_thread_pin ();
+
+	WorkerJob *worker_job = NULL;
+	for (;;) {
+		(void) pthread_mutex_lock (&jobs_worker_mutex);
+
+		while (!jobs_worker_stop && !(worker_job = jeeves_jobs_worker_next ())) {
+			(void) pthread_cond_wait (&jobs_worker_cond, &jobs_worker_mutex);
+		}
+
+		if (jobs_worker_stop) {
+			(void) pthread_mutex_unlock (&jobs_worker_mutex);
+			break;
+		}
+
+		worker_job->running = true;
+		jobs_worker_busy += 1;
+
+		(void) pthread_mutex_unlock (&jobs_worker_mutex);
+
+		jeeves_jobs_worker_process (worker_job);
+
+		// free allocated resources
+		(void) pthread_mutex_lock (&jobs_worker_mutex);
+
+		jobs_worker_busy -= 1;
+		if (active_jobs) {
+			(void) dlist_remove (active_jobs, worker_job, NULL);
+
+			if (jobs_worker_stop && !jobs_worker_busy) {
+				dlist_delete (active_jobs);
+				active_jobs = NULL;
+			}
+		}
+
+		(void) pthread_mutex_unlock (&jobs_worker_mutex);
+
+		worker_job_delete (worker_job);
+	}
+
+	jeeves_db_thread_unpin ();
+
 	return NULL;
 
 }
 
 // a user has requested to start a new job
-// so create a dedicated job & process job's images
+// so queue the job to be processed by the jobs worker
 // with selected configuration
 u8 jeeves_jobs_worker_create (JeevesJob *job) {
 
@@ -362,20 +757,38 @@ u8 jeeves_jobs_worker_create (JeevesJob *job) {
 		WorkerJob *worker_job = worker_job_new ();
 		if (worker_job) {
 			worker_job->job = job;
+			worker_job->cost = jeeves_scheduler_job_cost (job);
+			worker_job->queued = time (NULL);
+
+			(void) pthread_mutex_lock (&jobs_worker_mutex);
+
+			// concurrent requests can't queue the same job twice
+			if (!jobs_worker_stop && !jeeves_jobs_worker_find (&job->oid)) {
+				#ifdef JEEVES_DEBUG
+				cerver_log_debug (
+					"Job %s has been queued - cost %.2f",
+					job->id, worker_job->cost
+				);
+				#endif
 
-			if (!thread_create_detachable (
-				&worker_job->thread_id,
-				jeeves_jobs_worker_thread,
-				worker_job
-			)) {
 				(void) dlist_insert_after (
 					active_jobs,
 					dlist_end (active_jobs),
 					worker_job
 				);
 
+				(void) pthread_cond_signal (&jobs_worker_cond);
+
 				retval = 0;
 			}
+
+			(void) pthread_mutex_unlock (&jobs_worker_mutex);
+
+			if (retval) {
+				// the caller keeps ownership of the job
+				worker_job->job = NULL;
+				worker_job_delete (worker_job);
+			}
 		}
 	}
 
@@ -391,8 +804,12 @@ JeevesUpload *jeeves_upload_new (const char *dirname, const char *user_id) {
 
 	JeevesUpload *upload = (JeevesUpload *) malloc (sizeof (JeevesUpload));
 	if (upload) {
-		(void) strncpy (upload->dirname, dirname, JEEVES_UPLOAD_USER_ID_SIZE - 1);
+		(void) memset (upload, 0, sizeof (JeevesUpload));
+
+		(void) strncpy (upload->dirname, dirname, JEEVES_UPLOAD_DIRNAME_SIZE - 1);
 		(void) strncpy (upload->user_id, user_id, JEEVES_UPLOAD_USER_ID_SIZE - 1);
+
+		upload->images = dlist_init (job_image_delete, NULL);
 	}
 
 	return upload;
@@ -401,7 +818,39 @@ JeevesUpload *jeeves_upload_new (const char *dirname, const char *user_id) {
 
 void jeeves_upload_delete (void *jeeves_upload_ptr) {
 
-	if (jeeves_upload_ptr) free (jeeves_upload_ptr);
+	if (jeeves_upload_ptr) {
+		JeevesUpload *upload = (JeevesUpload *) jeeves_upload_ptr;
+
+		dlist_delete (upload->images);
+
+		free (jeeves_upload_ptr);
+	}
+
+}
+
+// adds a saved image that will be stored in the blob store
+// after it has been moved into persistent storage
+unsigned int jeeves_upload_add_image (
+	JeevesUpload *upload, const JobImage *job_image
+) {
+
+	unsigned int retval = 1;
+
+	if (upload && job_image && job_image->hash[0]) {
+		JobImage *image = job_image_create (
+			job_image->id, job_image->saved, NULL, NULL
+		);
+
+		if (image) {
+			(void) strncpy (image->hash, job_image->hash, JOB_IMAGE_HASH_SIZE - 1);
+
+			retval = (unsigned int) dlist_insert_at_end_unsafe (
+				upload->images, image
+			);
+		}
+	}
+
+	return retval;
 
 }
 
@@ -409,6 +858,12 @@ static unsigned int jeeves_uploads_worker_init (void) {
 
 	unsigned int retval = 1;
 
+	if (ENABLE_DIRECT_UPLOADS) {
+		(void) files_create_dir (JEEVES_UPLOADS_INCOMING_DIR, 0777);
+	}
+
+	(void) jeeves_blobs_init ();
+
 	jeeves_uploads_worker_job_queue = job_queue_create (JOB_QUEUE_TYPE_JOBS);
 	if (jeeves_uploads_worker_job_queue) {
 		pthread_t thread_id = 0;
@@ -444,8 +899,35 @@ unsigned int jeeves_uploads_worker_push (JeevesUpload *upload) {
 
 }
 
+// adds the moved images to the blob store
+// so repeated images share the same disk blocks
+static void jeeves_uploads_worker_store_blobs (
+	const JeevesUpload *upload, const char *new_location
+) {
+
+	char filename[512] = { 0 };
+	const char *basename = NULL;
+	const JobImage *job_image = NULL;
+	for (ListElement *le = dlist_start (upload->images); le; le = le->next) {
+		job_image = (const JobImage *) le->data;
+
+		basename = strrchr (job_image->saved, '/');
+		if (basename) {
+			(void) snprintf (
+				filename, 512,
+				"%s%s", new_location, basename
+			);
+
+			(void) jeeves_blob_store (filename, job_image->hash);
+		}
+	}
+
+}
+
 // moves saved uploads from requests
 // from temporarly directory into persistant storage
+// with direct uploads, files are already in persistant storage
+// and only need to be renamed into the user's directory
 static void *jeeves_uploads_worker_thread (void *null_ptr) {
 
 	(void) sleep (4);	// wait until cerver has started
@@ -460,7 +942,6 @@ static void *jeeves_uploads_worker_thread (void *null_ptr) {
 	char new_dirname[512] = { 0 };
 	char old_location[512] = { 0 };
 	char new_location[512] = { 0 };
-	char command[2048] = { 0 };
 	while (running) {
 		bsem_wait (jeeves_uploads_worker_job_queue->has_jobs);
 
@@ -482,10 +963,12 @@ static void *jeeves_uploads_worker_thread (void *null_ptr) {
 			(void) files_create_dir (new_dirname, 0777);
 
 			// move directory from temp storage to local storage
+			// direct uploads already live in the same device
+			// so this only renames the files into their final place
 			(void) snprintf (
 				old_location, 512,
 				"%s/%s",
-				JEEVES_UPLOADS_TEMP_DIR,
+				UPLOADS_TEMP_DIR,
 				upload->dirname
 			);
 			(void) printf ("OLD: %s\n", old_location);
@@ -497,14 +980,9 @@ static void *jeeves_uploads_worker_thread (void *null_ptr) {
 			);
 			(void) printf ("NEW: %s\n", new_location);
 
-			(void) snprintf (
-				command, 2048,
-				"mv %s %s",
-				old_location, new_location
-			);
-			(void) printf ("COMMAND: %s\n", command);
-
-			(void) system (command);
+			if (!jeeves_files_move_dir (old_location, new_location)) {
+				jeeves_uploads_worker_store_blobs (upload, new_location);
+			}
 
 			jeeves_upload_delete (upload);
 